@@ -0,0 +1,263 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_ACTIVEVOICETABLE_H
+#define SURGE_SRC_COMMON_ACTIVEVOICETABLE_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace Surge
+{
+namespace VoiceManagement
+{
+/*
+ * The per-scene list of playing voices. Voices stay in the order they were started, which
+ * voice stealing and the mono modes rely on, but live in a fixed contiguous array so walking
+ * the list is a linear read and nothing here ever allocates. Erasing from the middle shifts
+ * the tail down, which for MAX_VOICES pointers is a few cache lines.
+ *
+ * The API is the subset of std::list the synth used, so iteration code reads the same.
+ */
+template <typename T, size_t capacity> struct VoiceList
+{
+    typedef T **iterator;
+    typedef T *const *const_iterator;
+
+    iterator begin() { return items; }
+    iterator end() { return items + n; }
+    const_iterator begin() const { return items; }
+    const_iterator end() const { return items + n; }
+
+    size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+
+    T *front() const
+    {
+        assert(n > 0);
+        return items[0];
+    }
+    T *back() const
+    {
+        assert(n > 0);
+        return items[n - 1];
+    }
+
+    void push_back(T *v)
+    {
+        assert(n < capacity);
+        items[n++] = v;
+    }
+
+    iterator erase(iterator it)
+    {
+        assert(it >= begin() && it < end());
+        std::move(it + 1, end(), it);
+        n--;
+        return it;
+    }
+
+    void clear() { n = 0; }
+
+  private:
+    T *items[capacity]{};
+    size_t n{0};
+};
+
+/*
+ * Owns the bookkeeping behind the voice arrays: which slots in each scene are free, and how
+ * many live voices carry each host note id.
+ *
+ * Slot allocation is a free-slot stack, and note ids are counted in an open-addressed table
+ * (linear probing, backward-shift deletion) sized well above the voice count, so allocate,
+ * release and "is anyone else still playing this note id" are all constant time and the
+ * whole thing is a fixed block of memory.
+ */
+template <int nScenes, int maxVoices> struct ActiveVoiceTable
+{
+    ActiveVoiceTable() { reset(); }
+
+    void reset()
+    {
+        for (int s = 0; s < nScenes; ++s)
+        {
+            nFree[s] = maxVoices;
+            for (int i = 0; i < maxVoices; ++i)
+            {
+                // hand out low slots first, like the old linear scan did
+                freeSlots[s][i] = maxVoices - 1 - i;
+                inUse[s][i] = false;
+                slotNoteId[s][i] = -1;
+            }
+        }
+        for (auto &e : idTable)
+        {
+            e = Entry();
+        }
+    }
+
+    // returns a free slot in this scene and marks it used, or -1 if the scene is full
+    int allocate(int scene)
+    {
+        if (nFree[scene] == 0)
+            return -1;
+        auto slot = freeSlots[scene][--nFree[scene]];
+        inUse[scene][slot] = true;
+        slotNoteId[scene][slot] = -1;
+        return slot;
+    }
+
+    bool isInUse(int scene, int slot) const { return inUse[scene][slot]; }
+
+    // a voice in this slot has started and carries this host note id (or -1 for none)
+    void activate(int scene, int slot, int32_t noteId)
+    {
+        assert(inUse[scene][slot]);
+        slotNoteId[scene][slot] = noteId;
+        if (noteId >= 0)
+            adjust(noteId, scene, 1);
+    }
+
+    void reassignNoteId(int scene, int slot, int32_t noteId)
+    {
+        auto &prior = slotNoteId[scene][slot];
+        if (prior >= 0)
+            adjust(prior, scene, -1);
+        prior = noteId;
+        if (noteId >= 0)
+            adjust(noteId, scene, 1);
+    }
+
+    /*
+     * Frees the slot. Returns true if it was carrying a host note id which no other live
+     * voice in any scene still carries, i.e. that host note has now ended.
+     */
+    bool release(int scene, int slot)
+    {
+        assert(inUse[scene][slot]);
+        inUse[scene][slot] = false;
+        freeSlots[scene][nFree[scene]++] = slot;
+
+        auto id = slotNoteId[scene][slot];
+        slotNoteId[scene][slot] = -1;
+
+        if (id < 0)
+            return false;
+
+        adjust(id, scene, -1);
+        return count(id) == 0;
+    }
+
+    int count(int32_t noteId) const
+    {
+        auto e = find(noteId);
+        if (!e)
+            return 0;
+        int res = 0;
+        for (int s = 0; s < nScenes; ++s)
+            res += e->count[s];
+        return res;
+    }
+
+    int countOutsideScene(int32_t noteId, int scene) const
+    {
+        auto e = find(noteId);
+        if (!e)
+            return 0;
+        int res = 0;
+        for (int s = 0; s < nScenes; ++s)
+            if (s != scene)
+                res += e->count[s];
+        return res;
+    }
+
+  private:
+    static constexpr int tableSize = 512;
+    static_assert((tableSize & (tableSize - 1)) == 0, "Note id table must be a power of two");
+    static_assert(tableSize >= 4 * nScenes * maxVoices, "Note id table too small for voices");
+
+    struct Entry
+    {
+        int32_t id{-1};
+        int16_t count[nScenes]{};
+        bool used() const { return id >= 0; }
+    };
+
+    static int home(int32_t id) { return (int)(((uint32_t)id * 2654435761U) >> 23) & (tableSize - 1); }
+
+    const Entry *find(int32_t id) const
+    {
+        for (int i = home(id);; i = (i + 1) & (tableSize - 1))
+        {
+            if (!idTable[i].used())
+                return nullptr;
+            if (idTable[i].id == id)
+                return &idTable[i];
+        }
+    }
+
+    void adjust(int32_t id, int scene, int by)
+    {
+        int i = home(id);
+        while (idTable[i].used() && idTable[i].id != id)
+            i = (i + 1) & (tableSize - 1);
+
+        auto &e = idTable[i];
+        if (!e.used())
+        {
+            assert(by > 0);
+            e.id = id;
+        }
+        e.count[scene] += by;
+        assert(e.count[scene] >= 0);
+
+        for (int s = 0; s < nScenes; ++s)
+            if (e.count[s])
+                return;
+
+        // nobody holds this id any more, so remove it and close the probe chain behind it
+        int hole = i;
+        for (int j = (hole + 1) & (tableSize - 1); idTable[j].used(); j = (j + 1) & (tableSize - 1))
+        {
+            int h = home(idTable[j].id);
+            bool canMove = (hole <= j) ? (h <= hole || h > j) : (h <= hole && h > j);
+            if (canMove)
+            {
+                idTable[hole] = idTable[j];
+                hole = j;
+            }
+        }
+        idTable[hole] = Entry();
+    }
+
+    int freeSlots[nScenes][maxVoices];
+    int nFree[nScenes];
+    bool inUse[nScenes][maxVoices];
+    int32_t slotNoteId[nScenes][maxVoices];
+    Entry idTable[tableSize];
+};
+} // namespace VoiceManagement
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_ACTIVEVOICETABLE_H
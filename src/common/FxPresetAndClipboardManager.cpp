@@ -42,6 +42,7 @@ void FxUserPreset::doPresetRescan(SurgeStorage *storage, bool forceRescan)
 
     // auto tb = Surge::Debug::TimeBlock(__func__);
     scannedPresets.clear();
+    scannedFolders = ScannedFolders();
     haveScannedPresets = true;
 
     auto ud = storage->userFXPath;
@@ -59,6 +60,7 @@ void FxUserPreset::doPresetRescan(SurgeStorage *storage, bool forceRescan)
         {
             auto top = workStack.front();
             workStack.pop_front();
+            scannedFolders.add(top.first);
             if (fs::is_directory(top.first))
             {
                 for (auto &d : fs::directory_iterator(top.first))
@@ -175,6 +177,10 @@ void FxUserPreset::doPresetRescan(SurgeStorage *storage, bool forceRescan)
         if (storage)
             storage->reportError(oss.str(), "FileSystem Error");
     }
+
+    // so instances created from now on can skip the scan
+    if (storage)
+        storage->publishFxPresets();
 }
 
 bool FxUserPreset::readFromXMLSnapshot(Preset &preset, TiXmlElement *s)
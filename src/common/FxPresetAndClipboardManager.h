@@ -64,6 +64,7 @@ struct FxUserPreset
     };
 
     std::unordered_map<int, std::vector<Preset>> scannedPresets;
+    ScannedFolders scannedFolders;
     bool haveScannedPresets{false};
 
     void doPresetRescan(SurgeStorage *storage, bool forceRescan = false);
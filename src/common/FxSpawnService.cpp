@@ -0,0 +1,293 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "FxSpawnService.h"
+#include "Effect.h"
+
+#include <cassert>
+#include <utility>
+#include <vector>
+
+namespace Surge
+{
+namespace Threading
+{
+FxSpawnService::FxSpawnService(SurgeStorage *s) : storage(s)
+{
+    worker = std::thread(&FxSpawnService::workerLoop, this);
+}
+
+FxSpawnService::~FxSpawnService()
+{
+    {
+        std::lock_guard<std::mutex> g(m);
+        keepRunning = false;
+    }
+    cv.notify_one();
+
+    if (worker.joinable())
+        worker.join();
+}
+
+bool FxSpawnService::hasRetired() const
+{
+    return retireHead.load(std::memory_order_acquire) !=
+           retireTail.load(std::memory_order_acquire);
+}
+
+bool FxSpawnService::hasWork() const
+{
+    if (routingPublishRequested || hasRetired())
+        return true;
+
+    for (auto &slot : slots)
+        if (slot.requested || (slot.ready && slot.readyGeneration != slot.requestGeneration))
+            return true;
+
+    return false;
+}
+
+void FxSpawnService::waitUntilIdle()
+{
+    std::unique_lock<std::mutex> lk(m);
+
+    // a retire() whose wake couldn't get through would otherwise leave the worker asleep
+    if (hasWork())
+        cv.notify_one();
+
+    idleCv.wait(lk, [this]() { return !workerBusy && !hasWork(); });
+}
+
+bool FxSpawnService::request(int s, int type) { return poll(s, type, nullptr); }
+
+bool FxSpawnService::acquire(int s, int type, std::unique_ptr<Effect> &fx)
+{
+    return poll(s, type, &fx);
+}
+
+bool FxSpawnService::poll(int s, int type, std::unique_ptr<Effect> *take)
+{
+    auto &slot = slots[s];
+
+    if (type == fxt_off && slot.postedType < 0)
+    {
+        if (take)
+            take->reset();
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lk(m, std::try_to_lock);
+
+    if (!lk.owns_lock())
+        return false;
+
+    // a retire() may not have been able to wake the worker, so make sure now
+    bool notify = hasRetired();
+    bool res = false;
+
+    if (type == fxt_off)
+    {
+        // nothing to build, just make sure an older request doesn't land later
+        slot.requested = false;
+        slot.requestGeneration++;
+        slot.postedType = -1;
+        notify = true;
+
+        if (take)
+            take->reset();
+        res = true;
+    }
+    else if (slot.postedType != type)
+    {
+        slot.requested = true;
+        slot.requestType = type;
+        slot.requestGeneration++;
+        slot.postedType = type;
+        notify = true;
+    }
+    else if (slot.ready && slot.readyGeneration == slot.requestGeneration)
+    {
+        if (take)
+        {
+            *take = std::move(slot.ready);
+            slot.postedType = -1;
+        }
+        res = true;
+    }
+
+    lk.unlock();
+
+    if (notify)
+        cv.notify_one();
+
+    return res;
+}
+
+bool FxSpawnService::canRetire() const
+{
+    auto used = retireHead.load(std::memory_order_relaxed) -
+                retireTail.load(std::memory_order_acquire);
+
+    return used < retireQueueSize;
+}
+
+void FxSpawnService::retire(std::unique_ptr<Effect> &&fx)
+{
+    if (!fx)
+        return;
+
+    // only the audio thread pushes, so the space canRetire() saw is still there
+    assert(canRetire());
+
+    auto head = retireHead.load(std::memory_order_relaxed);
+    retireQueue[head % retireQueueSize] = std::move(fx);
+    retireHead.store(head + 1, std::memory_order_release);
+
+    retireWakePending = true;
+    wakeForRetired();
+}
+
+void FxSpawnService::wakeForRetired()
+{
+    if (!retireWakePending)
+        return;
+
+    /*
+     * If the worker holds the lock it may be about to sleep having missed the push, so only
+     * a notify under the lock counts. Otherwise try again next block.
+     */
+    std::unique_lock<std::mutex> lk(m, std::try_to_lock);
+
+    if (!lk.owns_lock())
+        return;
+
+    retireWakePending = false;
+
+    lk.unlock();
+    cv.notify_one();
+}
+
+void FxSpawnService::cancelAll()
+{
+    std::lock_guard<std::mutex> g(m);
+
+    for (auto &slot : slots)
+    {
+        slot.requested = false;
+        slot.requestGeneration++;
+        slot.postedType = -1;
+    }
+
+    cv.notify_one();
+}
+
+bool FxSpawnService::requestRoutingPublish()
+{
+    std::unique_lock<std::mutex> lk(m, std::try_to_lock);
+
+    if (!lk.owns_lock())
+        return false;
+
+    routingPublishRequested = true;
+
+    lk.unlock();
+    cv.notify_one();
+
+    return true;
+}
+
+void FxSpawnService::workerLoop()
+{
+    std::unique_lock<std::mutex> lk(m);
+
+    while (true)
+    {
+        workerBusy = false;
+        idleCv.notify_all();
+
+        cv.wait(lk, [this]() { return !keepRunning || hasWork(); });
+
+        if (!keepRunning)
+            break;
+
+        workerBusy = true;
+
+        std::vector<std::unique_ptr<Effect>> garbage;
+        int slotIndex{-1}, type{fxt_off};
+        uint32_t generation{0};
+        bool publishRoutings = std::exchange(routingPublishRequested, false);
+
+        auto head = retireHead.load(std::memory_order_acquire);
+
+        for (auto t = retireTail.load(std::memory_order_relaxed); t != head; ++t)
+            garbage.push_back(std::move(retireQueue[t % retireQueueSize]));
+
+        retireTail.store(head, std::memory_order_release);
+
+        for (int s = 0; s < n_fx_slots; ++s)
+        {
+            auto &slot = slots[s];
+
+            if (slot.ready && slot.readyGeneration != slot.requestGeneration)
+                garbage.push_back(std::move(slot.ready));
+
+            if (slot.requested && slotIndex < 0)
+            {
+                slotIndex = s;
+                type = slot.requestType;
+                generation = slot.requestGeneration;
+                slot.requested = false;
+            }
+        }
+
+        lk.unlock();
+
+        garbage.clear();
+
+        if (publishRoutings)
+            storage->publishModulationRoutings();
+
+        if (slotIndex >= 0)
+        {
+            auto &patch = storage->getPatch();
+            auto fx = std::unique_ptr<Effect>(
+                spawn_effect(type, storage, &patch.fx[slotIndex], patch.globaldata));
+
+            lk.lock();
+
+            if (generation == slots[slotIndex].requestGeneration)
+            {
+                std::swap(fx, slots[slotIndex].ready);
+                slots[slotIndex].readyGeneration = generation;
+            }
+
+            lk.unlock();
+
+            // fx is now either a build nobody wants anymore or an unclaimed older one
+            fx.reset();
+        }
+
+        lk.lock();
+    }
+}
+} // namespace Threading
+} // namespace Surge
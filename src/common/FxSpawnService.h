@@ -0,0 +1,138 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_FXSPAWNSERVICE_H
+#define SURGE_SRC_COMMON_FXSPAWNSERVICE_H
+
+#include "SurgeStorage.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+class Effect;
+
+namespace Surge
+{
+namespace Threading
+{
+/*
+ * Constructs effects on a worker thread, so that the allocations in effect constructors
+ * (delay lines, grain buffers, oversamplers and so on) never happen on the audio thread,
+ * and destroys the instances they replace there too.
+ *
+ * Each FX slot has one mailbox. The audio thread asks for a type with acquire(), which posts
+ * the request the first time and hands back the instance once the worker has built it. A
+ * newer request supersedes an older one and stale builds are thrown away on the worker.
+ * Instances are built against the slot's FxStorage, but acquire() doesn't init them: the
+ * caller still sets up parameters and calls init() exactly as for a synchronous spawn.
+ *
+ * Replaced instances go back through a small single producer, single consumer queue which
+ * the audio thread pushes onto without locking. Check canRetire() before taking a new
+ * instance, since retire() has nowhere else to put one.
+ *
+ * The worker also publishes modulation routings which the audio thread changed (an effect
+ * swap clears the modulation onto the old effect's parameters), so the copy and compile of
+ * the routing snapshot happen here too.
+ *
+ * The audio thread only ever try_locks. If the lock is busy it tries again next block.
+ */
+struct FxSpawnService
+{
+    explicit FxSpawnService(SurgeStorage *storage);
+    ~FxSpawnService();
+
+    /*
+     * Audio thread. request() posts a request for type if there isn't one in flight and
+     * returns whether its instance is ready; acquire() does the same but also moves the ready
+     * instance into fx. fxt_off is always ready, as a null instance.
+     */
+    bool request(int slot, int type);
+    bool acquire(int slot, int type, std::unique_ptr<Effect> &fx);
+
+    // audio thread; hand an instance to the worker to be destroyed, if canRetire()
+    bool canRetire() const;
+    void retire(std::unique_ptr<Effect> &&fx);
+
+    // audio thread, once a block; wake the worker for a retire() which couldn't
+    void wakeForRetired();
+
+    // forget about in-flight builds, e.g. since a patch loaded over them
+    void cancelAll();
+
+    /*
+     * Audio thread. Have the worker call publishModulationRoutings on the storage. Returns
+     * false if that couldn't be posted without waiting, in which case try again next block.
+     */
+    bool requestRoutingPublish();
+
+    /*
+     * Not the audio thread. Wait until the worker has dealt with everything posted so far,
+     * so a test or an offline render can step through a swap block by block without timing.
+     */
+    void waitUntilIdle();
+
+  private:
+    struct Slot
+    {
+        // guarded by m
+        bool requested{false};
+        int requestType{fxt_off};
+        uint32_t requestGeneration{0};
+        std::unique_ptr<Effect> ready;
+        uint32_t readyGeneration{0};
+
+        // audio thread only
+        int postedType{-1};
+    };
+
+    bool poll(int slot, int type, std::unique_ptr<Effect> *take);
+    bool hasRetired() const;
+    bool hasWork() const; // call with m held
+
+    void workerLoop();
+
+    SurgeStorage *storage;
+
+    Slot slots[n_fx_slots];
+
+    // the audio thread writes retireHead and the worker writes retireTail
+    static constexpr uint32_t retireQueueSize = 2 * n_fx_slots;
+    static_assert((retireQueueSize & (retireQueueSize - 1)) == 0,
+                  "retire queue indices wrap, so its size must be a power of two");
+    std::unique_ptr<Effect> retireQueue[retireQueueSize];
+    std::atomic<uint32_t> retireHead{0}, retireTail{0};
+    bool retireWakePending{false}; // audio thread only
+
+    bool routingPublishRequested{false}; // guarded by m
+    std::mutex m;
+    std::condition_variable cv, idleCv;
+    bool keepRunning{true}, workerBusy{true}; // guarded by m
+    std::thread worker;
+};
+} // namespace Threading
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_FXSPAWNSERVICE_H
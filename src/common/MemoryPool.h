@@ -23,10 +23,35 @@
 #ifndef SURGE_SRC_COMMON_MEMORYPOOL_H
 #define SURGE_SRC_COMMON_MEMORYPOOL_H
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
 namespace Surge
 {
 namespace Memory
 {
+/*
+ * A stack of preallocated T, for the audio thread to take from and return to.
+ *
+ * By default an empty pool grows by growBy items right there in getItem. A pool which has
+ * enableBackgroundRefill called on it instead asks for more once it drops below lowWater,
+ * and whoever services it (see SurgeMemoryPools) builds items up to highWater off the audio
+ * thread with refill(). Those come back through a single producer, single consumer ring,
+ * so neither side ever waits for the other. getItem can still find the pool empty, if a
+ * burst of notes outruns the refill; that is counted in misses, and either allocates as
+ * before or, with setNeverAllocate, returns nullptr for the caller to play silence.
+ *
+ * Such a pool is sized with reserve() and release() rather than setupPoolToSize() and
+ * returnToPreAllocSize(). Those only post the work, and refill() does the building, and the
+ * deleting through a second ring running the other way.
+ *
+ * Everything but refill() and the telemetry belongs to the thread which owns the pool.
+ */
 // pre-alloc must be at least one
 template <typename T, size_t preAlloc, size_t growBy, size_t capacity = 16384> struct MemoryPool
 {
@@ -37,29 +62,49 @@ template <typename T, size_t preAlloc, size_t growBy, size_t capacity = 16384> s
     }
     ~MemoryPool()
     {
+        collectRefills();
         for (size_t i = 0; i < position; ++i)
             delete pool[i];
+
+        // whatever the refilling thread didn't get round to
+        for (auto t = retireTail.load(); t != retireHead.load(); ++t)
+            delete retired[t % capacity];
     }
     template <typename... Args> T *getItem(Args &&...args)
     {
+        collectRefills();
+
         if (position == 0)
         {
+            misses.fetch_add(1, std::memory_order_relaxed);
+
+            if (neverAllocate.load(std::memory_order_relaxed))
+            {
+                requestRefill();
+                return nullptr;
+            }
+
             refreshPool(std::forward<Args>(args)...);
         }
         auto q = pool[position - 1];
         pool[position - 1] = nullptr; // just to flag bugs
         position--;
+        outstanding++;
+
+        if (position < lowWater)
+            requestRefill();
+
         return q;
     }
     void returnItem(T *t)
     {
         pool[position] = t;
         position++;
+        outstanding--;
     }
     template <typename... Args> void refreshPool(Args &&...args)
     {
-        // In an ideal world, this grow would be off thread.
-        // For XT 1 leave it here and have a reasonable prealloc
+        // Pools with a background refill only get here on a miss
         assert(position < (growBy + capacity));
         for (size_t i = 0; i < growBy; ++i)
         {
@@ -70,6 +115,7 @@ template <typename T, size_t preAlloc, size_t growBy, size_t capacity = 16384> s
 
     template <typename... Args> void setupPoolToSize(size_t upTo, Args &&...args)
     {
+        collectRefills();
         while (position < upTo)
         {
             pool[position] = new T(std::forward<Args>(args)...);
@@ -79,6 +125,7 @@ template <typename T, size_t preAlloc, size_t growBy, size_t capacity = 16384> s
 
     void returnToPreAllocSize()
     {
+        collectRefills();
         while (position > preAlloc)
         {
             delete pool[position - 1];
@@ -87,6 +134,92 @@ template <typename T, size_t preAlloc, size_t growBy, size_t capacity = 16384> s
         }
     }
 
+    /*
+     * Call before the pool is shared with a refilling thread. Items are built from copies of
+     * args, so these have to outlive the pool.
+     */
+    template <typename... Args>
+    void enableBackgroundRefill(size_t lowWaterMark, size_t highWaterMark,
+                                std::function<void()> wakeRefiller, Args... args)
+    {
+        assert(lowWaterMark <= highWaterMark && highWaterMark < capacity);
+        lowWater = lowWaterMark;
+        highWater = highWaterMark;
+        wake = std::move(wakeRefiller);
+        make = [args...]() { return new T(args...); };
+    }
+
+    void setNeverAllocate(bool b) { neverAllocate.store(b, std::memory_order_relaxed); }
+
+    /*
+     * Keep at least upTo items in hand from now on, rather than highWater; this asks for a
+     * refill now if the pool is short. release() goes back to highWater, and hands anything
+     * past preAlloc to the refilling thread to delete.
+     */
+    void reserve(size_t upTo)
+    {
+        reserved = std::min(upTo, capacity - 1);
+        collectRefills();
+
+        if (position < reserved)
+            requestRefill();
+    }
+
+    void release()
+    {
+        reserved = 0;
+        collectRefills();
+
+        bool any{false};
+
+        while (position > preAlloc)
+        {
+            auto h = retireHead.load(std::memory_order_relaxed);
+
+            // come back for the rest next time, if the refiller is that far behind
+            if (h - retireTail.load(std::memory_order_acquire) >= capacity)
+                break;
+
+            retired[h % capacity] = pool[position - 1];
+            pool[position - 1] = nullptr;
+            position--;
+            retireHead.store(h + 1, std::memory_order_release);
+            any = true;
+        }
+
+        if (any && wake)
+            wake();
+    }
+
+    // the refilling thread; returns how many items it built
+    size_t refill()
+    {
+        auto rh = retireHead.load(std::memory_order_acquire);
+
+        for (auto t = retireTail.load(std::memory_order_relaxed); t != rh; ++t)
+        {
+            delete retired[t % capacity];
+            retired[t % capacity] = nullptr;
+            retireTail.store(t + 1, std::memory_order_release);
+        }
+
+        if (!refillPending.load(std::memory_order_acquire))
+            return 0;
+
+        auto n = refillCount;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            auto h = ringHead.load(std::memory_order_relaxed);
+            ring[h % capacity] = make();
+            ringHead.store(h + 1, std::memory_order_release);
+        }
+
+        built.fetch_add(n, std::memory_order_relaxed);
+        refillPending.store(false, std::memory_order_release);
+        return n;
+    }
+
     std::array<T *, capacity> pool;
 
     /*
@@ -95,6 +228,74 @@ template <typename T, size_t preAlloc, size_t growBy, size_t capacity = 16384> s
      * position -1. position == 0 is a sentinel to rebuild.
      */
     size_t position{0};
+
+    // telemetry: getItem calls which found the pool empty, and items built by refill()
+    std::atomic<uint64_t> misses{0}, built{0};
+
+    // moves whatever refill() has built so far into the pool
+    void collectRefills()
+    {
+        auto h = ringHead.load(std::memory_order_acquire);
+
+        while (ringTail != h)
+        {
+            assert(position < capacity);
+            pool[position] = ring[ringTail % capacity];
+            ring[ringTail % capacity] = nullptr;
+            position++;
+            ringTail++;
+        }
+
+        // a reserve() which came while an earlier, smaller request was out
+        if (refillDeferred && !refillPending.load(std::memory_order_acquire))
+        {
+            refillDeferred = false;
+            requestRefill();
+        }
+    }
+
+  private:
+    void requestRefill()
+    {
+        if (!make)
+            return;
+
+        // one request at a time, so the ring never holds more than one request's items
+        if (refillPending.load(std::memory_order_acquire))
+        {
+            refillDeferred = reserved > 0;
+            return;
+        }
+
+        collectRefills();
+
+        // items out with callers come back here too, so leave room for them
+        auto target = std::min(std::max(highWater, reserved), capacity - 1 - outstanding);
+
+        if (position >= target || refillPending.load(std::memory_order_relaxed))
+            return;
+
+        refillCount = target - position;
+        refillPending.store(true, std::memory_order_release);
+        wake();
+    }
+
+    size_t lowWater{0}, highWater{0}, reserved{0}, outstanding{0};
+    bool refillDeferred{false};
+    std::function<void()> wake;
+    std::function<T *()> make;
+    std::atomic<bool> neverAllocate{false};
+
+    // refillCount is written by the owner while refillPending is false, and read by refill()
+    std::atomic<bool> refillPending{false};
+    size_t refillCount{0};
+    std::array<T *, capacity> ring{};
+    std::atomic<size_t> ringHead{0};
+    size_t ringTail{0};
+
+    // and the other way, for release()
+    std::array<T *, capacity> retired{};
+    std::atomic<size_t> retireHead{0}, retireTail{0};
 };
 } // namespace Memory
 } // namespace Surge
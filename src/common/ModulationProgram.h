@@ -0,0 +1,145 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_MODULATIONPROGRAM_H
+#define SURGE_SRC_COMMON_MODULATIONPROGRAM_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Parameter.h"
+#include "ModulationSource.h"
+
+namespace Surge
+{
+namespace Modulation
+{
+/*
+ * A routing list flattened for evaluation. It is built whenever the routings are published,
+ * never on the audio thread.
+ *
+ * Each distinct (scene, source, index) the list reads gets one slot, so a modulator feeding
+ * twenty destinations costs one virtual get_output() per block rather than twenty. The
+ * routings themselves are kept as parallel arrays of slot, destination and depth, with mute
+ * already folded into the depth, so the inner loop is a gather, a multiply and an add.
+ *
+ * Routings stay in their original order so sums onto a shared destination round exactly as
+ * they did when we walked the vector.
+ */
+struct RoutingProgram
+{
+    struct Source
+    {
+        int scene, id, index;
+    };
+
+    /*
+     * Anything past this many distinct sources (which no real patch gets near) falls back to
+     * reading the source per routing.
+     */
+    static constexpr int maxSampledSources = 256;
+
+    void compile(const std::vector<ModulationRouting> &routings, bool skipLFOs = false)
+    {
+        sources.clear();
+        slot.clear();
+        destination.clear();
+        depth.clear();
+
+        for (const auto &r : routings)
+        {
+            if (skipLFOs && isLFO((modsources)r.source_id))
+                continue;
+
+            int s = 0;
+            int ns = (int)sources.size();
+
+            while (s < ns && !(sources[s].scene == r.source_scene &&
+                               sources[s].id == r.source_id && sources[s].index == r.source_index))
+            {
+                s++;
+            }
+
+            if (s == ns)
+            {
+                sources.push_back({r.source_scene, r.source_id, r.source_index});
+            }
+
+            slot.push_back(s);
+            destination.push_back(r.destination_id);
+            depth.push_back(r.muted ? 0.f : r.depth);
+        }
+    }
+
+    bool empty() const { return destination.empty(); }
+
+    /*
+     * Adds depth * output onto dest[destination] for every routing. sourceFor(scene, id)
+     * returns the ModulationSource for a slot; if it returns null, routings reading that
+     * slot add nothing.
+     */
+    template <typename SourceFor> void apply(pdata *dest, SourceFor &&sourceFor) const
+    {
+        const int ns = (int)sources.size();
+        const int nr = (int)destination.size();
+
+        if (nr == 0)
+            return;
+
+        const int32_t *sl = slot.data();
+        const int32_t *dst = destination.data();
+        const float *dep = depth.data();
+
+        if (ns > maxSampledSources)
+        {
+            for (int i = 0; i < nr; ++i)
+            {
+                auto &src = sources[sl[i]];
+                const ModulationSource *ms = sourceFor(src.scene, src.id);
+                if (ms)
+                    dest[dst[i]].f += dep[i] * ms->get_output(src.index);
+            }
+            return;
+        }
+
+        float values[maxSampledSources];
+
+        for (int s = 0; s < ns; ++s)
+        {
+            const ModulationSource *ms = sourceFor(sources[s].scene, sources[s].id);
+            values[s] = ms ? ms->get_output(sources[s].index) : 0.f;
+        }
+
+        for (int i = 0; i < nr; ++i)
+        {
+            dest[dst[i]].f += dep[i] * values[sl[i]];
+        }
+    }
+
+    std::vector<Source> sources;
+    std::vector<int32_t> slot, destination;
+    std::vector<float> depth;
+};
+} // namespace Modulation
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_MODULATIONPROGRAM_H
@@ -667,6 +667,13 @@ class RandomModulationSource : public ModulationSource
         }
     }
 
+    void seed(unsigned int s)
+    {
+        gen.seed(s);
+        dis.reset();
+        norm.reset();
+    }
+
     float output[2];
     bool bipolar{false};
     std::minstd_rand gen;
@@ -22,6 +22,9 @@
 
 #include "PatchDB.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
 #include <sstream>
 #include <iterator>
 #include <chrono>
@@ -240,7 +243,7 @@ struct TxnGuard
 
 struct PatchDB::WriterWorker
 {
-    static constexpr const char *schema_version = "14"; // I will rebuild if this is not my version
+    static constexpr const char *schema_version = "16"; // I will rebuild if this is not my version
 
     static constexpr const char *setup_sql = R"SQL(
 DROP TABLE IF EXISTS "Patches";
@@ -248,6 +251,7 @@ DROP TABLE IF EXISTS "PatchFeature";
 DROP TABLE IF EXISTS "Version";
 DROP TABLE IF EXISTS "Category";
 DROP TABLE IF EXISTS "DebugJunk";
+DROP TABLE IF EXISTS "PatchSearch";
 CREATE TABLE "Version" (
     id integer primary key,
     schema_version varchar(256)
@@ -259,7 +263,8 @@ CREATE TABLE "Patches" (
       search_over varchar(1024),
       category varchar(2048),
       category_type int,
-      last_write_time big int
+      last_write_time big int,
+      file_size big int
 );
 CREATE TABLE PatchFeature (
       id integer primary key,
@@ -280,6 +285,14 @@ CREATE TABLE Category (
 CREATE TABLE DebugJunk (
     id integer primary key,
     junk varchar(2048)
+);
+CREATE VIRTUAL TABLE PatchSearch USING fts5 (
+    name,
+    search_over,
+    author,
+    category,
+    tokenize = 'unicode61 remove_diacritics 2',
+    prefix = '2 3'
 )
     )SQL";
 
@@ -290,6 +303,16 @@ CREATE TABLE IF NOT EXISTS Favorites (
     path varchar(2048)
 );
 )SQL";
+
+    // FIXME features should be an enum or something
+
+    enum FeatureType
+    {
+        INT,
+        STRING
+    };
+    typedef std::tuple<std::string, FeatureType, int, std::string> feature;
+
     struct EnQAble
     {
         virtual ~EnQAble() = default;
@@ -307,7 +330,14 @@ CREATE TABLE IF NOT EXISTS Favorites (
         std::string catname;
         CatType type;
 
-        void go(WriterWorker &w) override { w.parseFXPIntoDB(*this); }
+        // filled in by readPatchFile, on any thread, before the writer gets to us
+        bool hasBeenRead{false};
+        bool exists{false}, isValid{false};
+        int64_t lastWriteTime{0}, fileSize{0};
+        std::vector<feature> features;
+        std::string searchOver;
+
+        void go(WriterWorker &w) override { w.writePatchIntoDB(*this); }
     };
 
     struct EnQDebugMsg : public EnQAble
@@ -534,14 +564,6 @@ CREATE TABLE IF NOT EXISTS Favorites (
         }
     }
 
-    // FIXME features should be an enum or something
-
-    enum FeatureType
-    {
-        INT,
-        STRING
-    };
-    typedef std::tuple<std::string, FeatureType, int, std::string> feature;
     std::vector<feature> extractFeaturesFromXML(const char *xml)
     {
         std::vector<feature> res;
@@ -648,7 +670,7 @@ CREATE TABLE IF NOT EXISTS Favorites (
     std::atomic<bool> waiting{false};
     void loadQueueFunction()
     {
-        static constexpr auto transChunkSize = 10; // How many FXP to load in a single txn
+        static constexpr auto transChunkSize = 64; // How many FXP to load in a single txn
         int lock_retries{0};
         while (keepRunning)
         {
@@ -677,6 +699,8 @@ CREATE TABLE IF NOT EXISTS Favorites (
             }
             if (!doThis.empty())
             {
+                readPatchFiles(doThis);
+
                 if (!dbh)
                     openDb();
                 if (dbh == nullptr)
@@ -732,115 +756,41 @@ CREATE TABLE IF NOT EXISTS Favorites (
                     {
                         storage->reportError(e.what(), "Patch DB");
                     }
+
+                    patchStatements.reset();
                 }
             }
         }
     }
 
-    void parseFXPIntoDB(const EnQPatch &p)
+    /*
+     * Indexing a patch is mostly reading the file and parsing its XML, none of which needs the
+     * database. readPatchFile does that part and only touches p, so the writer runs it for a
+     * whole batch across a few threads; writePatchIntoDB then does the inserts on the writer.
+     */
+    void readPatchFile(EnQPatch &p)
     {
-        sqlite3_stmt *insertStmt = nullptr, *insfeatureStmt = nullptr, *dropIdStmt = nullptr;
-
-        if (!fs::exists(p.path))
-        {
-#if TRACE_DB
-            std::cout << "    - Warning: Non existent " << path_to_string(p.path) << std::endl;
-#endif
+        if (p.hasBeenRead)
             return;
-        }
-        // Check with
-        auto qtime = fs::last_write_time(p.path);
-        int64_t qtimeInt =
-            std::chrono::duration_cast<std::chrono::seconds>(qtime.time_since_epoch()).count();
-
-        bool patchLoaded = false;
-        std::vector<int> dropIds;
-        try
-        {
-            auto exists = SQL::Statement(
-                dbh, "SELECT id, last_write_time from Patches WHERE Patches.Path LIKE ?1");
-            const auto path(p.path.u8string());
-            exists.bind(1, path);
 
-            // Drop all the ones with this path independent of time if I'm adding
-            while (exists.step())
-            {
-                auto id = exists.col_int(0);
-                auto t = exists.col_int64(1);
-                dropIds.push_back(id);
-            }
+        p.hasBeenRead = true;
 
-            exists.finalize();
+        std::error_code tec, sec;
+        auto qtime = fs::last_write_time(p.path, tec);
+        auto qsize = fs::file_size(p.path, sec);
 
-            if (!dropIds.empty())
-            {
-                auto drop = SQL::Statement(dbh, "DELETE FROM Patches WHERE ID=?1;");
-                for (auto did : dropIds)
-                {
-                    drop.bind(1, did);
-                    while (drop.step())
-                    {
-                    }
-                    drop.clearBindings();
-                    drop.reset();
-                }
-
-                drop.finalize();
-
-                auto dropF = SQL::Statement(dbh, "DELETE FROM PatchFeature WHERE PATCH_ID=?1;");
-                for (auto did : dropIds)
-                {
-                    dropF.bind(1, did);
-                    while (dropF.step())
-                    {
-                    }
-                    dropF.clearBindings();
-                    dropF.reset();
-                }
-
-                dropF.finalize();
-            }
-        }
-        catch (const SQL::Exception &e)
+        if (tec || sec)
         {
-            if (storage)
-            {
-                storage->reportError(e.what(), "PatchDB - Load Check");
-            }
+#if TRACE_DB
+            std::cout << "    - Warning: Non existent " << path_to_string(p.path) << std::endl;
+#endif
             return;
         }
 
-        if (patchLoaded)
-            return;
-
-        int64_t patchid = -1;
-        try
-        {
-            auto ins = SQL::Statement(dbh, "INSERT INTO PATCHES ( \"path\", \"name\", "
-                                           "\"category\", \"category_type\", \"last_write_time\" ) "
-                                           "VALUES ( ?1, ?2, ?3, ?4, ?5 )");
-            const auto path(p.path.u8string());
-            ins.bind(1, path);
-            ins.bind(2, p.name);
-            ins.bind(3, p.catname);
-            ins.bind(4, (int)p.type);
-            ins.bindi64(5, qtimeInt);
-
-            ins.step();
-
-            // No real need to encapsulate this
-            patchid = sqlite3_last_insert_rowid(dbh);
-
-            ins.finalize();
-        }
-        catch (const SQL::Exception &e)
-        {
-            if (storage)
-            {
-                storage->reportError(e.what(), "PatchDB - Insert Patch");
-            }
-            return;
-        }
+        p.exists = true;
+        p.lastWriteTime =
+            std::chrono::duration_cast<std::chrono::seconds>(qtime.time_since_epoch()).count();
+        p.fileSize = (int64_t)qsize;
 
         std::ostringstream searchName;
         searchName << p.name << " ";
@@ -871,6 +821,8 @@ CREATE TABLE IF NOT EXISTS Favorites (
             }
         }
 
+        p.searchOver = searchName.str();
+
         std::ifstream stream(p.path, std::ios::in | std::ios::binary);
 
         std::vector<char> fxChunk;
@@ -910,52 +862,207 @@ CREATE TABLE IF NOT EXISTS Favorites (
         stream.read(xmlData.data(), xmlData.size());
         if (!stream)
             return;
+
+        p.features = extractFeaturesFromXML(xmlData.data());
+        p.isValid = true;
+
+        for (const auto &f : p.features)
+        {
+            if (std::get<0>(f) == "TAG")
+            {
+                p.searchOver += " " + std::get<3>(f);
+            }
+        }
+    }
+
+    void readPatchFiles(const std::vector<EnQAble *> &items)
+    {
+        std::vector<EnQPatch *> patches;
+
+        for (auto *i : items)
+        {
+            if (auto *p = dynamic_cast<EnQPatch *>(i); p && !p->hasBeenRead)
+                patches.push_back(p);
+        }
+
+        int nThreads = std::min((int)patches.size(),
+                                std::clamp((int)std::thread::hardware_concurrency(), 1, 8));
+        std::atomic<size_t> next{0};
+
+        auto drain = [&]() {
+            for (auto i = next++; i < patches.size(); i = next++)
+            {
+                readPatchFile(*patches[i]);
+            }
+        };
+
+        // the writer reads too, so one thread fewer than that
+        std::vector<std::thread> readers;
+        for (int t = 1; t < nThreads; ++t)
+        {
+            readers.emplace_back(drain);
+        }
+
+        drain();
+
+        for (auto &t : readers)
+        {
+            t.join();
+        }
+    }
+
+    /*
+     * The statements writePatchIntoDB needs, prepared once per batch rather than once per
+     * patch. loadQueueFunction drops them when the batch is done.
+     */
+    struct PatchStatements
+    {
+        explicit PatchStatements(sqlite3 *dbh)
+            : findByPath(dbh, "SELECT id from Patches WHERE Patches.Path LIKE ?1"),
+              dropPatch(dbh, "DELETE FROM Patches WHERE ID=?1;"),
+              dropFeatures(dbh, "DELETE FROM PatchFeature WHERE PATCH_ID=?1;"),
+              dropSearch(dbh, "DELETE FROM PatchSearch WHERE rowid=?1;"),
+              insertPatch(dbh, "INSERT INTO PATCHES ( \"path\", \"name\", \"search_over\", "
+                               "\"category\", \"category_type\", \"last_write_time\", "
+                               "\"file_size\" ) VALUES ( ?1, ?2, ?3, ?4, ?5, ?6, ?7 )"),
+              insertFeature(dbh, "INSERT INTO PATCHFEATURE ( \"patch_id\", \"feature\", "
+                                 "\"feature_type\", \"feature_ivalue\", \"feature_svalue\" ) "
+                                 "VALUES ( ?1, ?2, ?3, ?4, ?5 )"),
+              insertSearch(dbh, "INSERT INTO PatchSearch ( \"rowid\", \"name\", "
+                                "\"search_over\", \"author\", \"category\" ) "
+                                "VALUES ( ?1, ?2, ?3, ?4, ?5 )")
+        {
+        }
+
+        ~PatchStatements()
+        {
+            for (auto *st : {&findByPath, &dropPatch, &dropFeatures, &dropSearch, &insertPatch,
+                             &insertFeature, &insertSearch})
+            {
+                try
+                {
+                    st->finalize();
+                }
+                catch (const SQL::Exception &)
+                {
+                    // we're unwinding a batch which already failed, so nothing more to say
+                }
+            }
+        }
+
+        static void run(SQL::Statement &st)
+        {
+            while (st.step())
+            {
+            }
+            st.clearBindings();
+            st.reset();
+        }
+
+        SQL::Statement findByPath, dropPatch, dropFeatures, dropSearch;
+        SQL::Statement insertPatch, insertFeature, insertSearch;
+    };
+    std::unique_ptr<PatchStatements> patchStatements;
+
+    void writePatchIntoDB(EnQPatch &p)
+    {
+        // normally done already for the whole batch, but a retry could land here cold
+        readPatchFile(p);
+
+        if (!p.exists)
+            return;
+
+        if (!patchStatements)
+            patchStatements = std::make_unique<PatchStatements>(dbh);
+
+        auto &st = *patchStatements;
+        const auto path(p.path.u8string());
+
         try
         {
-            auto ins =
-                SQL::Statement(dbh, "INSERT INTO PATCHFEATURE ( \"patch_id\", \"feature\", "
-                                    "\"feature_type\", \"feature_ivalue\", \"feature_svalue\" ) "
-                                    "VALUES ( ?1, ?2, ?3, ?4, ?5 )");
-            auto feat = extractFeaturesFromXML(xmlData.data());
-            for (const auto &f : feat)
+            // Drop all the ones with this path independent of time if I'm adding
+            std::vector<int> dropIds;
+
+            st.findByPath.bind(1, path);
+            while (st.findByPath.step())
             {
-                const auto &ftype = std::get<0>(f);
-                ins.bindi64(1, patchid);
-                ins.bind(2, std::get<0>(f));
-                ins.bind(3, (int)std::get<1>(f));
-                ins.bind(4, std::get<2>(f));
-                ins.bind(5, std::get<3>(f));
-
-                ins.step();
-
-                ins.clearBindings();
-                ins.reset();
-                if (ftype == "TAG")
+                dropIds.push_back(st.findByPath.col_int(0));
+            }
+            st.findByPath.clearBindings();
+            st.findByPath.reset();
+
+            for (auto did : dropIds)
+            {
+                for (auto *drop : {&st.dropPatch, &st.dropFeatures, &st.dropSearch})
                 {
-                    searchName << " " << std::get<3>(f);
+                    drop->bind(1, did);
+                    PatchStatements::run(*drop);
                 }
             }
+        }
+        catch (const SQL::Exception &e)
+        {
+            if (storage)
+            {
+                storage->reportError(e.what(), "PatchDB - Load Check");
+            }
+            return;
+        }
+
+        int64_t patchid = -1;
+        try
+        {
+            st.insertPatch.bind(1, path);
+            st.insertPatch.bind(2, p.name);
+            st.insertPatch.bind(3, p.searchOver);
+            st.insertPatch.bind(4, p.catname);
+            st.insertPatch.bind(5, (int)p.type);
+            st.insertPatch.bindi64(6, p.lastWriteTime);
+            st.insertPatch.bindi64(7, p.fileSize);
+            PatchStatements::run(st.insertPatch);
 
-            ins.finalize();
+            // No real need to encapsulate this
+            patchid = sqlite3_last_insert_rowid(dbh);
         }
         catch (const SQL::Exception &e)
         {
             if (storage)
             {
-                storage->reportError(e.what(), "PatchDB - FXP Features");
+                storage->reportError(e.what(), "PatchDB - Insert Patch");
             }
             return;
         }
 
-        auto sns = searchName.str();
+        // an unreadable patch keeps its row, so it isn't retried until it changes
+        if (!p.isValid)
+            return;
+
+        std::string author;
+
         try
         {
-            auto ins = SQL::Statement(dbh, "UPDATE PATCHES SET search_over=?1 WHERE id=?2");
-            ins.bind(1, sns);
-            ins.bind(2, patchid);
+            for (const auto &f : p.features)
+            {
+                st.insertFeature.bindi64(1, patchid);
+                st.insertFeature.bind(2, std::get<0>(f));
+                st.insertFeature.bind(3, (int)std::get<1>(f));
+                st.insertFeature.bind(4, std::get<2>(f));
+                st.insertFeature.bind(5, std::get<3>(f));
+                PatchStatements::run(st.insertFeature);
+
+                if (std::get<0>(f) == "AUTHOR")
+                {
+                    author = std::get<3>(f);
+                }
+            }
 
-            ins.step();
-            ins.finalize();
+            // the full text index over the same text, so searches don't scan Patches
+            st.insertSearch.bindi64(1, patchid);
+            st.insertSearch.bind(2, p.name);
+            st.insertSearch.bind(3, p.searchOver);
+            st.insertSearch.bind(4, author);
+            st.insertSearch.bind(5, p.catname);
+            PatchStatements::run(st.insertSearch);
         }
         catch (const SQL::Exception &e)
         {
@@ -1005,6 +1112,11 @@ CREATE TABLE IF NOT EXISTS Favorites (
             feat.bind(1, id);
             feat.step();
             feat.finalize();
+
+            auto search = SQL::Statement(dbh, "DELETE FROM PatchSearch where rowid=?");
+            search.bind(1, id);
+            search.step();
+            search.finalize();
         }
         catch (const SQL::Exception &e)
         {
@@ -1433,10 +1545,10 @@ std::vector<std::string> PatchDB::readUserFavorites()
     return std::vector<std::string>();
 }
 
-std::unordered_map<std::string, std::pair<int, int64_t>>
-PatchDB::readAllPatchPathsWithIdAndModTime()
+std::unordered_map<std::string, PatchDB::indexedFileRecord>
+PatchDB::readAllPatchPathsWithIdModTimeAndSize()
 {
-    std::unordered_map<std::string, std::pair<int, int64_t>> res;
+    std::unordered_map<std::string, indexedFileRecord> res;
 
     auto conn = worker->getReadOnlyConn(false);
     if (!conn)
@@ -1444,13 +1556,15 @@ PatchDB::readAllPatchPathsWithIdAndModTime()
 
     try
     {
-        auto st = SQL::Statement(conn, "select id, path, last_write_time from Patches;");
+        auto st =
+            SQL::Statement(conn, "select id, path, last_write_time, file_size from Patches;");
         while (st.step())
         {
             auto id = st.col_int(0);
             auto pt = st.col_str(1);
             auto lw = st.col_int64(2);
-            res[pt] = std::make_pair(id, lw);
+            auto sz = st.col_int64(3);
+            res[pt] = indexedFileRecord{id, lw, sz};
         }
         st.finalize();
     }
@@ -1481,66 +1595,136 @@ int PatchDB::waitForJobsOutstandingComplete(int maxWaitInMS)
     return numberOfJobsOutstanding();
 }
 
-std::string PatchDB::sqlWhereClauseFor(const std::unique_ptr<PatchDBQueryParser::Token> &t)
+/*
+ * A parsed query as an FTS5 match expression over PatchSearch. Every literal becomes a prefix
+ * phrase, so "pia" finds "Piano" while typing, and plain terms search the name and the
+ * search_over text (which already has the folders and tags in it). Parts which can't
+ * constrain anything, like an empty AUTHOR=, drop out rather than matching nothing.
+ */
+struct FTSMatch
 {
-    auto protect = [](const std::string &s) -> std::string {
-        std::vector<std::pair<std::string, std::string>> replacements{{"'", "''"}, {"%", "%%"}};
-        std::string res = s;
-        for (const auto &[search, replace] : replacements)
-        {
-            size_t pos = res.find(search);
-            // Repeat till end is reached
-            while (pos != std::string::npos)
-            {
-                // Replace this occurrence of Sub String
-                res.replace(pos, search.size(), replace);
-                // Get the next occurrence from the current position
-                pos = res.find(search, pos + replace.size());
-            }
+    enum Kind
+    {
+        ALWAYS,
+        NEVER,
+        EXPRESSION
+    } kind{ALWAYS};
+    std::string expression;
+};
+
+static std::string ftsPrefixPhrase(const std::string &s)
+{
+    std::string res = "\"";
+    for (auto c : s)
+    {
+        if (c == '"')
+            res += '"';
+        res += c;
+    }
+    return res + "\" *";
+}
+
+static bool hasTokenCharacters(const std::string &s)
+{
+    // matches what the unicode61 tokenizer keeps, near enough; anything non ASCII counts
+    return std::any_of(s.begin(), s.end(), [](char c) {
+        return (unsigned char)c >= 0x80 || std::isalnum((unsigned char)c);
+    });
+}
+
+static FTSMatch ftsMatchFor(const std::unique_ptr<PatchDBQueryParser::Token> &t)
+{
+    auto res = FTSMatch();
+    auto columnMatch = [&res](const std::string &columns, const std::string &content) {
+        if (hasTokenCharacters(content))
+        {
+            res.kind = FTSMatch::EXPRESSION;
+            res.expression = columns + " : " + ftsPrefixPhrase(content);
         }
-        return res;
     };
-    std::ostringstream oss;
+
     switch (t->type)
     {
     case PatchDBQueryParser::INVALID:
-        oss << "(1 == 0)";
+        res.kind = FTSMatch::NEVER;
         break;
     case PatchDBQueryParser::KEYWORD_EQUALS:
-        if ((t->content == "AUTHOR" || t->content == "AUTH") && !t->children[0]->content.empty())
+        if (t->content == "AUTHOR" || t->content == "AUTH")
         {
-            oss << "(author LIKE '%" << protect(t->children[0]->content) << "%' )";
+            columnMatch("author", t->children[0]->content);
         }
-        else if ((t->content == "CATEGORY" || t->content == "CAT") &&
-                 !t->children[0]->content.empty())
+        else if (t->content == "CATEGORY" || t->content == "CAT")
         {
-            oss << "(category LIKE '%" << protect(t->children[0]->content) << "%' )";
-        }
-        else
-        {
-            oss << "(1 == 1)";
+            columnMatch("category", t->children[0]->content);
         }
         break;
     case PatchDBQueryParser::LITERAL:
-        oss << "( p.search_over LIKE '%" << protect(t->content) << "%' )";
+        columnMatch("{name search_over}", t->content);
         break;
     case PatchDBQueryParser::AND:
     case PatchDBQueryParser::OR:
     {
-        oss << "( ";
-        std::string inter = "";
+        bool isAnd = t->type == PatchDBQueryParser::AND;
+        std::vector<std::string> parts;
+
+        // an AND is short circuited by a NEVER and an OR by an ALWAYS
+        res.kind = isAnd ? FTSMatch::ALWAYS : FTSMatch::NEVER;
+
         for (auto &c : t->children)
         {
-            oss << inter;
-            oss << sqlWhereClauseFor(c);
-            inter = t->type == PatchDBQueryParser::AND ? " AND " : " OR ";
+            auto cm = ftsMatchFor(c);
+
+            if (cm.kind == FTSMatch::EXPRESSION)
+            {
+                parts.push_back("( " + cm.expression + " )");
+            }
+            else if (cm.kind == (isAnd ? FTSMatch::NEVER : FTSMatch::ALWAYS))
+            {
+                res.kind = cm.kind;
+                return res;
+            }
         }
-        oss << " )";
+
+        if (!parts.empty())
+        {
+            res.kind = FTSMatch::EXPRESSION;
+
+            for (const auto &part : parts)
+            {
+                res.expression += (res.expression.empty() ? "" : (isAnd ? " AND " : " OR ")) +
+                                  part;
+            }
+        }
+        break;
+    }
+    }
+
+    return res;
+}
+
+std::string PatchDB::sqlWhereClauseFor(const std::unique_ptr<PatchDBQueryParser::Token> &t)
+{
+    auto m = ftsMatchFor(t);
+
+    switch (m.kind)
+    {
+    case FTSMatch::ALWAYS:
+        return "(1 == 1)";
+    case FTSMatch::NEVER:
+        return "(1 == 0)";
+    case FTSMatch::EXPRESSION:
         break;
     }
+
+    std::string protect;
+    for (auto c : m.expression)
+    {
+        if (c == '\'')
+            protect += '\'';
+        protect += c;
     }
 
-    return oss.str();
+    return "( PatchSearch MATCH '" + protect + "' )";
 }
 
 std::vector<PatchDB::patchRecord>
@@ -1548,12 +1732,23 @@ PatchDB::queryFromQueryString(const std::unique_ptr<PatchDBQueryParser::Token> &
 {
     std::vector<PatchDB::patchRecord> res;
 
+    /*
+     * bm25 ranks by relevance once we have a match expression, with a hit in the name weighing
+     * most. Without one (an empty query, say) there is nothing to rank, so fall back to the
+     * browser's order.
+     */
+    bool ranked = ftsMatchFor(t).kind == FTSMatch::EXPRESSION;
+    std::string search = ranked ? "PatchSearch.rowid == p.id and " : "";
+    std::string order = ranked ? "bm25(PatchSearch, 10.0, 1.0, 5.0, 2.0), " : "";
+
     // FIXME - cache this by pushing it to the worker
     std::string query = "select p.id, p.path, p.category as category, p.name, pf.feature_svalue as "
-                        "author, p.search_over from Patches "
-                        "as p, PatchFeature as pf where pf.patch_id == p.id and pf.feature LIKE "
-                        "'AUTHOR' and " +
-                        sqlWhereClauseFor(t) + " ORDER BY p.category_type, p.category, p.name";
+                        "author, p.search_over from " +
+                        std::string(ranked ? "PatchSearch, " : "") +
+                        "Patches as p, PatchFeature as pf where " + search +
+                        "pf.patch_id == p.id and pf.feature LIKE 'AUTHOR' and " +
+                        sqlWhereClauseFor(t) + " ORDER BY " + order +
+                        "p.category_type, p.category, p.name";
 
     // std::cout << "QUERY IS \n" << query << "\n";
     try
@@ -136,9 +136,18 @@ struct PatchDB
     std::vector<int> readAllFeatureValueInt(const std::string &feature);
     std::vector<std::string> readUserFavorites();
 
-    std::unordered_map<std::string, std::pair<int, int64_t>> readAllPatchPathsWithIdAndModTime();
+    struct indexedFileRecord
+    {
+        int id;
+        int64_t lastWriteTime;
+        int64_t fileSize;
+    };
+    std::unordered_map<std::string, indexedFileRecord> readAllPatchPathsWithIdModTimeAndSize();
 
-    // How the query string works
+    /*
+     * How the query string works: it becomes an FTS5 match on the PatchSearch index, with each
+     * term a prefix match, and results come back ranked by relevance.
+     */
     static std::string sqlWhereClauseFor(const std::unique_ptr<PatchDBQueryParser::Token> &t);
     std::vector<patchRecord> queryFromQueryString(const std::string &query)
     {
@@ -0,0 +1,180 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "SceneRenderPool.h"
+
+#include <algorithm>
+#include <cassert>
+
+#if WINDOWS
+#include <windows.h>
+#elif LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace Surge
+{
+namespace Threading
+{
+/*
+ * Pin to a core, round-robining across instances so several synths in one process
+ * don't all land their workers on the same core. macOS has no hard affinity API, so
+ * there we just leave scheduling to the OS.
+ */
+static void pinCurrentThread(int core)
+{
+#if WINDOWS
+    SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << (core % (8 * sizeof(DWORD_PTR))));
+#elif LINUX
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(core, &cpuset);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+#else
+    (void)core;
+#endif
+}
+
+static int nextCoreForWorker()
+{
+    static std::atomic<int> nextCore{0};
+    int hw = (int)std::thread::hardware_concurrency();
+
+    if (hw <= 1)
+        return 0;
+
+    // leave core 0 for the host and the rest of the world
+    return 1 + (nextCore++ % (hw - 1));
+}
+
+SceneRenderPool::SceneRenderPool(int nWorkers)
+{
+    for (int i = 0; i < nWorkers; ++i)
+    {
+        workers.push_back(std::make_unique<Worker>());
+    }
+
+    for (auto &w : workers)
+    {
+        w->thread = std::thread(&SceneRenderPool::workerLoop, this, w.get(), nextCoreForWorker());
+    }
+}
+
+SceneRenderPool::~SceneRenderPool()
+{
+    keepRunning = false;
+
+    for (auto &w : workers)
+    {
+        {
+            std::lock_guard<std::mutex> g(w->m);
+        }
+        w->cv.notify_one();
+    }
+
+    for (auto &w : workers)
+    {
+        if (w->thread.joinable())
+            w->thread.join();
+    }
+}
+
+void SceneRenderPool::run(job_t job, void *ctx, int nJobs)
+{
+    int nDispatched = std::min(nJobs - 1, (int)workers.size());
+
+    for (int i = 0; i < nDispatched; ++i)
+    {
+        auto &w = workers[i];
+        assert(w->state.load() == IDLE);
+
+        w->job = job;
+        w->ctx = ctx;
+        w->index = i + 1;
+        w->state.store(PENDING);
+
+        if (w->sleeping.load())
+        {
+            // taking the lock here closes the gap between the worker checking its
+            // predicate and blocking; it is only ever held for a moment
+            {
+                std::lock_guard<std::mutex> g(w->m);
+            }
+            w->cv.notify_one();
+        }
+    }
+
+    job(ctx, 0);
+
+    // anything we have no worker for just runs here
+    for (int i = nDispatched + 1; i < nJobs; ++i)
+    {
+        job(ctx, i);
+    }
+
+    for (int i = 0; i < nDispatched; ++i)
+    {
+        auto &w = workers[i];
+        int expected = PENDING;
+
+        if (w->state.compare_exchange_strong(expected, RUNNING))
+        {
+            // the worker never got to it, so do it ourselves rather than wait for a wakeup
+            job(ctx, w->index);
+        }
+        else
+        {
+            while (w->state.load(std::memory_order_acquire) != DONE)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        w->state.store(IDLE);
+    }
+}
+
+void SceneRenderPool::workerLoop(Worker *w, int core)
+{
+    pinCurrentThread(core);
+
+    while (keepRunning)
+    {
+        int expected = PENDING;
+
+        if (w->state.compare_exchange_strong(expected, RUNNING))
+        {
+            w->job(w->ctx, w->index);
+            w->state.store(DONE, std::memory_order_release);
+            continue;
+        }
+
+        // nothing to do, so block until run() hands us the next job
+        std::unique_lock<std::mutex> lk(w->m);
+        w->sleeping = true;
+        w->cv.wait(lk, [w, this]() { return !keepRunning || w->state.load() == PENDING; });
+        w->sleeping = false;
+    }
+}
+} // namespace Threading
+} // namespace Surge
@@ -0,0 +1,93 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_SCENERENDERPOOL_H
+#define SURGE_SRC_COMMON_SCENERENDERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Surge
+{
+namespace Threading
+{
+/*
+ * A tiny pool of pinned worker threads which the audio thread hands per-scene render
+ * jobs to. Job 0 always runs on the calling thread, jobs 1..n go to the workers.
+ *
+ * Workers sleep on a condition variable between jobs, so an idle pool costs nothing. The
+ * audio thread never waits on a worker which hasn't started yet: once it has finished
+ * its own job it tries to claim each outstanding job itself, and only spins on jobs which a
+ * worker is already running. So a descheduled or slow to wake worker costs us parallelism,
+ * not a dropout.
+ *
+ * Jobs are a function pointer and a context so dispatch never allocates.
+ */
+struct SceneRenderPool
+{
+    typedef void (*job_t)(void *ctx, int job);
+
+    explicit SceneRenderPool(int nWorkers);
+    ~SceneRenderPool();
+
+    /*
+     * Only call from the audio thread. Runs job(ctx, i) for every i in [0, nJobs) and
+     * returns once they have all completed.
+     */
+    void run(job_t job, void *ctx, int nJobs);
+
+    int workerCount() const { return (int)workers.size(); }
+
+  private:
+    enum State
+    {
+        IDLE,
+        PENDING,
+        RUNNING,
+        DONE
+    };
+
+    struct Worker
+    {
+        std::atomic<int> state{IDLE};
+        std::atomic<bool> sleeping{false};
+        job_t job{nullptr};
+        void *ctx{nullptr};
+        int index{0};
+        std::thread thread;
+        std::mutex m;
+        std::condition_variable cv;
+    };
+
+    void workerLoop(Worker *w, int core);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<bool> keepRunning{true};
+};
+} // namespace Threading
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_SCENERENDERPOOL_H
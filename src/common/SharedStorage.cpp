@@ -0,0 +1,429 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "SharedStorage.h"
+
+#include "sst/basic-blocks/tables/SincTableProvider.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <unordered_set>
+
+namespace Surge
+{
+namespace Storage
+{
+SharedTables::SharedTables()
+{
+    sincTableProvider = std::make_unique<sst::basic_blocks::tables::SurgeSincTableProvider>();
+
+    float _512th = 1.f / 512.f;
+
+    for (int i = 0; i < table_size; i++)
+    {
+        table_dB[i] = powf(10.f, 0.05f * ((float)i - 384.f));
+        table_pitch[i] = powf(2.f, ((float)i - 256.f) * (1.f / 12.f));
+        table_pitch_inv[i] = 1.f / table_pitch[i];
+        table_glide_log[i] = log2(1.0 + (i * _512th * 10.f)) / log2(1.f + 10.f);
+        table_glide_exp[511 - i] = 1.0 - table_glide_log[i];
+    }
+
+    for (int i = 0; i < 1001; ++i)
+    {
+        double twelths = i * 1.0 / 12.0 / 1000.0;
+        table_two_to_the[i] = pow(2.0, twelths);
+        table_two_to_the_minus[i] = pow(2.0, -twelths);
+    }
+}
+
+SharedTables::~SharedTables() = default;
+
+SampleRateTables::SampleRateTables(double os) : dsamplerate_os(os)
+{
+    float db60 = powf(10.f, 0.05f * -60.f);
+    double os_inv = 1.0 / os;
+
+    for (int i = 0; i < table_size; i++)
+    {
+        float pitch = powf(2.f, ((float)i - 256.f) * (1.f / 12.f));
+        table_note_omega[0][i] = (float)sin(2 * M_PI * std::min(0.5, 440 * pitch * os_inv));
+        table_note_omega[1][i] = (float)cos(2 * M_PI * std::min(0.5, 440 * pitch * os_inv));
+        double k = os * pow(2.0, (((double)i - 256.0) / 16.0)) / (double)BLOCK_SIZE_OS;
+        table_envrate_linear[i] = (float)(1.f / k);
+        table_envrate_lpf[i] = (float)(1.f - exp(log(db60) / k));
+    }
+}
+
+/*
+ * The caches only hold weak references, so tables live exactly as long as some storage
+ * holds them. Both are consulted on construction and sample rate changes only.
+ */
+std::shared_ptr<const SharedTables> getSharedTables()
+{
+    static std::mutex m;
+    static std::weak_ptr<const SharedTables> cache;
+
+    std::lock_guard<std::mutex> g(m);
+    auto res = cache.lock();
+
+    if (!res)
+    {
+        res = std::make_shared<const SharedTables>();
+        cache = res;
+    }
+
+    return res;
+}
+
+std::shared_ptr<const SampleRateTables> getSampleRateTables(double dsamplerate_os)
+{
+    static std::mutex m;
+    static std::map<double, std::weak_ptr<const SampleRateTables>> cache;
+
+    std::lock_guard<std::mutex> g(m);
+
+    for (auto it = cache.begin(); it != cache.end();)
+    {
+        if (it->second.expired())
+            it = cache.erase(it);
+        else
+            ++it;
+    }
+
+    auto &entry = cache[dsamplerate_os];
+    auto res = entry.lock();
+
+    if (!res)
+    {
+        res = std::make_shared<const SampleRateTables>(dsamplerate_os);
+        entry = res;
+    }
+
+    return res;
+}
+
+std::shared_ptr<ContentIndex> ContentIndex::forFolders(const std::string &key)
+{
+    static std::mutex m;
+    static std::map<std::string, std::weak_ptr<ContentIndex>> cache;
+
+    std::lock_guard<std::mutex> g(m);
+    auto &entry = cache[key];
+    auto res = entry.lock();
+
+    if (!res)
+    {
+        res = std::make_shared<ContentIndex>();
+        entry = res;
+    }
+
+    return res;
+}
+
+std::shared_ptr<const PatchIndex> ContentIndex::getPatches() const
+{
+    std::lock_guard<std::mutex> g(m);
+    return patches;
+}
+
+std::shared_ptr<const WavetableIndex> ContentIndex::getWavetables() const
+{
+    std::lock_guard<std::mutex> g(m);
+    return wavetables;
+}
+
+std::shared_ptr<const FxPresetIndex> ContentIndex::getFxPresets() const
+{
+    std::lock_guard<std::mutex> g(m);
+    return fxPresets;
+}
+
+void ContentIndex::setPatches(std::shared_ptr<const PatchIndex> p)
+{
+    std::lock_guard<std::mutex> g(m);
+    patches = std::move(p);
+}
+
+void ContentIndex::setWavetables(std::shared_ptr<const WavetableIndex> w)
+{
+    std::lock_guard<std::mutex> g(m);
+    wavetables = std::move(w);
+}
+
+void ContentIndex::setFxPresets(std::shared_ptr<const FxPresetIndex> f)
+{
+    std::lock_guard<std::mutex> g(m);
+    fxPresets = std::move(f);
+}
+
+static constexpr const char *scanCacheHeader = "surge-directory-scan-cache 2";
+
+std::shared_ptr<DirectoryScanCache> DirectoryScanCache::forFile(const fs::path &cacheFile)
+{
+    static std::mutex m;
+    static std::map<std::string, std::weak_ptr<DirectoryScanCache>> cache;
+
+    std::lock_guard<std::mutex> g(m);
+    auto &entry = cache[path_to_string(cacheFile)];
+    auto res = entry.lock();
+
+    if (!res)
+    {
+        res = std::shared_ptr<DirectoryScanCache>(new DirectoryScanCache(cacheFile));
+        entry = res;
+    }
+
+    return res;
+}
+
+DirectoryScanCache::DirectoryScanCache(const fs::path &cacheFile) : cacheFile(cacheFile)
+{
+    read();
+}
+
+DirectoryScanCache::Listing DirectoryScanCache::listUncached(const fs::path &dir)
+{
+    Listing res;
+    res.mtime = fs::last_write_time(dir).time_since_epoch().count();
+    res.scannedAt = fs::file_time_type::clock::now().time_since_epoch().count();
+
+    for (auto &d : fs::directory_iterator(dir))
+    {
+        auto name = path_to_string(d.path().filename());
+
+        if (fs::is_directory(d))
+        {
+            res.subdirs.push_back(name);
+            continue;
+        }
+
+        File f;
+        f.name = name;
+
+        std::error_code tec, sec;
+        auto qtime = d.last_write_time(tec);
+        auto qsize = d.file_size(sec);
+
+        if (!tec && !sec)
+        {
+            f.lastModTime =
+                std::chrono::duration_cast<std::chrono::seconds>(qtime.time_since_epoch()).count();
+            f.fileSize = qsize;
+        }
+
+        res.files.push_back(std::move(f));
+    }
+
+    return res;
+}
+
+void DirectoryScanCache::forget(const fs::path &dir)
+{
+    std::lock_guard<std::mutex> g(m);
+
+    if (listings.erase(path_to_string(dir)))
+        dirty = true;
+}
+
+void DirectoryScanCache::clear()
+{
+    std::lock_guard<std::mutex> g(m);
+
+    listings.clear();
+    dirty = true;
+}
+
+DirectoryScanCache::Listing DirectoryScanCache::list(const fs::path &dir)
+{
+    static const auto slack =
+        std::chrono::duration_cast<fs::file_time_type::duration>(std::chrono::seconds(2)).count();
+
+    auto key = path_to_string(dir);
+    auto mtime = fs::last_write_time(dir).time_since_epoch().count();
+
+    {
+        std::lock_guard<std::mutex> g(m);
+        auto it = listings.find(key);
+
+        if (it != listings.end() && it->second.mtime == mtime &&
+            it->second.scannedAt - mtime > slack)
+        {
+            return it->second;
+        }
+    }
+
+    auto res = listUncached(dir);
+
+    std::lock_guard<std::mutex> g(m);
+    auto it = listings.find(key);
+
+    if (it != listings.end())
+    {
+        // forget everything below subdirectories which have gone away
+        std::unordered_set<std::string> kept(res.subdirs.begin(), res.subdirs.end());
+
+        for (const auto &sd : it->second.subdirs)
+        {
+            if (kept.count(sd))
+                continue;
+
+            auto gone = path_to_string(dir / string_to_path(sd));
+            auto below = [&gone](const std::string &p) {
+                return p.compare(0, gone.size(), gone) == 0 &&
+                       (p.size() == gone.size() || p[gone.size()] == '/' ||
+                        p[gone.size()] == '\\');
+            };
+
+            for (auto q = listings.begin(); q != listings.end();)
+            {
+                if (below(q->first))
+                    q = listings.erase(q);
+                else
+                    ++q;
+            }
+        }
+    }
+
+    listings[key] = res;
+    dirty = true;
+
+    return res;
+}
+
+/*
+ * The format is a header line, then per directory a line with its times, entry counts and
+ * path, followed by its subdirectory names one per line and then a line per file with its
+ * time, size and name. Anything unexpected means the whole file is ignored; it only costs a
+ * full scan.
+ */
+void DirectoryScanCache::read()
+{
+    std::ifstream ifs(cacheFile);
+
+    if (!ifs)
+        return;
+
+    std::string line;
+
+    if (!std::getline(ifs, line) || line != scanCacheHeader)
+        return;
+
+    std::unordered_map<std::string, Listing> res;
+
+    while (std::getline(ifs, line))
+    {
+        std::istringstream iss(line);
+        Listing l;
+        size_t nSubdirs{0}, nFiles{0};
+        std::string path;
+
+        if (!(iss >> l.mtime >> l.scannedAt >> nSubdirs >> nFiles) || !std::getline(iss, path) ||
+            path.size() < 2)
+        {
+            return;
+        }
+
+        for (size_t i = 0; i < nSubdirs; ++i)
+        {
+            if (!std::getline(ifs, line))
+                return;
+
+            l.subdirs.push_back(line);
+        }
+
+        for (size_t i = 0; i < nFiles; ++i)
+        {
+            if (!std::getline(ifs, line))
+                return;
+
+            std::istringstream fss(line);
+            File f;
+
+            if (!(fss >> f.lastModTime >> f.fileSize) || !std::getline(fss, f.name) ||
+                f.name.size() < 2)
+            {
+                return;
+            }
+
+            f.name = f.name.substr(1);
+            l.files.push_back(std::move(f));
+        }
+
+        res[path.substr(1)] = std::move(l);
+    }
+
+    listings = std::move(res);
+}
+
+void DirectoryScanCache::save()
+{
+    std::lock_guard<std::mutex> g(m);
+
+    if (!dirty)
+        return;
+
+    try
+    {
+        if (!fs::is_directory(cacheFile.parent_path()))
+            return;
+
+        auto tmp = cacheFile;
+        tmp += ".tmp";
+
+        {
+            std::ofstream ofs(tmp, std::ios::trunc);
+
+            if (!ofs)
+                return;
+
+            ofs << scanCacheHeader << "\n";
+
+            for (const auto &[path, l] : listings)
+            {
+                ofs << l.mtime << " " << l.scannedAt << " " << l.subdirs.size() << " "
+                    << l.files.size() << " " << path << "\n";
+
+                for (const auto &sd : l.subdirs)
+                    ofs << sd << "\n";
+                for (const auto &f : l.files)
+                    ofs << f.lastModTime << " " << f.fileSize << " " << f.name << "\n";
+            }
+
+            if (!ofs)
+                return;
+        }
+
+        // written aside and moved into place, so another process never reads half a file
+        fs::rename(tmp, cacheFile);
+        dirty = false;
+    }
+    catch (const fs::filesystem_error &)
+    {
+        // it's only a cache; the next scan will try again
+    }
+}
+} // namespace Storage
+} // namespace Surge
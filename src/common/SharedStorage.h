@@ -0,0 +1,202 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_SHAREDSTORAGE_H
+#define SURGE_SRC_COMMON_SHAREDSTORAGE_H
+
+#include "SurgeStorage.h"
+#include "FxPresetAndClipboardManager.h"
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sst::basic_blocks::tables
+{
+struct SurgeSincTableProvider;
+}
+
+namespace Surge
+{
+namespace Storage
+{
+/*
+ * State which every SurgeStorage in a process would otherwise build for itself. A session
+ * with dozens of instances shares one copy of each of these, held by shared_ptr so the last
+ * instance using something frees it.
+ *
+ * SharedTables and SampleRateTables are immutable once built. Their 12-TET pitch and omega
+ * tables are the "ignoring tuning" ones; each SurgeStorage still keeps its own tuned copies
+ * since retuning writes to those.
+ */
+struct SharedTables
+{
+    static constexpr int table_size = SurgeStorage::tuning_table_size;
+
+    SharedTables();
+    ~SharedTables();
+
+    std::unique_ptr<sst::basic_blocks::tables::SurgeSincTableProvider> sincTableProvider;
+
+    float table_dB alignas(16)[table_size];
+    float table_glide_exp alignas(16)[table_size], table_glide_log alignas(16)[table_size];
+    float table_pitch alignas(16)[table_size], table_pitch_inv alignas(16)[table_size];
+    // 2^0 -> 2^+/-1/12th. See comment in SurgeStorage::note_to_pitch_ignoring_tuning
+    float table_two_to_the alignas(16)[1001], table_two_to_the_minus alignas(16)[1001];
+};
+
+struct SampleRateTables
+{
+    static constexpr int table_size = SurgeStorage::tuning_table_size;
+
+    explicit SampleRateTables(double dsamplerate_os);
+
+    double dsamplerate_os;
+    float table_note_omega alignas(16)[2][table_size];
+    float table_envrate_lpf alignas(16)[table_size], table_envrate_linear alignas(16)[table_size];
+};
+
+/*
+ * Both lock a process wide mutex and may build tables, so they are for construction and
+ * SurgeStorage::setSamplerate only and must not be reached from an audio callback.
+ */
+std::shared_ptr<const SharedTables> getSharedTables();
+std::shared_ptr<const SampleRateTables> getSampleRateTables(double dsamplerate_os);
+
+/*
+ * The results of scanning the patch, wavetable and FX preset folders, shared between every
+ * instance which uses the same data and user folders. An instance which finds a snapshot
+ * here copies it rather than walking the filesystem, and any instance which rescans
+ * publishes its result for instances created after it. Instances that already exist keep
+ * what they have, which is no different from before. Each snapshot carries the folders it
+ * was scanned from, and one whose folders have changed since isn't adopted.
+ *
+ * The copies stay per instance since patch_list and friends are edited in place (favorites,
+ * for instance). That costs the memory but keeps the scan out of instance construction.
+ */
+struct PatchIndex
+{
+    std::vector<Patch> patch_list;
+    std::vector<PatchCategory> patch_category;
+    int firstThirdPartyCategory{0}, firstUserCategory{0};
+    std::vector<int> patchOrdering, patchCategoryOrdering;
+    std::array<std::array<int, 128>, 128> patchIdToMidiBankAndProgram;
+    ScannedFolders folders;
+};
+
+struct WavetableIndex
+{
+    std::vector<Patch> wt_list;
+    std::vector<PatchCategory> wt_category;
+    int firstThirdPartyWTCategory{0}, firstUserWTCategory{0};
+    std::vector<int> wtOrdering, wtCategoryOrdering;
+    ScannedFolders folders;
+};
+
+struct FxPresetIndex
+{
+    std::unordered_map<int, std::vector<FxUserPreset::Preset>> scannedPresets;
+    ScannedFolders folders;
+};
+
+struct ContentIndex
+{
+    // one per distinct set of folders; the key is built by SurgeStorage from its paths
+    static std::shared_ptr<ContentIndex> forFolders(const std::string &key);
+
+    std::shared_ptr<const PatchIndex> getPatches() const;
+    std::shared_ptr<const WavetableIndex> getWavetables() const;
+    std::shared_ptr<const FxPresetIndex> getFxPresets() const;
+
+    void setPatches(std::shared_ptr<const PatchIndex> p);
+    void setWavetables(std::shared_ptr<const WavetableIndex> w);
+    void setFxPresets(std::shared_ptr<const FxPresetIndex> f);
+
+  private:
+    mutable std::mutex m;
+    std::shared_ptr<const PatchIndex> patches;
+    std::shared_ptr<const WavetableIndex> wavetables;
+    std::shared_ptr<const FxPresetIndex> fxPresets;
+};
+
+/*
+ * Directory listings for the patch and wavetable scans, kept on disk between sessions and
+ * shared by every instance in the process which persists to the same file.
+ *
+ * A listing is trusted for as long as its directory's modification time is unchanged, since
+ * adding, removing or renaming an entry touches that. A directory whose contents changed has
+ * a new time and so only it is listed again; its unchanged siblings and children are not.
+ * Listings taken within a couple of seconds of the directory changing aren't trusted, since
+ * a coarse filesystem clock could hide a second change in the same tick.
+ *
+ * Each file's time and size are kept with its name, so the patch database can tell which
+ * patches changed without touching them. Rewriting a file in place doesn't touch its
+ * directory though, so whoever does that (saving over a patch, say) must forget() the
+ * directory for the new stats to be seen.
+ */
+struct DirectoryScanCache
+{
+    struct File
+    {
+        std::string name;
+        // seconds since the epoch as in Patch::lastModTime, or -1 if the file couldn't be read
+        int64_t lastModTime{-1};
+        uint64_t fileSize{0};
+    };
+
+    struct Listing
+    {
+        int64_t mtime{0}, scannedAt{0};
+        std::vector<std::string> subdirs;
+        std::vector<File> files;
+    };
+
+    static std::shared_ptr<DirectoryScanCache> forFile(const fs::path &cacheFile);
+
+    // may throw fs::filesystem_error, as a directory_iterator would
+    Listing list(const fs::path &dir);
+    static Listing listUncached(const fs::path &dir);
+
+    // drops the listing of dir, or of everything, so the next list() reads it again
+    void forget(const fs::path &dir);
+    void clear();
+
+    // writes the cache out if anything was listed since it was read
+    void save();
+
+  private:
+    explicit DirectoryScanCache(const fs::path &cacheFile);
+
+    void read();
+
+    fs::path cacheFile;
+    std::mutex m;
+    std::unordered_map<std::string, Listing> listings;
+    bool dirty{false};
+};
+} // namespace Storage
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_SHAREDSTORAGE_H
@@ -0,0 +1,100 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_SNAPSHOTPUBLISHER_H
+#define SURGE_SRC_COMMON_SNAPSHOTPUBLISHER_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace Surge
+{
+namespace Threading
+{
+/*
+ * Hands immutable snapshots of some state from editing threads to a single reader (the
+ * audio thread) without the reader ever taking a lock.
+ *
+ * Writers build a complete new T and publish it. The reader calls acquire() once per block
+ * and may use what it got until its next acquire(). Each superseded snapshot is freed by a
+ * later publish(), on the writer's thread, once the reader is provably no longer looking at
+ * it, so the reader never allocates or frees either.
+ *
+ * The reader announces what it holds through a single hazard pointer, and re-checks that the
+ * snapshot is still current after announcing it. A writer which swapped the snapshot out
+ * before seeing the announcement is thus guaranteed the reader will notice and retry, so a
+ * writer never frees something the reader is about to use.
+ *
+ * Writers must be serialised by the caller.
+ */
+template <typename T> struct SnapshotPublisher
+{
+    SnapshotPublisher() = default;
+    SnapshotPublisher(const SnapshotPublisher &) = delete;
+    SnapshotPublisher &operator=(const SnapshotPublisher &) = delete;
+
+    ~SnapshotPublisher() { delete published.load(); }
+
+    void publish(std::unique_ptr<T> next)
+    {
+        auto prior = published.exchange(next.release());
+
+        if (prior)
+        {
+            retired.emplace_back(prior);
+        }
+
+        auto held = hazard.load();
+
+        for (auto it = retired.begin(); it != retired.end();)
+        {
+            if (it->get() == held)
+                ++it;
+            else
+                it = retired.erase(it);
+        }
+    }
+
+    // reader thread only
+    const T *acquire()
+    {
+        T *p;
+
+        do
+        {
+            p = published.load();
+            hazard.store(p);
+        } while (published.load() != p);
+
+        return p;
+    }
+
+  private:
+    std::atomic<T *> published{nullptr};
+    std::atomic<T *> hazard{nullptr};
+    std::vector<std::unique_ptr<T>> retired;
+};
+} // namespace Threading
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_SNAPSHOTPUBLISHER_H
@@ -0,0 +1,118 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "StageProfiler.h"
+#include "SurgeStorage.h"
+
+namespace Surge
+{
+namespace Profiling
+{
+static_assert(n_scenes == 2, "Profiler stages assume two scenes");
+static_assert(ps_output - ps_fx_slot_first == n_fx_slots, "Profiler needs a stage per FX slot");
+
+const char *stageName(Stage s)
+{
+    switch (s)
+    {
+    case ps_block:
+        return "block";
+    case ps_process_control:
+        return "process_control";
+    case ps_scene_voices_a:
+        return "scene/a/voices";
+    case ps_scene_voices_b:
+        return "scene/b/voices";
+    case ps_scene_filterblock_a:
+        return "scene/a/filterblock";
+    case ps_scene_filterblock_b:
+        return "scene/b/filterblock";
+    case ps_scene_postfilter_a:
+        return "scene/a/postfilter";
+    case ps_scene_postfilter_b:
+        return "scene/b/postfilter";
+    case ps_output:
+        return "output";
+    default:
+        break;
+    }
+
+    if (s >= ps_fx_slot_first && s < ps_output)
+    {
+        return fxslot_shortoscname[s - ps_fx_slot_first].c_str();
+    }
+
+    return "unknown";
+}
+
+double StageStats::percentileNs(double p) const
+{
+    if (count == 0)
+        return 0.0;
+
+    auto target = p * count;
+    uint64_t seen = 0;
+
+    for (int i = 0; i < n_buckets; ++i)
+    {
+        seen += buckets[i];
+
+        if (seen >= target && seen > 0)
+            return (double)(uint64_t(1) << (i + 1));
+    }
+
+    return (double)maxNs;
+}
+
+StageStats StageProfiler::snapshot(Stage s) const noexcept
+{
+    auto &st = stages[s];
+    StageStats res;
+
+    res.count = st.count.load(std::memory_order_relaxed);
+    res.totalNs = st.totalNs.load(std::memory_order_relaxed);
+    res.maxNs = st.maxNs.load(std::memory_order_relaxed);
+
+    for (int i = 0; i < StageStats::n_buckets; ++i)
+    {
+        res.buckets[i] = st.buckets[i].load(std::memory_order_relaxed);
+    }
+
+    return res;
+}
+
+void StageProfiler::reset() noexcept
+{
+    for (auto &st : stages)
+    {
+        st.count.store(0, std::memory_order_relaxed);
+        st.totalNs.store(0, std::memory_order_relaxed);
+        st.maxNs.store(0, std::memory_order_relaxed);
+
+        for (auto &b : st.buckets)
+        {
+            b.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+} // namespace Profiling
+} // namespace Surge
@@ -0,0 +1,160 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_STAGEPROFILER_H
+#define SURGE_SRC_COMMON_STAGEPROFILER_H
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+
+/*
+ * Build with SURGE_BUILD_STAGE_PROFILER=ON (which defines SURGE_STAGE_PROFILER=1 for
+ * surge-common and everything linking it) to time the stages of SurgeSynthesizer::process().
+ * Otherwise SURGE_PROFILE_STAGE expands to nothing and the engine carries no timing code at all.
+ */
+#ifndef SURGE_STAGE_PROFILER
+#define SURGE_STAGE_PROFILER 0
+#endif
+
+namespace Surge
+{
+namespace Profiling
+{
+/*
+ * The stages of one engine block. Scene stages are laid out A then B, and FX stages follow the
+ * fxslot_ enum, so use sceneStage() and fxStage() rather than doing the arithmetic by hand.
+ */
+enum Stage
+{
+    ps_block = 0, // all of process()
+    ps_process_control,
+    ps_scene_voices_a,
+    ps_scene_voices_b,
+    ps_scene_filterblock_a,
+    ps_scene_filterblock_b,
+    ps_scene_postfilter_a, // hardclip, halfband and lowcut
+    ps_scene_postfilter_b,
+    ps_fx_slot_first,
+    ps_output = ps_fx_slot_first + 16, // master volume, VU, hardclip, scope
+    n_profile_stages
+};
+
+inline Stage sceneStage(Stage sceneAStage, int scene) { return (Stage)(sceneAStage + scene); }
+inline Stage fxStage(int fxslot) { return (Stage)(ps_fx_slot_first + fxslot); }
+
+const char *stageName(Stage s);
+
+/*
+ * A copy of one stage's histogram. Bucket i counts blocks which took [2^i, 2^(i+1)) ns,
+ * with bucket 0 also holding anything under a nanosecond.
+ */
+struct StageStats
+{
+    static constexpr int n_buckets = 32;
+
+    uint64_t count{0};
+    uint64_t totalNs{0};
+    uint64_t maxNs{0};
+    std::array<uint64_t, n_buckets> buckets{};
+
+    double meanNs() const { return count ? (double)totalNs / count : 0.0; }
+
+    // the upper edge of the bucket holding the p-th percentile, so an upper bound within 2x
+    double percentileNs(double p) const;
+};
+
+/*
+ * Lock free, allocation free per stage timing histograms.
+ *
+ * Each stage is only ever written by the one thread rendering it (scene stages may be on a
+ * SceneRenderPool worker), and readers on any thread just load the counters, so a snapshot
+ * taken mid block can be a block out of step between fields but never torn within one.
+ * reset() can be called from any thread; a block recorded concurrently may land either side.
+ */
+class StageProfiler
+{
+  public:
+    static constexpr bool compiledIn = SURGE_STAGE_PROFILER;
+
+    void record(Stage s, uint64_t ns) noexcept
+    {
+        auto &st = stages[s];
+        st.count.fetch_add(1, std::memory_order_relaxed);
+        st.totalNs.fetch_add(ns, std::memory_order_relaxed);
+        if (ns > st.maxNs.load(std::memory_order_relaxed))
+            st.maxNs.store(ns, std::memory_order_relaxed);
+        st.buckets[bucketFor(ns)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    StageStats snapshot(Stage s) const noexcept;
+    void reset() noexcept;
+
+    static int bucketFor(uint64_t ns) noexcept
+    {
+        int b = (int)std::bit_width(ns) - 1;
+        return b < 0 ? 0 : (b >= StageStats::n_buckets ? StageStats::n_buckets - 1 : b);
+    }
+
+  private:
+    struct alignas(64) PerStage
+    {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> totalNs{0};
+        std::atomic<uint64_t> maxNs{0};
+        std::array<std::atomic<uint64_t>, StageStats::n_buckets> buckets{};
+    };
+
+    std::array<PerStage, n_profile_stages> stages;
+};
+
+struct ScopedStageTimer
+{
+    using clock = std::chrono::steady_clock;
+
+    ScopedStageTimer(StageProfiler &p, Stage s) : profiler(p), stage(s), start(clock::now()) {}
+    ~ScopedStageTimer()
+    {
+        auto d = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start);
+        profiler.record(stage, (uint64_t)d.count());
+    }
+
+    StageProfiler &profiler;
+    Stage stage;
+    clock::time_point start;
+};
+} // namespace Profiling
+} // namespace Surge
+
+#if SURGE_STAGE_PROFILER
+#define SURGE_PROFILE_STAGE_CAT2(a, b) a##b
+#define SURGE_PROFILE_STAGE_CAT(a, b) SURGE_PROFILE_STAGE_CAT2(a, b)
+#define SURGE_PROFILE_STAGE(profiler, stage)                                                       \
+    Surge::Profiling::ScopedStageTimer SURGE_PROFILE_STAGE_CAT(stageTimer, __LINE__)(profiler,     \
+                                                                                     stage)
+#else
+#define SURGE_PROFILE_STAGE(profiler, stage)
+#endif
+
+#endif // SURGE_SRC_COMMON_STAGEPROFILER_H
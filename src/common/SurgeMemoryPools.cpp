@@ -0,0 +1,132 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "SurgeMemoryPools.h"
+
+#include <chrono>
+
+namespace Surge
+{
+namespace Memory
+{
+SurgeMemoryPools::SurgeMemoryPools(SurgeStorage *s)
+    : stringDelayLinesSmall(s->sinctable), stringDelayLinesMedium(s->sinctable),
+      stringDelayLines(s->sinctable), twistEngines(s->dsamplerate_os)
+{
+    auto wake = [this]() { wakeRefiller(); };
+
+    // a couple of voices' worth in hand, and build a few more at a time once they go
+    stringDelayLinesSmall.enableBackgroundRefill(4, 16, wake, s->sinctable);
+    stringDelayLinesMedium.enableBackgroundRefill(4, 16, wake, s->sinctable);
+    stringDelayLines.enableBackgroundRefill(2, 8, wake, s->sinctable);
+    // engines are reset to the current rate when they are taken, so the rate here doesn't matter
+    twistEngines.enableBackgroundRefill(2, 6, wake, s->dsamplerate_os);
+
+    refiller = std::thread(&SurgeMemoryPools::refillLoop, this);
+}
+
+SurgeMemoryPools::~SurgeMemoryPools()
+{
+    {
+        std::lock_guard<std::mutex> g(m);
+        keepRunning = false;
+    }
+    cv.notify_one();
+    idleCv.notify_all();
+
+    if (refiller.joinable())
+        refiller.join();
+}
+
+void SurgeMemoryPools::setNeverAllocate(bool b)
+{
+    stringDelayLinesSmall.setNeverAllocate(b);
+    stringDelayLinesMedium.setNeverAllocate(b);
+    stringDelayLines.setNeverAllocate(b);
+    twistEngines.setNeverAllocate(b);
+}
+
+std::array<SurgeMemoryPools::PoolStats, SurgeMemoryPools::n_pools>
+SurgeMemoryPools::getPoolStats() const
+{
+    auto st = [](const char *n, const auto &p) {
+        return PoolStats{n, p.misses.load(std::memory_order_relaxed),
+                         p.built.load(std::memory_order_relaxed)};
+    };
+
+    return {st("String Delay Lines (Small)", stringDelayLinesSmall),
+            st("String Delay Lines (Medium)", stringDelayLinesMedium),
+            st("String Delay Lines (Large)", stringDelayLines),
+            st("Twist Engines", twistEngines)};
+}
+
+void SurgeMemoryPools::waitForRefills()
+{
+    std::unique_lock<std::mutex> lk(m);
+    idleCv.wait(lk, [this]() { return !keepRunning || (!refillerBusy && !refillRequested); });
+}
+
+void SurgeMemoryPools::wakeRefiller()
+{
+    /*
+     * This runs on the audio thread, so it never takes the lock. Without it a wake which lands
+     * between the worker checking the flag and blocking is missed, but the worker wakes on its
+     * own every refillPoll anyway, so that costs at most one poll's delay.
+     */
+    refillRequested.store(true, std::memory_order_release);
+    cv.notify_one();
+}
+
+void SurgeMemoryPools::refillLoop()
+{
+    static constexpr auto refillPoll = std::chrono::milliseconds(20);
+    std::unique_lock<std::mutex> lk(m);
+
+    while (true)
+    {
+        if (!refillRequested.load(std::memory_order_acquire))
+        {
+            refillerBusy = false;
+            idleCv.notify_all();
+            cv.wait_for(lk, refillPoll,
+                        [this]() { return !keepRunning || refillRequested.load(); });
+        }
+
+        if (!keepRunning)
+            break;
+
+        if (!refillRequested.exchange(false, std::memory_order_acq_rel))
+            continue;
+
+        refillerBusy = true;
+        lk.unlock();
+
+        stringDelayLinesSmall.refill();
+        stringDelayLinesMedium.refill();
+        stringDelayLines.refill();
+        twistEngines.refill();
+
+        lk.lock();
+    }
+}
+} // namespace Memory
+} // namespace Surge
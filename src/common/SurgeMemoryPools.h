@@ -26,6 +26,14 @@
 #include "SurgeStorage.h"
 #include "MemoryPool.h"
 #include "SSESincDelayLine.h"
+#include "StringOscillator.h"
+#include "TwistOscillator.h"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace Surge
 {
@@ -33,7 +41,8 @@ namespace Memory
 {
 struct SurgeMemoryPools
 {
-    SurgeMemoryPools(SurgeStorage *s) : stringDelayLines(s->sinctable) {}
+    explicit SurgeMemoryPools(SurgeStorage *s);
+    ~SurgeMemoryPools();
 
     /*
      * The largest number of oscillator instances of a particular
@@ -42,14 +51,52 @@ struct SurgeMemoryPools
     static constexpr int maxosc = n_scenes * n_oscs * (MAX_VOICES + 8);
 
     /*
-     * The string needs 2 delay lines per oscillator
+     * The string needs 2 delay lines per oscillator, in one of its delay line sizes
      */
-    MemoryPool<SSESincDelayLine<16384>, 8, 4, 2 * maxosc + 100> stringDelayLines;
+    MemoryPool<StringOscillator::delayLine_t<0>, 8, 4, 2 * maxosc + 100> stringDelayLinesSmall;
+    MemoryPool<StringOscillator::delayLine_t<1>, 8, 4, 2 * maxosc + 100> stringDelayLinesMedium;
+    MemoryPool<StringOscillator::delayLine_t<2>, 4, 4, 2 * maxosc + 100> stringDelayLines;
+
+    template <int tier> auto &stringDelayLinePool()
+    {
+        if constexpr (tier == 0)
+            return stringDelayLinesSmall;
+        else if constexpr (tier == 1)
+            return stringDelayLinesMedium;
+        else
+            return stringDelayLines;
+    }
+
+    /*
+     * The twist needs one engine per oscillator, and they are big, so grow slowly
+     */
+    MemoryPool<TwistOscillator::Engine, 1, 2, maxosc + 100> twistEngines;
+
+    /*
+     * Both pools are topped up by a worker thread as voices drain them, so a run of notes
+     * past what the patch load sized them for normally still finds items waiting. With
+     * neverAllocate, a voice which finds its pool empty anyway plays silence rather than
+     * allocating on the audio thread.
+     */
+    void setNeverAllocate(bool b);
+
+    // how often each pool ran dry, and how much the worker built; safe from any thread
+    struct PoolStats
+    {
+        const char *name;
+        uint64_t misses, built;
+    };
+    static constexpr int n_pools = 4;
+    std::array<PoolStats, n_pools> getPoolStats() const;
+
+    // blocks until the worker has nothing left to build or delete; for tests
+    void waitForRefills();
+
     void resetAllPools(SurgeStorage *storage) { resetOscillatorPools(storage); }
     void resetOscillatorPools(SurgeStorage *storage)
     {
         bool hasString{false}, hasTwist{false};
-        int nString{0};
+        int nString{0}, nTwist{0};
         for (int s = 0; s < n_scenes; ++s)
         {
             for (int os = 0; os < n_oscs; ++os)
@@ -61,20 +108,54 @@ struct SurgeMemoryPools
                     hasString = true;
                     nString++;
                 }
-                hasTwist |= (ot == ot_twist);
+
+                if (ot == ot_twist)
+                {
+                    hasTwist = true;
+                    nTwist++;
+                }
             }
         }
 
         if (hasString)
         {
+            /*
+             * Most notes fit the small lines, and the big ones are only needed for the bottom
+             * couple of octaves or FM, so hold less of those. The refill makes up the rest.
+             */
             int maxUsed = nString * 2 * storage->getPatch().polylimit.val.i;
-            stringDelayLines.setupPoolToSize((int)(maxUsed * 0.5), storage->sinctable);
+            stringDelayLinesSmall.reserve((int)(maxUsed * 0.5));
+            stringDelayLinesMedium.reserve((int)(maxUsed * 0.25));
+            stringDelayLines.reserve((int)(maxUsed * 0.25));
         }
         else
         {
-            stringDelayLines.returnToPreAllocSize();
+            stringDelayLinesSmall.release();
+            stringDelayLinesMedium.release();
+            stringDelayLines.release();
+        }
+
+        if (hasTwist)
+        {
+            // every voice can hold one at once, so a fast arpeggio never has to build any
+            int maxUsed = nTwist * storage->getPatch().polylimit.val.i;
+            twistEngines.reserve(maxUsed);
+        }
+        else
+        {
+            twistEngines.release();
         }
     }
+
+  private:
+    void wakeRefiller();
+    void refillLoop();
+
+    std::mutex m;
+    std::condition_variable cv, idleCv;
+    std::atomic<bool> refillRequested{false};
+    bool keepRunning{true}, refillerBusy{true};
+    std::thread refiller;
 };
 
 } // namespace Memory
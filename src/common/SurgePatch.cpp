@@ -658,6 +658,7 @@ SurgePatch::SurgePatch(SurgeStorage *storage)
     scene_size = scene_start[1] - scene_start[0];
     assert(scene_size == n_scene_params);
     assert(globparams_promise->value == n_global_params);
+    buildParameterValueSources();
     init_default_values();
     update_controls(true);
 
@@ -985,18 +986,43 @@ void SurgePatch::init_default_values()
 
 SurgePatch::~SurgePatch() { free(patchptr); }
 
-void SurgePatch::copy_scenedata(pdata *d, pdata *dUnmod, int scene)
+void SurgePatch::buildParameterValueSources()
 {
+    for (int sc = 0; sc < n_scenes; ++sc)
+    {
+        int s = scene_start[sc];
+        nSceneOscParams[sc] = 0;
+
+        for (int i = 0; i < n_scene_params; i++)
+        {
+            sceneValueSource[sc][i] = &param_ptr[i + s]->val;
 
+            if (param_ptr[i + s]->ctrlgroup == cg_OSC)
+                sceneOscParams[sc][nSceneOscParams[sc]++] = i;
+        }
+    }
+
+    for (int i = 0; i < n_global_params; i++)
+    {
+        globalValueSource[i] = &param_ptr[i]->val;
+    }
+}
+
+void SurgePatch::copy_scenedata(pdata *d, pdata *dUnmod, int scene)
+{
     int s = scene_start[scene];
+    const pdata *const *src = sceneValueSource[scene];
+
     for (int i = 0; i < n_scene_params; i++)
     {
-        // if (param_ptr[i+s]->valtype == vt_float)
-        // d[i].f = param_ptr[i+s]->val.f;
-        d[i].i = param_ptr[i + s]->val.i;
+        d[i].i = src[i]->i;
+    }
 
-        if (param_ptr[i + s]->ctrlgroup == cg_OSC)
-            dUnmod[i].f = d[i].f;
+    const int16_t *osc = sceneOscParams[scene];
+
+    for (int k = 0; k < nSceneOscParams[scene]; k++)
+    {
+        dUnmod[osc[k]].f = d[osc[k]].f;
     }
 
     for (int i = 0; i < paramModulationCount; ++i)
@@ -1031,8 +1057,7 @@ void SurgePatch::copy_globaldata(pdata *d)
 {
     for (int i = 0; i < n_global_params; i++)
     {
-        // if (param_ptr[i]->valtype == vt_float)
-        d[i].i = param_ptr[i]->val.i; // int is safer (no exceptions or anything)
+        d[i].i = globalValueSource[i]->i; // int is safer (no exceptions or anything)
     }
 
     for (int i = 0; i < paramModulationCount; ++i)
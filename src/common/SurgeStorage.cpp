@@ -50,6 +50,8 @@
 #include "FxPresetAndClipboardManager.h"
 #include "ModulatorPresetManager.h"
 #include "SurgeMemoryPools.h"
+#include "WavetableBuildService.h"
+#include "SharedStorage.h"
 #include "sst/basic-blocks/tables/SincTableProvider.h"
 
 // FIXME probably remove this when we remove the hardcoded hack below
@@ -64,6 +66,10 @@ using namespace std;
 
 std::string SurgeStorage::skipPatchLoadDataPathSentinel = "<SKIP-PATCH-SENTINEL>";
 
+#if STORAGE_USES_INDEPENDENT_RNG
+thread_local SurgeStorage::RNGGen *SurgeStorage::threadRNGOverride{nullptr};
+#endif
+
 SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : otherscene_clients(0)
 {
     auto suppliedDataPath = config.suppliedDataPath;
@@ -74,6 +80,15 @@ SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : oth
     if (suppliedDataPath == skipPatchLoadDataPathSentinel)
         suppliedDataPath = "";
 
+    namespace tabl = sst::basic_blocks::tables;
+    sharedTables = Surge::Storage::getSharedTables();
+    static_assert(tabl::SurgeSincTableProvider::FIRipol_M == FIRipol_M);
+    static_assert(tabl::SurgeSincTableProvider::FIRipol_N == FIRipol_N);
+    static_assert(tabl::SurgeSincTableProvider::FIRipolI16_N == FIRipolI16_N);
+    sinctable = sharedTables->sincTableProvider->sinctable;
+    sinctable1X = sharedTables->sincTableProvider->sinctable1X;
+    sinctableI16 = sharedTables->sincTableProvider->sinctableI16;
+
     if (samplerate == 0)
     {
         setSamplerate(48000);
@@ -93,15 +108,8 @@ SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : oth
     }
 
     _patch.reset(new SurgePatch(this));
-
-    namespace tabl = sst::basic_blocks::tables;
-    sincTableProvider = std::make_unique<tabl::SurgeSincTableProvider>();
-    static_assert(tabl::SurgeSincTableProvider::FIRipol_M == FIRipol_M);
-    static_assert(tabl::SurgeSincTableProvider::FIRipol_N == FIRipol_N);
-    static_assert(tabl::SurgeSincTableProvider::FIRipolI16_N == FIRipolI16_N);
-    sinctable = sincTableProvider->sinctable;
-    sinctable1X = sincTableProvider->sinctable1X;
-    sinctableI16 = sincTableProvider->sinctableI16;
+    publishModulationRoutings();
+    acquireModulationRoutings();
 
     for (int s = 0; s < n_scenes; s++)
         for (int m = 0; m < n_modsources; ++m)
@@ -385,6 +393,11 @@ SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : oth
     extraThirdPartyWavetablesPath = config.extraThirdPartyWavetablesPath;
     extraUserWavetablesPath = config.extraUsersWavetablesPath;
 
+    sharedContent = Surge::Storage::ContentIndex::forFolders(
+        datapath.u8string() + "\n" + userDataPath.u8string() + "\n" +
+        extraThirdPartyWavetablesPath.u8string() + "\n" + extraUserWavetablesPath.u8string());
+    scanCache = Surge::Storage::DirectoryScanCache::forFile(userDataPath / "SurgeFolderScan.cache");
+
     if (config.createUserDirectory)
     {
         createUserDirectory();
@@ -425,8 +438,11 @@ SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : oth
     patchDB = std::make_unique<Surge::PatchStorage::PatchDB>(this);
     if (loadWtAndPatch)
     {
-        refresh_wtlist();
-        refresh_patchlist();
+        // if another instance already scanned these folders, copying its scan is much quicker
+        if (!adoptSharedWtlist())
+            refresh_wtlist();
+        if (!adoptSharedPatchlist())
+            refresh_patchlist();
     }
 
 #if HAS_JUCE
@@ -604,7 +620,8 @@ SurgeStorage::SurgeStorage(const SurgeStorage::SurgeStorageConfig &config) : oth
     try
     {
         fxUserPreset = std::make_unique<Surge::Storage::FxUserPreset>();
-        fxUserPreset->doPresetRescan(this);
+        if (!adoptSharedFxPresets())
+            fxUserPreset->doPresetRescan(this);
     }
     catch (fs::filesystem_error &e)
     {
@@ -692,21 +709,25 @@ void SurgeStorage::initializePatchDb(bool force)
     // read, even though our next activity is a read
     patchDB->prepareForWrites();
 
-    auto awid = patchDB->readAllPatchPathsWithIdAndModTime();
+    // patches whose time and size both match what we indexed last time aren't read again
+    auto awid = patchDB->readAllPatchPathsWithIdModTimeAndSize();
     std::vector<Patch> addThese;
     for (const auto p : patch_list)
     {
-        if (awid.find(p.path.u8string()) == awid.end())
+        auto known = awid.find(p.path.u8string());
+
+        if (known == awid.end())
         {
             addThese.push_back(p);
         }
         else
         {
-            if (awid[p.path.u8string()].second < p.lastModTime)
+            if ((uint64_t)known->second.lastWriteTime != p.lastModTime ||
+                (uint64_t)known->second.fileSize != p.fileSize)
             {
                 addThese.push_back(p);
             }
-            awid.erase(p.path.u8string());
+            awid.erase(known);
         }
     }
 
@@ -753,12 +774,34 @@ void SurgeStorage::initializePatchDb(bool force)
 
     for (auto q : awid)
     {
-        patchDB->erasePatchByID(q.second.first);
+        patchDB->erasePatchByID(q.second.id);
     }
 }
 
 SurgePatch &SurgeStorage::getPatch() const { return *_patch.get(); }
 
+int64_t ScannedFolders::timeOf(const fs::path &dir)
+{
+    std::error_code ec;
+
+    if (!fs::is_directory(dir, ec))
+        return -1;
+
+    auto t = fs::last_write_time(dir, ec);
+    return ec ? -1 : t.time_since_epoch().count();
+}
+
+bool ScannedFolders::unchanged() const
+{
+    for (const auto &[dir, mtime] : folders)
+    {
+        if (timeOf(dir) != mtime)
+            return false;
+    }
+
+    return true;
+}
+
 struct PEComparer
 {
     bool operator()(const Patch &a, const Patch &b) { return a.name.compare(b.name) < 0; }
@@ -768,6 +811,7 @@ void SurgeStorage::refresh_patchlist()
 {
     patch_category.clear();
     patch_list.clear();
+    patchFolders = ScannedFolders();
 
     refreshPatchlistAddDir(false, "patches_factory");
     firstThirdPartyCategory = patch_category.size();
@@ -810,59 +854,7 @@ void SurgeStorage::refresh_patchlist()
         patch_category[patchCategoryOrdering[i]].order = i;
     }
 
-    auto favorites = patchDB->readUserFavorites();
-    auto pathToTrunc = [](const std::string &s) -> std::string {
-        auto pf = s.find("patches_factory");
-        auto p3 = s.find("patches_3rdparty");
-
-        if (pf != std::string::npos)
-        {
-            return s.substr(pf);
-        }
-        if (p3 != std::string::npos)
-        {
-            return s.substr(p3);
-        }
-        return "";
-    };
-    std::unordered_set<std::string> favSet, favTruncSet;
-    for (auto f : favorites)
-    {
-        favSet.insert(f);
-        auto pf = pathToTrunc(f);
-        if (!pf.empty())
-        {
-            favTruncSet.insert(pf);
-        }
-    }
-    for (auto &p : patch_list)
-    {
-        try
-        {
-            auto qtime = fs::last_write_time(p.path);
-            p.lastModTime =
-                std::chrono::duration_cast<std::chrono::seconds>(qtime.time_since_epoch()).count();
-        }
-        catch (const fs::filesystem_error &e)
-        {
-            std::ostringstream erross;
-            erross << "Unable to determine the modification time of '" << p.path.u8string() << ". "
-                   << "This usually means the file can't be opened, or is a broken symlink, or "
-                      "some such. Underlying error: "
-                   << e.what();
-            reportError(erross.str(), "Unable to Read File Time");
-            p.lastModTime = 0;
-        }
-        auto ps = p.path.u8string();
-        auto pf = pathToTrunc(ps);
-
-        if (favSet.find(ps) != favSet.end())
-            p.isFavorite = true;
-        else if (!pf.empty() && (favTruncSet.find(pf) != favTruncSet.end()))
-            p.isFavorite = true;
-        else
-            p.isFavorite = false;
-    }
+    applyPatchFavorites();
 
     /*
      * Update midi program change here
@@ -939,6 +931,87 @@ void SurgeStorage::refresh_patchlist()
      *   }
      * }
      */
+
+    if (sharedContent)
+    {
+        auto idx = std::make_shared<Surge::Storage::PatchIndex>();
+        idx->patch_list = patch_list;
+        idx->patch_category = patch_category;
+        idx->firstThirdPartyCategory = firstThirdPartyCategory;
+        idx->firstUserCategory = firstUserCategory;
+        idx->patchOrdering = patchOrdering;
+        idx->patchCategoryOrdering = patchCategoryOrdering;
+        idx->patchIdToMidiBankAndProgram = patchIdToMidiBankAndProgram;
+        idx->folders = patchFolders;
+        sharedContent->setPatches(idx);
+    }
+
+    if (scanCache)
+        scanCache->save();
+}
+
+void SurgeStorage::applyPatchFavorites()
+{
+    auto favorites = patchDB->readUserFavorites();
+    auto pathToTrunc = [](const std::string &s) -> std::string {
+        auto pf = s.find("patches_factory");
+        auto p3 = s.find("patches_3rdparty");
+
+        if (pf != std::string::npos)
+        {
+            return s.substr(pf);
+        }
+        if (p3 != std::string::npos)
+        {
+            return s.substr(p3);
+        }
+        return "";
+    };
+    std::unordered_set<std::string> favSet, favTruncSet;
+    for (auto f : favorites)
+    {
+        favSet.insert(f);
+        auto pf = pathToTrunc(f);
+        if (!pf.empty())
+        {
+            favTruncSet.insert(pf);
+        }
+    }
+    for (auto &p : patch_list)
+    {
+        auto ps = p.path.u8string();
+        auto pf = pathToTrunc(ps);
+
+        if (favSet.find(ps) != favSet.end())
+            p.isFavorite = true;
+        else if (!pf.empty() && (favTruncSet.find(pf) != favTruncSet.end()))
+            p.isFavorite = true;
+        else
+            p.isFavorite = false;
+    }
+}
+
+bool SurgeStorage::adoptSharedPatchlist()
+{
+    auto idx = sharedContent ? sharedContent->getPatches() : nullptr;
+
+    // a scan whose folders changed since is stale, so take a fresh one instead
+    if (!idx || !idx->folders.unchanged())
+        return false;
+
+    patch_list = idx->patch_list;
+    patch_category = idx->patch_category;
+    firstThirdPartyCategory = idx->firstThirdPartyCategory;
+    firstUserCategory = idx->firstUserCategory;
+    patchOrdering = idx->patchOrdering;
+    patchCategoryOrdering = idx->patchCategoryOrdering;
+    patchIdToMidiBankAndProgram = idx->patchIdToMidiBankAndProgram;
+    patchFolders = idx->folders;
+
+    // favorites change without a rescan, so always take them from the database
+    applyPatchFavorites();
+
+    return true;
 }
 
 void SurgeStorage::refreshPatchlistAddDir(bool userDir, string subdir)
@@ -946,14 +1019,15 @@ void SurgeStorage::refreshPatchlistAddDir(bool userDir, string subdir)
     refreshPatchOrWTListAddDir(
         userDir, userDir ? userDataPath : datapath, subdir,
         [](std::string s) -> bool { return _stricmp(s.c_str(), ".fxp") == 0; }, patch_list,
-        patch_category);
+        patch_category, patchFolders);
 }
 
 void SurgeStorage::refreshPatchOrWTListAddDir(bool userDir, const fs::path &initialPatchPath,
                                               string subdir,
                                               std::function<bool(std::string)> filterOp,
                                               std::vector<Patch> &items,
-                                              std::vector<PatchCategory> &categories)
+                                              std::vector<PatchCategory> &categories,
+                                              ScannedFolders &folders)
 {
     int category = categories.size();
 
@@ -968,6 +1042,7 @@ void SurgeStorage::refreshPatchOrWTListAddDir(bool userDir, const fs::path &init
 
         if (!fs::is_directory(patchpath))
         {
+            folders.add(patchpath, -1);
             return;
         }
 
@@ -976,24 +1051,34 @@ void SurgeStorage::refreshPatchOrWTListAddDir(bool userDir, const fs::path &init
         ** hand rolled ipmmlementation on mac, experimental on windows, and
         ** ostensibly standard on linux it isn't consistent enough to warrant
         ** using yet, so build my own recursive directory traversal with a simple
-        ** stack
+        ** stack. The listings come from the scan cache where there is one, so
+        ** only directories which changed since the last scan are read again.
         */
-        std::vector<fs::path> alldirs;
+        auto listDir = [this, &folders](const fs::path &p) {
+            auto res = scanCache ? scanCache->list(p)
+                                 : Surge::Storage::DirectoryScanCache::listUncached(p);
+            folders.add(p, res.mtime);
+            return res;
+        };
+
+        std::vector<std::pair<fs::path, std::vector<Surge::Storage::DirectoryScanCache::File>>>
+            alldirs;
+        std::deque<std::pair<fs::path, std::vector<std::string>>> workStack;
+
+        auto rootListing = listDir(patchpath);
         if (userDir)
-            alldirs.push_back(patchpath);
-        std::deque<fs::path> workStack;
-        workStack.push_back(patchpath);
+            alldirs.emplace_back(patchpath, rootListing.files);
+        workStack.emplace_back(patchpath, std::move(rootListing.subdirs));
         while (!workStack.empty())
         {
-            auto top = workStack.front();
+            auto top = std::move(workStack.front());
             workStack.pop_front();
-            for (auto &d : fs::directory_iterator(top))
+            for (auto &sd : top.second)
             {
-                if (fs::is_directory(d))
-                {
-                    alldirs.push_back(d);
-                    workStack.push_back(d);
-                }
+                auto d = top.first / string_to_path(sd);
+                auto listing = listDir(d);
+                alldirs.emplace_back(d, std::move(listing.files));
+                workStack.emplace_back(d, std::move(listing.subdirs));
             }
         }
 
@@ -1006,7 +1091,7 @@ void SurgeStorage::refreshPatchOrWTListAddDir(bool userDir, const fs::path &init
         if (patchpathStr.back() == '/' || patchpathStr.back() == '\\')
             patchpathSubstrLength--;
 
-        for (auto &p : alldirs)
+        for (auto &[p, files] : alldirs)
         {
             PatchCategory c;
             auto name = std::string("Unsorted");
@@ -1019,16 +1104,36 @@ void SurgeStorage::refreshPatchOrWTListAddDir(bool userDir, const fs::path &init
             c.isFactory = !userDir;
 
             c.numberOfPatchesInCategory = 0;
-            for (auto &f : fs::directory_iterator(p))
+            for (auto &fn : files)
             {
-                std::string xtn = path_to_string(f.path().extension());
+                auto f = p / string_to_path(fn.name);
+                std::string xtn = path_to_string(f.extension());
                 if (filterOp(xtn))
                 {
                     Patch e;
                     e.category = category;
-                    e.path = f.path();
-                    e.name = path_to_string(f.path().filename());
+                    e.path = f;
+                    e.name = fn.name;
                     e.name = e.name.substr(0, e.name.size() - xtn.length());
+
+                    // the listing has the stats already, so the patch DB needn't stat again
+                    if (fn.lastModTime >= 0)
+                    {
+                        e.lastModTime = fn.lastModTime;
+                        e.fileSize = fn.fileSize;
+                    }
+                    else
+                    {
+                        std::ostringstream erross;
+                        erross << "Unable to determine the modification time of '"
+                               << f.u8string() << ". "
+                               << "This usually means the file can't be opened, or is a broken "
+                                  "symlink, or some such.";
+                        reportError(erross.str(), "Unable to Read File Time");
+                        e.lastModTime = 0;
+                        e.fileSize = 0;
+                    }
+
                     items.push_back(e);
 
                     c.numberOfPatchesInCategory++;
@@ -1130,6 +1235,7 @@ void SurgeStorage::refresh_wtlist()
 {
     wt_category.clear();
     wt_list.clear();
+    wtFolders = ScannedFolders();
 
     refresh_wtlistAddDir(false, "wavetables");
 
@@ -1137,6 +1243,10 @@ void SurgeStorage::refresh_wtlist()
     if (extraThirdPartyWavetablesPath.empty() ||
         !fs::is_directory(extraThirdPartyWavetablesPath / "wavetables_3rdparty"))
     {
+        // which folder we read depends on this one existing, so it counts as scanned
+        if (!extraThirdPartyWavetablesPath.empty())
+            wtFolders.add(extraThirdPartyWavetablesPath / "wavetables_3rdparty");
+
         refresh_wtlistAddDir(false, "wavetables_3rdparty");
     }
     else
@@ -1236,6 +1346,65 @@ void SurgeStorage::refresh_wtlist()
 
     for (int i = 0; i < wt_list.size(); i++)
         wt_list[wtOrdering[i]].order = i;
+
+    if (sharedContent)
+    {
+        auto idx = std::make_shared<Surge::Storage::WavetableIndex>();
+        idx->wt_list = wt_list;
+        idx->wt_category = wt_category;
+        idx->firstThirdPartyWTCategory = firstThirdPartyWTCategory;
+        idx->firstUserWTCategory = firstUserWTCategory;
+        idx->wtOrdering = wtOrdering;
+        idx->wtCategoryOrdering = wtCategoryOrdering;
+        idx->folders = wtFolders;
+        sharedContent->setWavetables(idx);
+    }
+
+    if (scanCache)
+        scanCache->save();
+}
+
+bool SurgeStorage::adoptSharedWtlist()
+{
+    auto idx = sharedContent ? sharedContent->getWavetables() : nullptr;
+
+    if (!idx || !idx->folders.unchanged())
+        return false;
+
+    wt_list = idx->wt_list;
+    wt_category = idx->wt_category;
+    firstThirdPartyWTCategory = idx->firstThirdPartyWTCategory;
+    firstUserWTCategory = idx->firstUserWTCategory;
+    wtOrdering = idx->wtOrdering;
+    wtCategoryOrdering = idx->wtCategoryOrdering;
+    wtFolders = idx->folders;
+
+    return true;
+}
+
+bool SurgeStorage::adoptSharedFxPresets()
+{
+    auto idx = sharedContent ? sharedContent->getFxPresets() : nullptr;
+
+    if (!idx || !fxUserPreset || !idx->folders.unchanged())
+        return false;
+
+    fxUserPreset->scannedPresets = idx->scannedPresets;
+    fxUserPreset->scannedFolders = idx->folders;
+    fxUserPreset->haveScannedPresets = true;
+
+    return true;
+}
+
+void SurgeStorage::publishFxPresets()
+{
+    if (sharedContent && fxUserPreset)
+    {
+        auto idx = std::make_shared<Surge::Storage::FxPresetIndex>();
+        idx->scannedPresets = fxUserPreset->scannedPresets;
+        idx->folders = fxUserPreset->scannedFolders;
+        sharedContent->setFxPresets(idx);
+    }
 }
 
 void SurgeStorage::refresh_wtlistAddDir(bool userDir, const std::string &subdir)
@@ -1262,7 +1431,17 @@ void SurgeStorage::refresh_wtlistFrom(bool isUser, const fs::path &p, const std:
             }
             return false;
         },
-        wt_list, wt_category);
+        wt_list, wt_category, wtFolders);
+}
+
+void SurgeStorage::setBuildWavetablesInBackground(bool b)
+{
+    if (b && !wavetableBuilder)
+    {
+        wavetableBuilder = std::make_unique<Surge::Storage::WavetableBuildService>(this);
+    }
+
+    buildWavetablesInBackground = b;
 }
 
 void SurgeStorage::perform_queued_wtloads()
@@ -1270,10 +1449,48 @@ void SurgeStorage::perform_queued_wtloads()
     SurgePatch &patch =
         getPatch(); // Change here is for performance and ease of debugging, simply not calling
                     // getPatch so many times. Code should behave identically.
+
+    bool inBackground = wavetableBuilder && buildWavetablesInBackground;
+
+    if (inBackground)
+    {
+        wavetableBuilder->collect();
+    }
+
     for (int sc = 0; sc < n_scenes; sc++)
     {
         for (int o = 0; o < n_oscs; o++)
         {
+            if (inBackground)
+            {
+                auto &wt = patch.scene[sc].osc[o].wt;
+
+                if (wt.queue_id != -1)
+                {
+                    if (wavetableBuilder->requestById(sc, o, wt.queue_id))
+                        wt.queue_id = -1;
+                }
+                else if (wt.queue_filename[0])
+                {
+                    if (!(uses_wavetabledata(patch.scene[sc].osc[o].type.val.i)))
+                    {
+                        patch.scene[sc].osc[o].queue_type = ot_wavetable;
+                    }
+
+                    wavetableBuilder->requestByFilename(sc, o, wt.queue_filename);
+                }
+
+                continue;
+            }
+
+            if (wavetableBuilder &&
+                (patch.scene[sc].osc[o].wt.queue_id != -1 ||
+                 patch.scene[sc].osc[o].wt.queue_filename[0]))
+            {
+                // an older background build must not land on top of this one
+                wavetableBuilder->cancel(sc, o);
+            }
+
             if (patch.scene[sc].osc[o].wt.queue_id != -1)
             {
                 if (patch.scene[sc].osc[o].wt.everBuilt)
@@ -1318,15 +1535,7 @@ void SurgeStorage::load_wt(int id, Wavetable *wt, OscillatorStorage *osc)
 
     if (wt_list.empty() && id == 0)
     {
-#if HAS_JUCE
-        load_wt_wt_mem(SurgeSharedBinary::memoryWavetable_wt,
-                       SurgeSharedBinary::memoryWavetable_wtSize, wt);
-#endif
-        if (osc)
-        {
-            osc->wavetable_display_name = "Sin to Saw";
-        }
-
+        load_wt_builtin(wt, osc);
         return;
     }
 
@@ -1348,6 +1557,18 @@ void SurgeStorage::load_wt(int id, Wavetable *wt, OscillatorStorage *osc)
     }
 }
 
+void SurgeStorage::load_wt_builtin(Wavetable *wt, OscillatorStorage *osc)
+{
+#if HAS_JUCE
+    load_wt_wt_mem(SurgeSharedBinary::memoryWavetable_wt, SurgeSharedBinary::memoryWavetable_wtSize,
+                   wt);
+#endif
+    if (osc)
+    {
+        osc->wavetable_display_name = "Sin to Saw";
+    }
+}
+
 void SurgeStorage::load_wt(string filename, Wavetable *wt, OscillatorStorage *osc)
 {
     wt->current_filename = wt->queue_filename;
@@ -2403,7 +2624,67 @@ void SurgeStorage::clipboard_paste(
         }
     }
 
+    publishModulationRoutings();
+    modRoutingMutex.unlock();
+}
+
+void SurgeStorage::beginModulationRoutingChanges()
+{
+    modRoutingMutex.lock();
+    modRoutingChangeDepth++;
+}
+
+bool SurgeStorage::tryBeginModulationRoutingChanges()
+{
+    if (!modRoutingMutex.try_lock())
+        return false;
+
+    modRoutingChangeDepth++;
+    return true;
+}
+
+bool SurgeStorage::endModulationRoutingChanges()
+{
+    bool res = false;
+
+    if (--modRoutingChangeDepth == 0)
+    {
+        res = modRoutingChanged;
+        modRoutingChanged = false;
+    }
+
     modRoutingMutex.unlock();
+
+    return res;
+}
+
+void SurgeStorage::publishModulationRoutings()
+{
+    std::lock_guard<std::recursive_mutex> g(modRoutingMutex);
+
+    // only the thread which opened the batch can get here while it is open
+    if (modRoutingChangeDepth > 0)
+    {
+        modRoutingChanged = true;
+        return;
+    }
+
+    auto snap = std::make_unique<ModulationRoutingSnapshot>();
+
+    for (int s = 0; s < n_scenes; ++s)
+    {
+        snap->modulation_scene[s] = getPatch().scene[s].modulation_scene;
+        snap->modulation_voice[s] = getPatch().scene[s].modulation_voice;
+
+        snap->sceneProgram[s].compile(snap->modulation_scene[s]);
+        snap->voiceProgram[s].compile(snap->modulation_voice[s]);
+        snap->voiceProgramNoLFO[s].compile(snap->modulation_voice[s], true);
+    }
+
+    snap->modulation_global = getPatch().modulation_global;
+    snap->globalProgram.compile(snap->modulation_global);
+
+    modRoutingPublisher.publish(std::move(snap));
 }
 
 TiXmlElement *SurgeStorage::getSnapshotSection(const char *name)
@@ -2482,6 +2763,7 @@ void SurgeStorage::setSamplerate(float sr)
     dsamplerate_inv = 1.0 / sr;
     dsamplerate_os = dsamplerate * OSC_OVERSAMPLING;
     dsamplerate_os_inv = 1.0 / dsamplerate_os;
+    sampleRateTables = Surge::Storage::getSampleRateTables(dsamplerate_os);
     init_tables();
 
     if (!wasST)
@@ -2584,6 +2866,9 @@ void SurgeStorage::load_midi_controllers()
 
 SurgeStorage::~SurgeStorage()
 {
+    // the builder's worker thread calls back into us, so it has to go first
+    wavetableBuilder.reset();
+
 #ifndef SURGE_SKIP_ODDSOUND_MTS
     if (oddsound_mts_active_as_main)
         disconnect_as_oddsound_main();
@@ -2597,34 +2882,18 @@ double shafted_tanh(double x) { return (exp(x) - exp(-x * 1.2)) / (exp(x) + exp(
 void SurgeStorage::init_tables()
 {
     isStandardTuning = true;
-    float db60 = powf(10.f, 0.05f * -60.f);
-    float _512th = 1.f / 512.f;
 
-    for (int i = 0; i < tuning_table_size; i++)
-    {
-        table_dB[i] = powf(10.f, 0.05f * ((float)i - 384.f));
-        table_pitch[i] = powf(2.f, ((float)i - 256.f) * (1.f / 12.f));
-        table_pitch_ignoring_tuning[i] = table_pitch[i];
-        table_pitch_inv[i] = 1.f / table_pitch[i];
-        table_pitch_inv_ignoring_tuning[i] = table_pitch_inv[i];
-        table_note_omega[0][i] =
-            (float)sin(2 * M_PI * min(0.5, 440 * table_pitch[i] * dsamplerate_os_inv));
-        table_note_omega[1][i] =
-            (float)cos(2 * M_PI * min(0.5, 440 * table_pitch[i] * dsamplerate_os_inv));
-        table_note_omega_ignoring_tuning[0][i] = table_note_omega[0][i];
-        table_note_omega_ignoring_tuning[1][i] = table_note_omega[1][i];
-        double k = dsamplerate_os * pow(2.0, (((double)i - 256.0) / 16.0)) / (double)BLOCK_SIZE_OS;
-        table_envrate_linear[i] = (float)(1.f / k);
-        table_envrate_lpf[i] = (float)(1.f - exp(log(db60) / k));
-        table_glide_log[i] = log2(1.0 + (i * _512th * 10.f)) / log2(1.f + 10.f);
-        table_glide_exp[511 - i] = 1.0 - table_glide_log[i];
-    }
+    // the untuned tables are shared, and these are our own copies for retuning to write over
+    auto &st = *sharedTables;
+    auto &rt = *sampleRateTables;
+
+    std::copy(std::begin(st.table_pitch), std::end(st.table_pitch), table_pitch);
+    std::copy(std::begin(st.table_pitch_inv), std::end(st.table_pitch_inv), table_pitch_inv);
 
-    for (int i = 0; i < 1001; ++i)
+    for (int c = 0; c < 2; ++c)
     {
-        double twelths = i * 1.0 / 12.0 / 1000.0;
-        table_two_to_the[i] = pow(2.0, twelths);
-        table_two_to_the_minus[i] = pow(2.0, -twelths);
+        std::copy(std::begin(rt.table_note_omega[c]), std::end(rt.table_note_omega[c]),
+                  table_note_omega[c]);
     }
 
     // include some margin for error (and to avoid denormals in IIR filter clamping)
@@ -2678,6 +2947,8 @@ float SurgeStorage::note_to_pitch_inv(float x)
 
 float SurgeStorage::note_to_pitch_ignoring_tuning(float x)
 {
+    auto &table_two_to_the = sharedTables->table_two_to_the;
+    auto &table_pitch_ignoring_tuning = sharedTables->table_pitch;
     x = limit_range(x + 256, 1.e-4f, tuning_table_size - (float)1.e-4);
     // x += 256;
     int e = (int)x;
@@ -2693,6 +2964,8 @@ float SurgeStorage::note_to_pitch_ignoring_tuning(float x)
 
 float SurgeStorage::note_to_pitch_inv_ignoring_tuning(float x)
 {
+    auto &table_two_to_the_minus = sharedTables->table_two_to_the_minus;
+    auto &table_pitch_inv_ignoring_tuning = sharedTables->table_pitch_inv;
     x = limit_range(x + 256, 0.f, tuning_table_size - (float)1.e-4);
     int e = (int)x;
     float a = x - (float)e;
@@ -2719,6 +2992,7 @@ void SurgeStorage::note_to_omega(float x, float &sinu, float &cosi)
 void SurgeStorage::note_to_omega_ignoring_tuning(float x, float &sinu, float &cosi,
                                                  float /*sampleRate*/)
 {
+    auto &table_note_omega_ignoring_tuning = sampleRateTables->table_note_omega;
     x = limit_range(x + 256, 0.f, tuning_table_size - (float)1.e-4);
     // x += 256;
     int e = (int)x;
@@ -2732,6 +3006,7 @@ void SurgeStorage::note_to_omega_ignoring_tuning(float x, float &sinu, float &co
 
 float SurgeStorage::db_to_linear(float x)
 {
+    auto &table_dB = sharedTables->table_dB;
     x += 384;
     int e = (int)x;
     float a = x - (float)e;
@@ -2769,6 +3044,7 @@ float SurgeStorage::lookup_waveshape_warp(sst::waveshapers::WaveshaperType entry
 
 float SurgeStorage::envelope_rate_lpf(float x)
 {
+    auto &table_envrate_lpf = sampleRateTables->table_envrate_lpf;
     x *= 16.f;
     x += 256.f;
     int e = (int)x;
@@ -2779,6 +3055,7 @@ float SurgeStorage::envelope_rate_lpf(float x)
 
 float SurgeStorage::envelope_rate_linear(float x)
 {
+    auto &table_envrate_linear = sampleRateTables->table_envrate_linear;
     x *= 16.f;
     x += 256.f;
     int e = (int)x;
@@ -2789,6 +3066,7 @@ float SurgeStorage::envelope_rate_linear(float x)
 
 float SurgeStorage::envelope_rate_linear_nowrap(float x)
 {
+    auto &table_envrate_linear = sampleRateTables->table_envrate_linear;
     x *= 16.f;
     x += 256.f;
     int e = limit_range((int)x, 0, 0x1ff - 1);
@@ -2801,6 +3079,7 @@ float SurgeStorage::envelope_rate_linear_nowrap(float x)
 // this function is only valid for x = {0, 1}
 float SurgeStorage::glide_exp(float x)
 {
+    auto &table_glide_exp = sharedTables->table_glide_exp;
     x *= 511.f;
     int e = (int)x;
     float a = x - (float)e;
@@ -2811,6 +3090,7 @@ float SurgeStorage::glide_exp(float x)
 // this function is only valid for x = {0, 1}
 float SurgeStorage::glide_log(float x)
 {
+    auto &table_glide_log = sharedTables->table_glide_log;
     x *= 511.f;
     int e = (int)x;
     float a = x - (float)e;
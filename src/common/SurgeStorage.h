@@ -50,6 +50,8 @@
 #include "PatchDB.h"
 #include <unordered_set>
 #include "UserDefaults.h"
+#include "SnapshotPublisher.h"
+#include "ModulationProgram.h"
 
 /*
  * Porting to c++20 and hit this a year or two from now? Check out the fix
@@ -1163,6 +1165,7 @@ class SurgePatch
     void do_morph();
     void copy_scenedata(pdata *, pdata *, int scene);
     void copy_globaldata(pdata *);
+    void buildParameterValueSources();
 
     // load/save
     // void load_xml();
@@ -1218,6 +1221,23 @@ class SurgePatch
     pdata scenedata[n_scenes][n_scene_params];
     pdata scenedataOrig[n_scenes][n_scene_params];
     pdata globaldata[n_global_params];
+
+    /*
+     * Where copy_scenedata and copy_globaldata read each parameter's value from, laid out in
+     * the same order as scenedata and globaldata. These are built once the parameters are laid
+     * out, so the per block copy walks one flat table rather than following param_ptr into
+     * every Parameter and testing its control group. The oscillator parameters, which are also
+     * copied to scenedataOrig, are listed separately.
+     *
+     * The values stay in each Parameter rather than in one array the copy could memcpy. val is
+     * read and written directly all over the code, so moving it out would mean a reference or
+     * pointer in every Parameter and an extra hop on every access, and there's no one write
+     * path to keep a dirty list from.
+     */
+    const pdata *sceneValueSource[n_scenes][n_scene_params];
+    const pdata *globalValueSource[n_global_params];
+    int16_t sceneOscParams[n_scenes][n_scene_params];
+    int nSceneOscParams[n_scenes]{};
     void *patchptr;
     SurgeStorage *storage;
 
@@ -1270,11 +1290,27 @@ class SurgePatch
     std::array<MonophonicParamModulation, maxMonophonicParamModulations> monophonicParamModulations;
 };
 
+/*
+ * An immutable copy of the patch modulation routings, which is what the audio thread renders
+ * with, along with each list compiled for evaluation. See
+ * SurgeStorage::publishModulationRoutings.
+ */
+struct ModulationRoutingSnapshot
+{
+    std::vector<ModulationRouting> modulation_scene[n_scenes], modulation_voice[n_scenes];
+    std::vector<ModulationRouting> modulation_global;
+
+    Surge::Modulation::RoutingProgram sceneProgram[n_scenes], voiceProgram[n_scenes],
+        voiceProgramNoLFO[n_scenes];
+    Surge::Modulation::RoutingProgram globalProgram;
+};
+
 struct Patch
 {
     std::string name;
     fs::path path;
     uint64_t lastModTime;
+    uint64_t fileSize{0};
     int category;
     int order;
     bool isFavorite;
@@ -1293,6 +1329,23 @@ struct PatchCategory
     int numberOfPatchesInCategoryAndChildren;
 };
 
+/*
+ * The folders a scan walked, each with its modification time from when it was listed.
+ * Adding, removing or renaming an entry touches a folder's time, so a scan is still current
+ * for as long as none of these have moved. Missing folders are recorded too, with a time of
+ * -1, so that creating one is noticed.
+ */
+struct ScannedFolders
+{
+    std::vector<std::pair<fs::path, int64_t>> folders;
+
+    static int64_t timeOf(const fs::path &dir);
+
+    void add(const fs::path &dir) { add(dir, timeOf(dir)); }
+    void add(const fs::path &dir, int64_t mtime) { folders.emplace_back(dir, mtime); }
+    bool unchanged() const;
+};
+
 enum surge_copysource
 {
     cp_off = 0,
@@ -1331,6 +1384,11 @@ struct ScenesOutputData
 
 struct FxUserPreset;
 struct ModulatorPreset;
+struct WavetableBuildService;
+struct SharedTables;
+struct SampleRateTables;
+struct ContentIndex;
+struct DirectoryScanCache;
 } // namespace Storage
 namespace Memory
 {
@@ -1342,11 +1400,6 @@ struct GlobalData;
 }
 } // namespace Surge
 
-namespace sst::basic_blocks::tables
-{
-struct SurgeSincTableProvider;
-}
-
 class alignas(16) SurgeStorage
 {
   public:
@@ -1355,13 +1408,16 @@ class alignas(16) SurgeStorage
     // this will be a pointer to an aligned 2 x BLOCK_SIZE_OS array
     float audio_otherscene alignas(16)[2][BLOCK_SIZE_OS];
 
-    std::unique_ptr<sst::basic_blocks::tables::SurgeSincTableProvider> sincTableProvider;
+    /*
+     * The sinc, dB, glide, envelope rate and untuned pitch tables are the same for every
+     * instance at a given sample rate, so they are shared process wide (see SharedStorage.h).
+     * The sinctable pointers point into sharedTables and must be treated as read only.
+     */
+    std::shared_ptr<const Surge::Storage::SharedTables> sharedTables;
+    std::shared_ptr<const Surge::Storage::SampleRateTables> sampleRateTables;
     float *sinctable, *sinctable1X;
     int16_t *sinctableI16;
 
-    float table_dB alignas(16)[512], table_envrate_lpf alignas(16)[512],
-        table_envrate_linear alignas(16)[512], table_glide_exp alignas(16)[512],
-        table_glide_log alignas(16)[512];
     float samplerate{0}, samplerate_inv{1};
     double dsamplerate{0}, dsamplerate_inv{1};
     double dsamplerate_os{0}, dsamplerate_os_inv{1};
@@ -1446,12 +1502,6 @@ class alignas(16) SurgeStorage
     float table_pitch alignas(16)[tuning_table_size];
     float table_pitch_inv alignas(16)[tuning_table_size];
     float table_note_omega alignas(16)[2][tuning_table_size];
-    float table_pitch_ignoring_tuning alignas(16)[tuning_table_size];
-    float table_pitch_inv_ignoring_tuning alignas(16)[tuning_table_size];
-    float table_note_omega_ignoring_tuning alignas(16)[2][tuning_table_size];
-    // 2^0 -> 2^+/-1/12th. See comment in note_to_pitch
-    float table_two_to_the alignas(16)[1001];
-    float table_two_to_the_minus alignas(16)[1001];
 
     ~SurgeStorage();
 
@@ -1484,6 +1534,13 @@ class alignas(16) SurgeStorage
     int controllers_chan[n_customcontrollers];
     float poly_aftertouch[2][16][128]; // TODO: FIX SCENE ASSUMPTION
     float modsource_vu[n_modsources];
+
+    /*
+     * Not realtime safe: call this from the host's prepare / activate path (or any other
+     * non-audio thread) with processing stopped, never from the audio callback. It takes the
+     * shared sample rate table lock, may build a new set of tables, may free the last user of
+     * the old set and rebuilds the tuning tables, all of which can block or allocate.
+     */
     void setSamplerate(float sr);
     float cpu_falloff;
 
@@ -1504,16 +1561,47 @@ class alignas(16) SurgeStorage
     void refresh_wtlistFrom(bool isUser, const fs::path &from, const std::string &subdir);
     void refresh_patchlist();
     void refreshPatchlistAddDir(bool userDir, std::string subdir);
+    void applyPatchFavorites();
+
+    /*
+     * Instances using the same folders share their scans through sharedContent. The adopt
+     * calls copy in what another instance already scanned and return false if there is
+     * nothing yet or if any of the scanned folders changed since, and the refresh calls (and
+     * FX preset rescans) publish what they find.
+     */
+    std::shared_ptr<Surge::Storage::ContentIndex> sharedContent;
+    bool adoptSharedPatchlist();
+    bool adoptSharedWtlist();
+    bool adoptSharedFxPresets();
+    void publishFxPresets();
+
+    /*
+     * Remembers the patch and wavetable folder listings between sessions, so a refresh only
+     * reads the directories which changed since. Shared by instances with the same user folder.
+     */
+    std::shared_ptr<Surge::Storage::DirectoryScanCache> scanCache;
 
     void refreshPatchOrWTListAddDir(bool userDir, const fs::path &fromPath, std::string subdir,
                                     std::function<bool(std::string)> filterOp,
                                     std::vector<Patch> &items,
-                                    std::vector<PatchCategory> &categories);
+                                    std::vector<PatchCategory> &categories,
+                                    ScannedFolders &folders);
 
     void perform_queued_wtloads();
 
+    /*
+     * When set, queued wavetable loads are built on a worker thread and swapped in once they
+     * are ready, rather than loaded inline on the audio thread. Offline renders want them
+     * inline, so a table change lands on a predictable block.
+     */
+    void setBuildWavetablesInBackground(bool b);
+    std::atomic<bool> buildWavetablesInBackground{false};
+    std::unique_ptr<Surge::Storage::WavetableBuildService> wavetableBuilder;
+
     void load_wt(int id, Wavetable *wt, OscillatorStorage *);
     void load_wt(std::string filename, Wavetable *wt, OscillatorStorage *);
+    // the Sin to Saw table in the binary, which id 0 loads when there are no table files
+    void load_wt_builtin(Wavetable *wt, OscillatorStorage *);
     bool load_wt_wt(std::string filename, Wavetable *wt, std::string &metadata);
     bool load_wt_wt_mem(const char *data, const size_t dataSize, Wavetable *wt);
     bool load_wt_wav_portable(std::string filename, Wavetable *wt, std::string &metadata);
@@ -1549,6 +1637,7 @@ class alignas(16) SurgeStorage
     std::vector<int> patchOrdering;
     std::vector<int> patchCategoryOrdering;
     std::array<std::array<int, 128>, 128> patchIdToMidiBankAndProgram;
+    ScannedFolders patchFolders;
 
     // The in-memory wavetable database
     std::vector<Patch> wt_list;
@@ -1557,6 +1646,7 @@ class alignas(16) SurgeStorage
     int firstUserWTCategory;
     std::vector<int> wtOrdering;
     std::vector<int> wtCategoryOrdering;
+    ScannedFolders wtFolders;
 
     std::unique_ptr<Surge::Storage::FxUserPreset> fxUserPreset;
     std::unique_ptr<Surge::Storage::ModulatorPreset> modulatorPreset;
@@ -1587,7 +1677,35 @@ class alignas(16) SurgeStorage
     void storeMidiMappingToName(std::string name);
 
     std::mutex waveTableDataMutex;
+
+    /*
+     * The routing vectors in the patch are the editable copy, guarded by modRoutingMutex.
+     * Anything which changes them must call publishModulationRoutings() afterwards, and the
+     * audio thread picks up the new snapshot at the start of its next block.
+     *
+     * Publishing copies and compiles every routing, so code which makes a run of changes
+     * (an effect swap clearing its modulation, or a patch load) brackets them with
+     * beginModulationRoutingChanges and endModulationRoutingChanges. That holds the lock
+     * throughout, and the publishes in between only note that something changed. The
+     * outermost end returns whether it did and leaves the one publish to the caller, which
+     * on the audio thread hands it to a worker (see FxSpawnService::requestRoutingPublish).
+     * The audio thread never waits for the lock: it opens its batches with the try version,
+     * and if an editor holds the lock it leaves the queued change for the next block.
+     */
     std::recursive_mutex modRoutingMutex;
+    void publishModulationRoutings();
+    void beginModulationRoutingChanges();
+    bool tryBeginModulationRoutingChanges();
+    bool endModulationRoutingChanges();
+
+    // audio thread only; the result stays valid until the next call
+    const ModulationRoutingSnapshot *acquireModulationRoutings()
+    {
+        audioModRoutings = modRoutingPublisher.acquire();
+        return audioModRoutings;
+    }
+    const ModulationRoutingSnapshot &audioModulationRoutings() const { return *audioModRoutings; }
+
     Wavetable WindowWT;
 
     // hardclip
@@ -1811,6 +1929,13 @@ class alignas(16) SurgeStorage
     Modulator::SmoothingMode smoothingMode = Modulator::SmoothingMode::LEGACY;
     Modulator::SmoothingMode pitchSmoothingMode = Modulator::SmoothingMode::LEGACY;
 
+    /*
+     * Let Classic oscillators made from here on use their AVX/FMA convolution where the CPU has
+     * it. Fused multiply-adds round differently, so the same patch then renders a little
+     * differently on machines with and without AVX; that's why it is off unless asked for.
+     */
+    bool useWideBlitConvolution{false};
+
     float mpePitchBendRange = -1.0f;
     bool mpeTimbreIsUnipolar = false;
 
@@ -1849,6 +1974,12 @@ class alignas(16) SurgeStorage
     MonoVoicePriorityMode clipboard_primode = NOTE_ON_LATEST_RETRIGGER_HIGHEST;
     MonoVoiceEnvelopeMode clipboard_envmode = RESTART_FROM_ZERO;
 
+    Surge::Threading::SnapshotPublisher<ModulationRoutingSnapshot> modRoutingPublisher;
+    const ModulationRoutingSnapshot *audioModRoutings{nullptr};
+    // guarded by modRoutingMutex
+    int modRoutingChangeDepth{0};
+    bool modRoutingChanged{false};
+
   public:
     // whether to skip loading, desired while exporting manifests. Only used by LV2 currently.
     static bool skipLoadWtAndPatch;
@@ -1894,6 +2025,14 @@ class alignas(16) SurgeStorage
 #else
 #define runningOnAudioThread() (void *)0;
 #endif
+    /*
+     * Audio work which is farmed out to a helper thread (like parallel scene rendering)
+     * points this at a generator it owns for the duration of the job, so the calls below
+     * don't race the audio thread on rngGen.
+     */
+    static thread_local RNGGen *threadRNGOverride;
+    inline RNGGen &activeRNG() { return threadRNGOverride ? *threadRNGOverride : rngGen; }
+
     /*
      * These API points are only thread safe on the AUDIO thread.
      * If you want to have an independent RNG on another thread, manage
@@ -1903,22 +2042,26 @@ class alignas(16) SurgeStorage
     inline int rand()
     {
         runningOnAudioThread();
-        return rngGen.d(rngGen.g);
+        auto &r = activeRNG();
+        return r.d(r.g);
     }
     inline uint32_t rand_u32()
     {
         runningOnAudioThread();
-        return rngGen.u32(rngGen.g);
+        auto &r = activeRNG();
+        return r.u32(r.g);
     }
     inline float rand_pm1()
     {
         runningOnAudioThread();
-        return rngGen.pm1(rngGen.g);
+        auto &r = activeRNG();
+        return r.pm1(r.g);
     }
     inline float rand_01()
     {
         runningOnAudioThread();
-        return rngGen.z1(rngGen.g);
+        auto &r = activeRNG();
+        return r.z1(r.g);
     }
 // void seed_rand(int s) { rngGen.g.seed(s); }
 #else
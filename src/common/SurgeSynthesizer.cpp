@@ -44,6 +44,7 @@
 #include "sst/basic-blocks/mechanics/block-ops.h"
 #include "sst/basic-blocks/dsp/Clippers.h"
 #include "sst/cpputils/constructors.h"
+#include "sst/plugininfra/cpufeatures.h"
 
 using namespace std;
 namespace mech = sst::basic_blocks::mechanics;
@@ -103,12 +104,6 @@ SurgeSynthesizer::SurgeSynthesizer(PluginLayer *parent, const std::string &suppl
 
     stopSound();
 
-    for (int i = 0; i < MAX_VOICES; i++)
-    {
-        voices_usedby[0][i] = 0;
-        voices_usedby[1][i] = 0;
-    }
-
     for (int sc = 0; sc < n_scenes; sc++)
     {
         FBQ[sc] = new QuadFilterChainState[MAX_VOICES >> 2]();
@@ -119,6 +114,8 @@ SurgeSynthesizer::SurgeSynthesizer(PluginLayer *parent, const std::string &suppl
         }
     }
 
+    wideFilterChainAvailable = sst::plugininfra::cpufeatures::hasAVX();
+
     SurgePatch &patch = storage.getPatch();
 
     storage.smoothingMode = (Modulator::SmoothingMode)(int)Surge::Storage::getUserDefaultValue(
@@ -129,6 +126,12 @@ SurgeSynthesizer::SurgeSynthesizer(PluginLayer *parent, const std::string &suppl
     midiSoftTakeover =
         (bool)Surge::Storage::getUserDefaultValue(&storage, Surge::Storage::MIDISoftTakeover, 0);
 
+    setRenderScenesInParallel((bool)Surge::Storage::getUserDefaultValue(
+        &storage, Surge::Storage::RenderScenesInParallel, 0));
+
+    storage.memoryPools->setNeverAllocate((bool)Surge::Storage::getUserDefaultValue(
+        &storage, Surge::Storage::NeverAllocateOnAudioThread, 0));
+
     patch.polylimit.val.i = DEFAULT_POLYLIMIT;
 
     for (int sc = 0; sc < n_scenes; sc++)
@@ -545,7 +548,7 @@ void SurgeSynthesizer::playNoteByFrequency(float freq, char velocity, int32_t id
 
 void SurgeSynthesizer::softkillVoice(int s)
 {
-    list<SurgeVoice *>::iterator iter, max_playing, max_released;
+    VoiceList::iterator iter, max_playing, max_released;
     int max_age = -1, max_age_release = -1;
     iter = voices[s].begin();
 
@@ -580,7 +583,7 @@ void SurgeSynthesizer::softkillVoice(int s)
 // only allow 'margin' number of voices to be softkilled simultaneously
 void SurgeSynthesizer::enforcePolyphonyLimit(int s, int margin)
 {
-    list<SurgeVoice *>::iterator iter;
+    VoiceList::iterator iter;
 
     int paddedPoly = std::min((storage.getPatch().polylimit.val.i + margin), MAX_VOICES - 1);
     if (voices[s].size() > paddedPoly)
@@ -642,59 +645,56 @@ int SurgeSynthesizer::getNonReleasedVoices(int s) const
 
 SurgeVoice *SurgeSynthesizer::getUnusedVoice(int scene)
 {
-    for (int i = 0; i < MAX_VOICES; i++)
-    {
-        if (!voices_usedby[scene][i])
-        {
-            voices_usedby[scene][i] = scene + 1;
-            return &voices_array[scene][i];
-        }
-    }
-    return 0;
+    auto slot = voiceTable.allocate(scene);
+
+    if (slot < 0)
+        return nullptr;
+
+    return &voices_array[scene][slot];
 }
 
-void SurgeSynthesizer::freeVoice(SurgeVoice *v)
+void SurgeSynthesizer::activateVoice(int scene, SurgeVoice *v)
 {
-    if (v->host_note_id >= 0)
+    int vs, slot;
+    findVoiceSlot(v, vs, slot);
+    assert(vs == scene);
+
+    voices[scene].push_back(v);
+    voiceTable.activate(scene, slot, v->host_note_id);
+}
+
+bool SurgeSynthesizer::findVoiceSlot(const SurgeVoice *v, int &scene, int &slot) const
+{
+    for (int s = 0; s < n_scenes; ++s)
     {
-        bool used_away = false;
-        // does any other voice have this voiceid
-        for (int s = 0; s < n_scenes; ++s)
-        {
-            for (auto vo : voices[s])
-            {
-                if (vo != v && vo->host_note_id == v->host_note_id)
-                {
-                    used_away = true;
-                }
-            }
-        }
-        if (!used_away)
+        auto first = voices_array[s].data();
+
+        if (std::less_equal<const SurgeVoice *>()(first, v) &&
+            std::less<const SurgeVoice *>()(v, first + MAX_VOICES))
         {
-            notifyEndedNote(v->host_note_id, v->originating_host_key, v->originating_host_channel);
+            scene = s;
+            slot = (int)(v - first);
+            return true;
         }
     }
 
+    scene = -1;
+    slot = -1;
+    return false;
+}
+
+void SurgeSynthesizer::freeVoice(SurgeVoice *v)
+{
     int foundScene{-1}, foundIndex{-1};
-    for (int i = 0; i < MAX_VOICES; i++)
+    findVoiceSlot(v, foundScene, foundIndex);
+    assert(foundScene >= 0 && voiceTable.isInUse(foundScene, foundIndex));
+
+    // does any other voice still have this voiceid
+    if (voiceTable.release(foundScene, foundIndex))
     {
-        if (voices_usedby[0][i] && (v == &voices_array[0][i]))
-        {
-            assert(foundScene == -1);
-            assert(foundIndex == -1);
-            foundScene = 0;
-            foundIndex = i;
-            voices_usedby[0][i] = 0;
-        }
-        if (voices_usedby[1][i] && (v == &voices_array[1][i]))
-        {
-            assert(foundScene == -1);
-            assert(foundIndex == -1);
-            foundScene = 1;
-            foundIndex = i;
-            voices_usedby[1][i] = 0;
-        }
+        notifyEndedNote(v->host_note_id, v->originating_host_key, v->originating_host_channel);
     }
+
     v->freeAllocatedElements();
 
     /*
@@ -836,14 +836,14 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
                 nvoice->~SurgeVoice();
 
                 int mpeMainChannel = getMpeMainChannel(channel, key);
-
-                voices[scene].push_back(nvoice);
                 new (nvoice) SurgeVoice(
                     &storage, &storage.getPatch().scene[scene], storage.getPatch().scenedata[scene],
                     storage.getPatch().scenedataOrig[scene], key, velocity, channel, scene, detune,
                     &channelState[channel].keyState[key], &channelState[mpeMainChannel],
                     &channelState[channel], mpeEnabled, voiceCounter++, host_noteid,
                     host_originating_key, host_originating_channel, 0.f, 0.f);
+
+                activateVoice(scene, nvoice);
             }
         }
         break;
@@ -852,7 +852,7 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
     case pm_mono_fp:
     case pm_latch:
     {
-        list<SurgeVoice *>::const_iterator iter;
+        VoiceList::const_iterator iter;
         bool glide = false;
 
         int primode = storage.getPatch().scene[scene].monoVoicePriorityMode;
@@ -978,8 +978,6 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
                 if (nvoice)
                 {
                     int mpeMainChannel = getMpeMainChannel(channel, key);
-
-                    voices[scene].push_back(nvoice);
                     if ((storage.getPatch().scene[scene].polymode.val.i == pm_mono_fp) && !glide)
                         storage.last_key[scene] = key;
                     new (nvoice) SurgeVoice(
@@ -990,6 +988,8 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
                         &channelState[channel], mpeEnabled, voiceCounter++, host_noteid,
                         host_originating_key, host_originating_channel, aegReuse, fegReuse);
 
+                    activateVoice(scene, nvoice);
+
                     if (wasGated && pkeyToReuse > 0)
                     {
                         // This is commented out since it runs away in some
@@ -1078,7 +1078,7 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
 
         if (createVoice)
         {
-            list<SurgeVoice *>::const_iterator iter;
+            VoiceList::const_iterator iter;
             SurgeVoice *recycleThis{nullptr};
             float aegStart{0.}, fegStart{0.};
             for (iter = voices[scene].begin(); iter != voices[scene].end(); iter++)
@@ -1126,7 +1126,6 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
                 SurgeVoice *nvoice = getUnusedVoice(scene);
                 if (nvoice)
                 {
-                    voices[scene].push_back(nvoice);
                     new (nvoice) SurgeVoice(
                         &storage, &storage.getPatch().scene[scene],
                         storage.getPatch().scenedata[scene],
@@ -1134,6 +1133,7 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
                         detune, &channelState[channel].keyState[key], &channelState[mpeMainChannel],
                         &channelState[channel], mpeEnabled, voiceCounter++, host_noteid,
                         host_originating_key, host_originating_channel, aegStart, fegStart);
+                    activateVoice(scene, nvoice);
                 }
             }
             else
@@ -1174,7 +1174,7 @@ void SurgeSynthesizer::playVoice(int scene, char channel, char key, char velocit
 
 void SurgeSynthesizer::releaseScene(int s)
 {
-    list<SurgeVoice *>::const_iterator iter;
+    VoiceList::const_iterator iter;
     for (iter = voices[s].begin(); iter != voices[s].end(); iter++)
     {
         freeVoice(*iter);
@@ -1320,7 +1320,7 @@ void SurgeSynthesizer::releaseNotePostHoldCheck(int scene, char channel, char ke
                                                 int32_t host_noteid)
 {
     channelState[channel].keyState[key].keystate = 0;
-    list<SurgeVoice *>::const_iterator iter;
+    VoiceList::const_iterator iter;
     for (int s = 0; s < n_scenes; s++)
     {
         bool do_switch = false;
@@ -2588,7 +2588,7 @@ void SurgeSynthesizer::stopSound()
 
     for (int s = 0; s < n_scenes; s++)
     {
-        list<SurgeVoice *>::const_iterator iter;
+        VoiceList::const_iterator iter;
         for (iter = voices[s].begin(); iter != voices[s].end(); iter++)
         {
             freeVoice(*iter);
@@ -2640,6 +2640,26 @@ void SurgeSynthesizer::setSamplerate(float sr)
     }
 }
 
+void SurgeSynthesizer::resetRandomState(unsigned int seed)
+{
+    storage.rngGen.g.seed(seed);
+
+    for (int sc = 0; sc < n_scenes; sc++)
+    {
+        auto &ms = storage.getPatch().scene[sc].modsources;
+
+        for (auto i : {ms_random_bipolar, ms_random_unipolar})
+        {
+            static_cast<RandomModulationSource *>(ms[i])->seed(seed + sc * n_modsources + i);
+        }
+
+        for (auto i : {ms_alternate_bipolar, ms_alternate_unipolar})
+        {
+            static_cast<AlternateModulationSource *>(ms[i])->state = false;
+        }
+    }
+}
+
 //-------------------------------------------------------------------------------------------------
 
 int SurgeSynthesizer::GetFreeControlInterpolatorIndex()
@@ -2992,7 +3012,7 @@ void SurgeSynthesizer::switch_toggled()
 {
     for (int s = 0; s < n_scenes; s++)
     {
-        list<SurgeVoice *>::iterator iter;
+        VoiceList::iterator iter;
         for (iter = voices[s].begin(); iter != voices[s].end(); iter++)
         {
             SurgeVoice *v = *iter;
@@ -3005,6 +3025,22 @@ bool SurgeSynthesizer::loadFx(bool initp, bool force_reload_all)
 {
     load_fx_needed = false;
     bool localSendFX[n_fx_slots];
+    bool routingChanges{false};
+
+    bool inBackground =
+        fxSpawner && spawnEffectsInBackground && audio_processing_active && !force_reload_all;
+
+    if (fxSpawner && force_reload_all)
+    {
+        // every slot is being replaced right now, so in-flight swaps are moot
+        fxSpawner->cancelAll();
+
+        for (auto &f : fxSwapFade)
+        {
+            f = FxSwapFade();
+        }
+    }
+
     for (int s = 0; s < n_fx_slots; s++)
     {
         localSendFX[s] = false;
@@ -3012,13 +3048,58 @@ bool SurgeSynthesizer::loadFx(bool initp, bool force_reload_all)
         if ((fxsync[s].type.val.i != storage.getPatch().fx[s].type.val.i) || force_reload_all ||
             fx_reload[s])
         {
+            std::unique_ptr<Effect> spawned;
+            std::unique_lock<std::mutex> g(fxSpawnMutex, std::defer_lock);
+
+            if (inBackground)
+            {
+                /*
+                 * The worker builds the new instance while the old one fades out, and the old
+                 * one keeps its parameters until then. We swap once both are done and the UI
+                 * isn't holding the spawn lock, and until then come back every block.
+                 */
+                auto &fade = fxSwapFade[s];
+                auto type = fxsync[s].type.val.i;
+
+                if (fx[s] && fade.dir >= 0)
+                {
+                    fade.dir = -1;
+                }
+
+                bool ready = fxSpawner->request(s, type);
+                bool fadedOut = !fx[s] || fade.pos == 0;
+
+                if (!ready || !fadedOut || !fxSpawner->canRetire() || !g.try_lock() ||
+                    !fxSpawner->acquire(s, type, spawned))
+                {
+                    load_fx_needed = true;
+                    continue;
+                }
+            }
+            else
+            {
+                g.lock();
+            }
+
             localSendFX[s] = true;
             storage.getPatch().isDirty = true;
             fx_reload[s] = false;
 
-            std::lock_guard<std::mutex> g(fxSpawnMutex);
+            // the swap clears modulation one routing at a time, so publish that once at the end
+            if (!routingChanges)
+            {
+                storage.beginModulationRoutingChanges();
+                routingChanges = true;
+            }
 
-            fx[s].reset();
+            if (inBackground)
+            {
+                fxSpawner->retire(std::move(fx[s]));
+            }
+            else
+            {
+                fx[s].reset();
+            }
             /*if (!force_reload_all)*/ storage.getPatch().fx[s].type.val.i = fxsync[s].type.val.i;
             // else fxsync[s].type.val.i = storage.getPatch().fx[s].type.val.i;
 
@@ -3038,8 +3119,16 @@ bool SurgeSynthesizer::loadFx(bool initp, bool force_reload_all)
                           std::begin(storage.getPatch().fx[s].p));
             }
 
-            fx[s].reset(spawn_effect(storage.getPatch().fx[s].type.val.i, &storage,
-                                     &storage.getPatch().fx[s], storage.getPatch().globaldata));
+            if (inBackground)
+            {
+                fx[s] = std::move(spawned);
+                fxSwapFade[s] = fx[s] ? FxSwapFade{0, 1} : FxSwapFade();
+            }
+            else
+            {
+                fx[s].reset(spawn_effect(storage.getPatch().fx[s].type.val.i, &storage,
+                                         &storage.getPatch().fx[s], storage.getPatch().globaldata));
+            }
             if (fx[s])
             {
                 fx[s]->init_ctrltypes();
@@ -3161,6 +3250,11 @@ bool SurgeSynthesizer::loadFx(bool initp, bool force_reload_all)
             something_changed = true;
             refresh_editor = true;
         }
+        else if (fxSwapFade[s].dir < 0)
+        {
+            // the change was undone before it landed, so bring the old instance back in
+            fxSwapFade[s].dir = 1;
+        }
         else if (fx_reload[s])
         {
             // This branch will happen when we change a preset for an FX; or when we turn an fx to
@@ -3191,18 +3285,58 @@ bool SurgeSynthesizer::loadFx(bool initp, bool force_reload_all)
     {
         for (int s = 0; s < n_fx_slots; ++s)
         {
-            resendFXParam[s] = localSendFX[s];
+            // slots still mid swap bring us back here, so only ever raise these; the UI clears
+            if (localSendFX[s])
+                resendFXParam[s] = true;
         }
     }
 
+    if (routingChanges)
+        finishModulationRoutingChanges();
+
     // if (something_changed) storage.getPatch().update_controls(false);
     return true;
 }
 
+void SurgeSynthesizer::finishModulationRoutingChanges()
+{
+    if (!storage.endModulationRoutingChanges())
+        return;
+
+    // on the audio thread, leave the copy and compile to the spawn worker
+    if (fxSpawner && audio_processing_active)
+    {
+        routingPublishPending = !fxSpawner->requestRoutingPublish();
+    }
+    else
+    {
+        storage.publishModulationRoutings();
+    }
+}
+
 bool SurgeSynthesizer::loadOscalgos()
 {
     bool algosChanged{false};
+    bool routingChanges{false};
     bool localResendOscParams[n_scenes][n_oscs];
+
+    /*
+     * A type change clears that oscillator's modulation, and we run on the audio thread, so
+     * take the routing lock up front without waiting. If an editor has it, leave every queued
+     * change where it is and come back next block.
+     */
+    for (int s = 0; s < n_scenes && !routingChanges; s++)
+    {
+        for (int i = 0; i < n_oscs && !routingChanges; i++)
+        {
+            auto &osc_st = storage.getPatch().scene[s].osc[i];
+            routingChanges = osc_st.queue_type > -1 && osc_st.queue_type != osc_st.type.val.i;
+        }
+    }
+
+    if (routingChanges && !storage.tryBeginModulationRoutingChanges())
+        return false;
+
     for (int s = 0; s < n_scenes; s++)
     {
         for (int i = 0; i < n_oscs; i++)
@@ -3215,6 +3349,7 @@ bool SurgeSynthesizer::loadOscalgos()
                 // clear assigned modulation, and echo to OSC if we change osc type, see issue #2224
                 if (osc_st.queue_type != osc_st.type.val.i)
                 {
+                    // we already hold the (recursive) routing lock, so this can't block
                     clear_osc_modulation(s, i);
                 }
 
@@ -3322,6 +3457,10 @@ bool SurgeSynthesizer::loadOscalgos()
             }
         }
     }
+
+    if (routingChanges)
+        finishModulationRoutingChanges();
+
     return true;
 }
 
@@ -3624,20 +3763,22 @@ void SurgeSynthesizer::prepareModsourceDoProcess(int scenemask)
                 }
             }
 
+            auto &routings = storage.audioModulationRoutings();
+
             for (int j = 0; j < 3; j++)
             {
-                vector<ModulationRouting> *modlist;
+                const vector<ModulationRouting> *modlist;
 
                 switch (j)
                 {
                 case 0:
-                    modlist = &storage.getPatch().modulation_global;
+                    modlist = &routings.modulation_global;
                     break;
                 case 1:
-                    modlist = &storage.getPatch().scene[scene].modulation_scene;
+                    modlist = &routings.modulation_scene[scene];
                     break;
                 case 2:
-                    modlist = &storage.getPatch().scene[scene].modulation_voice;
+                    modlist = &routings.modulation_voice[scene];
                     break;
                 }
 
@@ -3691,10 +3832,13 @@ void SurgeSynthesizer::muteModulation(long ptag, modsources modsource, int modso
     if (!isValidModulation(ptag, modsource))
         return;
 
+    std::lock_guard<std::recursive_mutex> g(storage.modRoutingMutex);
+
     ModulationRouting *r = getModRouting(ptag, modsource, modsourceScene, index);
     if (r)
     {
         r->muted = mute;
+        storage.publishModulationRoutings();
         storage.getPatch().isDirty = true;
 
         for (auto l : modListeners)
@@ -3817,6 +3961,7 @@ void SurgeSynthesizer::clear_osc_modulation(int scene, int entry)
         else
             iter++;
     }
+    storage.publishModulationRoutings();
     storage.modRoutingMutex.unlock();
 }
 
@@ -3900,6 +4045,7 @@ void SurgeSynthesizer::clearModulation(long ptag, modsources modsource, int mods
         {
             storage.modRoutingMutex.lock();
             modlist->erase(modlist->begin() + i);
+            storage.publishModulationRoutings();
             storage.modRoutingMutex.unlock();
             storage.getPatch().isDirty = true;
 
@@ -3978,6 +4124,7 @@ bool SurgeSynthesizer::setModDepth01(long ptag, modsources modsource, int modsou
             modlist->at(found_id).depth = value;
         }
     }
+    storage.publishModulationRoutings();
     storage.modRoutingMutex.unlock();
 
     for (auto l : modListeners)
@@ -4342,9 +4489,16 @@ void SurgeSynthesizer::enqueueFXOff(int whichFX)
 
 void SurgeSynthesizer::processControl()
 {
+    if (routingPublishPending)
+        routingPublishPending = !fxSpawner->requestRoutingPublish();
+
+    if (fxSpawner)
+        fxSpawner->wakeForRetired();
+
     processEnqueuedPatchIfNeeded();
 
     storage.perform_queued_wtloads();
+    auto &routings = *storage.acquireModulationRoutings();
     int sm = storage.getPatch().scenemode.val.i;
     // TODO: FIX SCENE ASSUMPTION
     bool playA = (sm == sm_split) || (sm == sm_dual) || (sm == sm_chsplit) ||
@@ -4460,21 +4614,9 @@ void SurgeSynthesizer::processControl()
             // for(int i=0; i<n_lfos_scene; i++)
             // storage.getPatch().scene[s].modsources[ms_slfo1+i]->process_block();
 
-            int n = storage.getPatch().scene[s].modulation_scene.size();
-            for (int i = 0; i < n; i++)
-            {
-                int src_id = storage.getPatch().scene[s].modulation_scene[i].source_id;
-                int src_index = storage.getPatch().scene[s].modulation_scene[i].source_index;
-                if (storage.getPatch().scene[s].modsources[src_id])
-                {
-                    int dst_id = storage.getPatch().scene[s].modulation_scene[i].destination_id;
-                    float depth = storage.getPatch().scene[s].modulation_scene[i].depth;
-                    storage.getPatch().scenedata[s][dst_id].f +=
-                        depth *
-                        storage.getPatch().scene[s].modsources[src_id]->get_output(src_index) *
-                        (1.0 - storage.getPatch().scene[s].modulation_scene[i].muted);
-                }
-            }
+            auto &sceneSources = storage.getPatch().scene[s].modsources;
+            routings.sceneProgram[s].apply(storage.getPatch().scenedata[s],
+                                           [&](int, int id) { return sceneSources[id]; });
 
             for (int i = 0; i < n_lfos_scene; i++)
             {
@@ -4495,20 +4637,9 @@ void SurgeSynthesizer::processControl()
 
     loadOscalgos();
 
-    int n = storage.getPatch().modulation_global.size();
-    for (int i = 0; i < n; i++)
-    {
-        int src_id = storage.getPatch().modulation_global[i].source_id;
-        int src_index = storage.getPatch().modulation_global[i].source_index;
-        int dst_id = storage.getPatch().modulation_global[i].destination_id;
-        float depth = storage.getPatch().modulation_global[i].depth;
-        int source_scene = storage.getPatch().modulation_global[i].source_scene;
-
-        storage.getPatch().globaldata[dst_id].f +=
-            depth *
-            storage.getPatch().scene[source_scene].modsources[src_id]->get_output(src_index) *
-            (1 - storage.getPatch().modulation_global[i].muted);
-    }
+    routings.globalProgram.apply(storage.getPatch().globaldata, [this](int scene, int id) {
+        return storage.getPatch().scene[scene].modsources[id];
+    });
 
     if (switch_toggled_queued)
     {
@@ -4516,8 +4647,15 @@ void SurgeSynthesizer::processControl()
         switch_toggled_queued = false;
     }
 
-    if (load_fx_needed)
+    /*
+     * reorderFx fills in fxsync and fxmodsync under the routing lock, and reloading rewrites
+     * routings, so only reload when nobody is mid-edit. Otherwise we'll get it next block.
+     */
+    if (load_fx_needed && storage.modRoutingMutex.try_lock())
+    {
         loadFx(false, false);
+        storage.modRoutingMutex.unlock();
+    }
 
     if (fx_suspend_bitmask)
     {
@@ -4565,6 +4703,396 @@ void SurgeSynthesizer::processControl()
 #endif
 }
 
+int SurgeSynthesizer::renderSceneVoices(int s)
+{
+    SURGE_PROFILE_STAGE(stageProfiler,
+                        Surge::Profiling::sceneStage(Surge::Profiling::ps_scene_voices_a, s));
+    int count = 0;
+    auto iter = voices[s].begin();
+
+    while (iter != voices[s].end())
+    {
+        SurgeVoice *v = *iter;
+        assert(v);
+        bool resume = v->process_block(FBQ[s][count >> 2], count & 3);
+        count++;
+
+        if (!resume)
+        {
+            // freed in freeRetiredVoices once the scene is done, see there
+            retiredVoices[s].push_back(v);
+            iter = voices[s].erase(iter);
+        }
+        else
+            iter++;
+    }
+
+    FBentry[s] = count;
+
+    return count;
+}
+
+void SurgeSynthesizer::renderSceneFilterBlock(int s)
+{
+    SURGE_PROFILE_STAGE(stageProfiler,
+                        Surge::Profiling::sceneStage(Surge::Profiling::ps_scene_filterblock_a, s));
+    using sst::filters::FilterType, sst::filters::FilterSubType;
+    fbq_global g;
+    if (storage.getPatch().scene[s].filterunit[0].type.deactivated)
+    {
+        g.FU1ptr = nullptr;
+    }
+    else
+    {
+        g.FU1ptr = sst::filters::GetQFPtrFilterUnit(
+            static_cast<FilterType>(storage.getPatch().scene[s].filterunit[0].type.val.i),
+            static_cast<FilterSubType>(storage.getPatch().scene[s].filterunit[0].subtype.val.i));
+    }
+    if (storage.getPatch().scene[s].filterunit[1].type.deactivated)
+    {
+        g.FU2ptr = nullptr;
+    }
+    else
+    {
+        g.FU2ptr = sst::filters::GetQFPtrFilterUnit(
+            static_cast<FilterType>(storage.getPatch().scene[s].filterunit[1].type.val.i),
+            static_cast<FilterSubType>(storage.getPatch().scene[s].filterunit[1].subtype.val.i));
+    }
+
+    if (storage.getPatch().scene[s].wsunit.type.deactivated)
+    {
+        g.WSptr = nullptr;
+    }
+    else
+    {
+        g.WSptr = sst::waveshapers::GetQuadWaveshaper(static_cast<sst::waveshapers::WaveshaperType>(
+            storage.getPatch().scene[s].wsunit.type.val.i));
+    }
+
+    auto fbConfig = storage.getPatch().scene[s].filterblock_configuration.val.i;
+    FBQFPtr ProcessQuadFB = GetFBQPointer(fbConfig, g.FU1ptr != 0, g.WSptr != 0, g.FU2ptr != 0);
+    FBQWideFPtr ProcessWideFB = nullptr;
+
+    if (useWideFilterChain && wideFilterChainAvailable)
+    {
+        ProcessWideFB = GetFBQWidePointer(fbConfig, g.FU1ptr != 0, g.WSptr != 0, g.FU2ptr != 0);
+    }
+
+    for (int e = 0; e < FBentry[s]; e += 4)
+    {
+        int units = FBentry[s] - e;
+        for (int i = units; i < 4; i++)
+        {
+            FBQ[s][e >> 2].FU[0].active[i] = 0;
+            FBQ[s][e >> 2].FU[1].active[i] = 0;
+            FBQ[s][e >> 2].FU[2].active[i] = 0;
+            FBQ[s][e >> 2].FU[3].active[i] = 0;
+        }
+    }
+
+    int e = 0;
+
+    if (ProcessWideFB)
+    {
+        // pairs of quads, as long as the second one has at least one voice in it
+        for (; e + 4 < FBentry[s]; e += 8)
+        {
+            ProcessWideFB(FBQ[s][e >> 2], FBQ[s][(e >> 2) + 1], g, sceneout[s][0],
+                          sceneout[s][1]);
+        }
+    }
+
+    for (; e < FBentry[s]; e += 4)
+    {
+        ProcessQuadFB(FBQ[s][e >> 2], g, sceneout[s][0], sceneout[s][1]);
+    }
+
+    if (s == 0 && storage.otherscene_clients > 0)
+    {
+        // Make available for scene B
+        mech::copy_from_to<BLOCK_SIZE_OS>(sceneout[0][0], storage.audio_otherscene[0]);
+        mech::copy_from_to<BLOCK_SIZE_OS>(sceneout[0][1], storage.audio_otherscene[1]);
+    }
+
+    for (auto v : voices[s])
+    {
+        assert(v);
+        v->GetQFB(); // save filter state in voices after quad processing is done
+    }
+
+    // mute scene
+    if (storage.getPatch().scene[s].volume.deactivated)
+    {
+        mech::clear_block<BLOCK_SIZE_OS>(sceneout[s][0]);
+        mech::clear_block<BLOCK_SIZE_OS>(sceneout[s][1]);
+    }
+}
+
+void SurgeSynthesizer::renderScenePostFilter(int s, bool playScene)
+{
+    SURGE_PROFILE_STAGE(stageProfiler,
+                        Surge::Profiling::sceneStage(Surge::Profiling::ps_scene_postfilter_a, s));
+    // TODO: FIX SCENE ASSUMPTION
+    auto &halfband = (s == 0) ? halfbandA : halfbandB;
+    auto &hp = (s == 0) ? hpA : hpB;
+
+    if (playScene)
+    {
+        switch (storage.sceneHardclipMode[s])
+        {
+        case SurgeStorage::HARDCLIP_TO_18DBFS:
+            sdsp::hardclip_block8<BLOCK_SIZE_OS>(sceneout[s][0]);
+            sdsp::hardclip_block8<BLOCK_SIZE_OS>(sceneout[s][1]);
+            break;
+        case SurgeStorage::HARDCLIP_TO_0DBFS:
+            sdsp::hardclip_block<BLOCK_SIZE_OS>(sceneout[s][0]);
+            sdsp::hardclip_block<BLOCK_SIZE_OS>(sceneout[s][1]);
+            break;
+        case SurgeStorage::BYPASS_HARDCLIP:
+            break;
+        }
+
+        halfband.process_block_D2(sceneout[s][0], sceneout[s][1], BLOCK_SIZE_OS);
+    }
+
+    /*
+     * ABOVE: Oversampled, Below, Regular sample. So BLOCK_SIZE_OS above BLOCK_SIZE below
+     */
+
+    if (storage.getPatch().scene[s].lowcut.deactivated == false)
+    {
+        auto freq =
+            storage.getPatch().scenedata[s][storage.getPatch().scene[s].lowcut.param_id_in_scene].f;
+
+        auto slope = storage.getPatch().scene[s].lowcut.deform_type;
+
+        for (int i = 0; i <= slope; i++)
+        {
+            hp[i].coeff_HP(hp[i].calc_omega(freq / 12.0), 0.4); // var 0.707
+            hp[i].process_block(sceneout[s][0], sceneout[s][1]); // TODO: quadify
+        }
+    }
+
+    switch (storage.sceneHardclipMode[s])
+    {
+    case SurgeStorage::HARDCLIP_TO_18DBFS:
+        sdsp::hardclip_block8<BLOCK_SIZE>(sceneout[s][0]);
+        sdsp::hardclip_block8<BLOCK_SIZE>(sceneout[s][1]);
+        break;
+    case SurgeStorage::HARDCLIP_TO_0DBFS:
+        sdsp::hardclip_block<BLOCK_SIZE>(sceneout[s][0]);
+        sdsp::hardclip_block<BLOCK_SIZE>(sceneout[s][1]);
+        break;
+    default:
+        break;
+    }
+}
+
+bool SurgeSynthesizer::renderSceneInsertFX(int s, int fx_bypass, bool sceneState)
+{
+    // TODO: FIX SCENE ASSUMPTION
+    static constexpr int insertSlots[n_scenes][4] = {
+        {fxslot_ains1, fxslot_ains2, fxslot_ains3, fxslot_ains4},
+        {fxslot_bins1, fxslot_bins2, fxslot_bins3, fxslot_bins4}};
+
+    if (fx_bypass != fxb_no_fx)
+    {
+        for (auto v : insertSlots[s])
+        {
+            if (fx[v] && !(storage.getPatch().fx_disable.val.i & (1 << v)))
+            {
+                SURGE_PROFILE_STAGE(stageProfiler, Surge::Profiling::fxStage(v));
+                sceneState = processFxSlot(v, sceneout[s][0], sceneout[s][1], sceneState);
+            }
+        }
+    }
+
+    switch (storage.sceneHardclipMode[s])
+    {
+    case SurgeStorage::HARDCLIP_TO_18DBFS:
+        sdsp::hardclip_block8<BLOCK_SIZE>(sceneout[s][0]);
+        sdsp::hardclip_block8<BLOCK_SIZE>(sceneout[s][1]);
+        break;
+    case SurgeStorage::HARDCLIP_TO_0DBFS:
+        sdsp::hardclip_block<BLOCK_SIZE>(sceneout[s][0]);
+        sdsp::hardclip_block<BLOCK_SIZE>(sceneout[s][1]);
+        break;
+    default:
+        break;
+    }
+
+    return sceneState;
+}
+
+bool SurgeSynthesizer::processFxSlot(int slot, float *dataL, float *dataR, bool indata_present)
+{
+    auto &fade = fxSwapFade[slot];
+
+    if (fade.dir == 0)
+    {
+        return fx[slot]->process_ringout(dataL, dataR, indata_present);
+    }
+
+    // sends are summed back in on top of the dry signal, so their bypass is silence
+    bool toSilence = (slot == fxslot_send1 || slot == fxslot_send2 || slot == fxslot_send3 ||
+                      slot == fxslot_send4);
+
+    if (fade.dir < 0 && fade.pos == 0)
+    {
+        // faded all the way out, waiting for the new instance
+        if (toSilence)
+        {
+            mech::clear_block<BLOCK_SIZE>(dataL);
+            mech::clear_block<BLOCK_SIZE>(dataR);
+        }
+        return toSilence ? false : indata_present;
+    }
+
+    float dryL alignas(16)[BLOCK_SIZE], dryR alignas(16)[BLOCK_SIZE];
+
+    if (toSilence)
+    {
+        mech::clear_block<BLOCK_SIZE>(dryL);
+        mech::clear_block<BLOCK_SIZE>(dryR);
+    }
+    else
+    {
+        mech::copy_from_to<BLOCK_SIZE>(dataL, dryL);
+        mech::copy_from_to<BLOCK_SIZE>(dataR, dryR);
+    }
+
+    bool res = fx[slot]->process_ringout(dataL, dataR, indata_present);
+
+    auto g0 = (float)fade.pos / fxSwapFadeBlocks;
+    auto g1 = (float)std::clamp(fade.pos + fade.dir, 0, fxSwapFadeBlocks) / fxSwapFadeBlocks;
+    auto dg = (g1 - g0) * BLOCK_SIZE_INV;
+
+    for (int i = 0; i < BLOCK_SIZE; ++i)
+    {
+        auto g = g0 + dg * (i + 1);
+        dataL[i] = dryL[i] + g * (dataL[i] - dryL[i]);
+        dataR[i] = dryR[i] + g * (dataR[i] - dryR[i]);
+    }
+
+    return res || (!toSilence && indata_present);
+}
+
+void SurgeSynthesizer::advanceFxSwapFades()
+{
+    for (auto &f : fxSwapFade)
+    {
+        if (f.dir < 0 && f.pos > 0)
+        {
+            f.pos--;
+        }
+        else if (f.dir > 0 && ++f.pos >= fxSwapFadeBlocks)
+        {
+            f.pos = fxSwapFadeBlocks;
+            f.dir = 0;
+        }
+    }
+}
+
+void SurgeSynthesizer::setSpawnEffectsInBackground(bool b)
+{
+    if (b && !fxSpawner)
+    {
+        fxSpawner = std::make_unique<Surge::Threading::FxSpawnService>(&storage);
+    }
+
+    spawnEffectsInBackground = b;
+}
+
+void SurgeSynthesizer::waitForBackgroundFxWork()
+{
+    if (fxSpawner)
+        fxSpawner->waitUntilIdle();
+}
+
+void SurgeSynthesizer::freeRetiredVoices(int s)
+{
+    /*
+     * Voices which finish during a block are parked in retiredVoices until their whole scene
+     * has rendered. That lets the render run on a worker without touching the shared ended-note
+     * bookkeeping, and since a voice only leaves voiceTable when it is freed, the ended-note
+     * notifications come out exactly as if each voice was freed the moment it finished.
+     */
+    for (auto v : retiredVoices[s])
+    {
+        freeVoice(v);
+    }
+    retiredVoices[s].clear();
+}
+
+bool SurgeSynthesizer::canRenderScenesInParallel() const
+{
+    if (!sceneRenderPool)
+        return false;
+
+    // an audio input oscillator in scene B listens to scene A
+    if (storage.otherscene_clients > 0)
+        return false;
+
+    // and an audio input effect can listen to either scene
+    for (int s = 0; s < n_scenes; s++)
+    {
+        if (storage.scenesOutputData.thereAreClients(s))
+            return false;
+    }
+
+    // formula modulators all share one lua state, so keep them on one thread
+    for (int s = 0; s < n_scenes; s++)
+    {
+        for (int l = 0; l < n_lfos_voice; l++)
+        {
+            if (storage.getPatch().scene[s].lfo[l].shape.val.i == lt_formula)
+                return false;
+        }
+    }
+
+    // string oscillators swap delay lines mid block, from pools both scenes share
+    for (int s = 0; s < n_scenes; s++)
+    {
+        for (int o = 0; o < n_oscs; o++)
+        {
+            if (storage.getPatch().scene[s].osc[o].type.val.i == ot_string)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+void SurgeSynthesizer::renderSceneJob(void *ctx, int s)
+{
+    auto job = static_cast<ParallelSceneRender *>(ctx);
+    auto synth = job->synth;
+
+    // the same per scene generator the serial fallback uses, so neither thread touches rngGen
+    SurgeStorage::threadRNGOverride = &synth->sceneRNGGen[s];
+
+    job->vcount[s] = synth->renderSceneVoices(s);
+    synth->renderSceneFilterBlock(s);
+    synth->renderScenePostFilter(s, job->play_scene[s]);
+
+    for (int channel = 0; channel < N_OUTPUTS; channel++)
+        synth->storage.scenesOutputData.provideSceneData(s, channel, synth->sceneout[s][channel]);
+
+    job->sc_state[s] = synth->renderSceneInsertFX(s, job->fx_bypass, job->play_scene[s]);
+
+    SurgeStorage::threadRNGOverride = nullptr;
+}
+
+void SurgeSynthesizer::setRenderScenesInParallel(bool b)
+{
+    if (b && !sceneRenderPool)
+    {
+        sceneRenderPool = std::make_unique<Surge::Threading::SceneRenderPool>(n_scenes - 1);
+    }
+
+    renderScenesInParallel.store(b, std::memory_order_release);
+}
+
 void SurgeSynthesizer::process()
 {
 #if DEBUG_RNG_THREADING
@@ -4577,6 +5105,7 @@ void SurgeSynthesizer::process()
 #endif
 
     auto process_start = std::chrono::high_resolution_clock::now();
+    SURGE_PROFILE_STAGE(stageProfiler, Surge::Profiling::ps_block);
 
     if (hostNoteEndedToPushToNextBlock)
     {
@@ -4679,8 +5208,10 @@ void SurgeSynthesizer::process()
         }
     }
 
-    storage.modRoutingMutex.lock();
-    processControl();
+    {
+        SURGE_PROFILE_STAGE(stageProfiler, Surge::Profiling::ps_process_control);
+        processControl();
+    }
 
     amp.set_target_smoothed(
         storage.db_to_linear(storage.getPatch().globaldata[storage.getPatch().volume.id].f));
@@ -4713,259 +5244,95 @@ void SurgeSynthesizer::process()
         }
     }
 
-    list<SurgeVoice *>::iterator iter;
-
     for (int sc = 0; sc < n_scenes; sc++)
     {
         play_scene[sc] = (!voices[sc].empty());
     }
 
-    int FBentry[n_scenes];
-    int vcount = 0;
-
-    for (int s = 0; s < n_scenes; s++)
-    {
-        FBentry[s] = 0;
-        iter = voices[s].begin();
-        while (iter != voices[s].end())
-        {
-            SurgeVoice *v = *iter;
-            assert(v);
-            bool resume = v->process_block(FBQ[s][FBentry[s] >> 2], FBentry[s] & 3);
-            FBentry[s]++;
-
-            vcount++;
-
-            if (!resume)
-            {
-                freeVoice(v);
-                iter = voices[s].erase(iter);
-            }
-            else
-                iter++;
-        }
-
-        storage.modRoutingMutex.unlock();
-
-        using sst::filters::FilterType, sst::filters::FilterSubType;
-        fbq_global g;
-        if (storage.getPatch().scene[s].filterunit[0].type.deactivated)
-        {
-            g.FU1ptr = nullptr;
-        }
-        else
-        {
-            g.FU1ptr = sst::filters::GetQFPtrFilterUnit(
-                static_cast<FilterType>(storage.getPatch().scene[s].filterunit[0].type.val.i),
-                static_cast<FilterSubType>(
-                    storage.getPatch().scene[s].filterunit[0].subtype.val.i));
-        }
-        if (storage.getPatch().scene[s].filterunit[1].type.deactivated)
-        {
-            g.FU2ptr = nullptr;
-        }
-        else
-        {
-            g.FU2ptr = sst::filters::GetQFPtrFilterUnit(
-                static_cast<FilterType>(storage.getPatch().scene[s].filterunit[1].type.val.i),
-                static_cast<FilterSubType>(
-                    storage.getPatch().scene[s].filterunit[1].subtype.val.i));
-        }
-
-        if (storage.getPatch().scene[s].wsunit.type.deactivated)
-        {
-            g.WSptr = nullptr;
-        }
-        else
-        {
-            g.WSptr =
-                sst::waveshapers::GetQuadWaveshaper(static_cast<sst::waveshapers::WaveshaperType>(
-                    storage.getPatch().scene[s].wsunit.type.val.i));
-        }
-
-        FBQFPtr ProcessQuadFB =
-            GetFBQPointer(storage.getPatch().scene[s].filterblock_configuration.val.i,
-                          g.FU1ptr != 0, g.WSptr != 0, g.FU2ptr != 0);
-
-        for (int e = 0; e < FBentry[s]; e += 4)
-        {
-            int units = FBentry[s] - e;
-            for (int i = units; i < 4; i++)
-            {
-                FBQ[s][e >> 2].FU[0].active[i] = 0;
-                FBQ[s][e >> 2].FU[1].active[i] = 0;
-                FBQ[s][e >> 2].FU[2].active[i] = 0;
-                FBQ[s][e >> 2].FU[3].active[i] = 0;
-            }
-            ProcessQuadFB(FBQ[s][e >> 2], g, sceneout[s][0], sceneout[s][1]);
-        }
-
-        if (s == 0 && storage.otherscene_clients > 0)
-        {
-            // Make available for scene B
-            mech::copy_from_to<BLOCK_SIZE_OS>(sceneout[0][0], storage.audio_otherscene[0]);
-            mech::copy_from_to<BLOCK_SIZE_OS>(sceneout[0][1], storage.audio_otherscene[1]);
-        }
-
-        iter = voices[s].begin();
-
-        while (iter != voices[s].end())
-        {
-            SurgeVoice *v = *iter;
-            assert(v);
-            v->GetQFB(); // save filter state in voices after quad processing is done
-            iter++;
-        }
-
-        storage.modRoutingMutex.lock();
-
-        // mute scene
-        if (storage.getPatch().scene[s].volume.deactivated)
-        {
-            mech::clear_block<BLOCK_SIZE_OS>(sceneout[s][0]);
-            mech::clear_block<BLOCK_SIZE_OS>(sceneout[s][1]);
-        }
-    }
-
-    storage.modRoutingMutex.unlock();
-    storage.activeVoiceCount = vcount;
-
     // TODO: FIX SCENE ASSUMPTION
-    if (play_scene[0])
-    {
-        switch (storage.sceneHardclipMode[0])
-        {
-        case SurgeStorage::HARDCLIP_TO_18DBFS:
-            sdsp::hardclip_block8<BLOCK_SIZE_OS>(sceneout[0][0]);
-            sdsp::hardclip_block8<BLOCK_SIZE_OS>(sceneout[0][1]);
-            break;
-        case SurgeStorage::HARDCLIP_TO_0DBFS:
-            sdsp::hardclip_block<BLOCK_SIZE_OS>(sceneout[0][0]);
-            sdsp::hardclip_block<BLOCK_SIZE_OS>(sceneout[0][1]);
-            break;
-        case SurgeStorage::BYPASS_HARDCLIP:
-            break;
-        }
+    bool sc_state[n_scenes];
 
-        halfbandA.process_block_D2(sceneout[0][0], sceneout[0][1], BLOCK_SIZE_OS);
-    }
+    /*
+     * With parallel rendering on, each scene draws its random numbers from its own generator,
+     * reseeded from rngGen every block, whichever thread ends up rendering it. So a block that
+     * falls back to the serial path makes the same draws as a parallel one. With it off, the
+     * scenes draw from rngGen in turn as they always have, and rngGen isn't advanced here.
+     */
+    bool parallelScenes = renderScenesInParallel.load(std::memory_order_acquire);
+    SurgeStorage::RNGGen *sceneRNG[n_scenes]{};
 
-    if (play_scene[1])
+    if (parallelScenes)
     {
-        switch (storage.sceneHardclipMode[1])
+        for (int s = 0; s < n_scenes; s++)
         {
-        case SurgeStorage::HARDCLIP_TO_18DBFS:
-            sdsp::hardclip_block8<BLOCK_SIZE_OS>(sceneout[1][0]);
-            sdsp::hardclip_block8<BLOCK_SIZE_OS>(sceneout[1][1]);
-            break;
-        case SurgeStorage::HARDCLIP_TO_0DBFS:
-            sdsp::hardclip_block<BLOCK_SIZE_OS>(sceneout[1][0]);
-            sdsp::hardclip_block<BLOCK_SIZE_OS>(sceneout[1][1]);
-            break;
-        case SurgeStorage::BYPASS_HARDCLIP:
-            break;
+            sceneRNGGen[s].g.seed(storage.rngGen.g());
+            sceneRNG[s] = &sceneRNGGen[s];
         }
-
-        halfbandB.process_block_D2(sceneout[1][0], sceneout[1][1], BLOCK_SIZE_OS);
     }
 
-    /*
-     * ABOVE: Oversampled, Below, Regular sample. So BLOCK_SIZE_OS above BLOCK_SIZE below
-     */
-
-    // TODO: FIX SCENE ASSUMPTION
-    if (storage.getPatch().scene[0].lowcut.deactivated == false)
+    if (parallelScenes && play_scene[0] && play_scene[1] && canRenderScenesInParallel())
     {
-        auto freq =
-            storage.getPatch().scenedata[0][storage.getPatch().scene[0].lowcut.param_id_in_scene].f;
-
-        auto slope = storage.getPatch().scene[0].lowcut.deform_type;
+        /*
+         * Each scene runs voices through insert FX on its own thread. They all read the
+         * routing snapshot processControl acquired, which stays alive for the whole block.
+         */
+        ParallelSceneRender job;
+        job.synth = this;
+        job.fx_bypass = fx_bypass;
 
-        for (int i = 0; i <= slope; i++)
+        for (int s = 0; s < n_scenes; s++)
         {
-            hpA[i].coeff_HP(hpA[i].calc_omega(freq / 12.0), 0.4); // var 0.707
-            hpA[i].process_block(sceneout[0][0], sceneout[0][1]); // TODO: quadify
+            job.play_scene[s] = play_scene[s];
         }
-    }
 
-    if (storage.getPatch().scene[1].lowcut.deactivated == false)
-    {
-        auto freq =
-            storage.getPatch().scenedata[1][storage.getPatch().scene[1].lowcut.param_id_in_scene].f;
+        sceneRenderPool->run(&SurgeSynthesizer::renderSceneJob, &job, n_scenes);
 
-        auto slope = storage.getPatch().scene[1].lowcut.deform_type;
+        int vcount = 0;
 
-        for (int i = 0; i <= slope; i++)
+        for (int s = 0; s < n_scenes; s++)
         {
-            hpB[i].coeff_HP(hpB[i].calc_omega(freq / 12.0), 0.4); // var 0.707
-            hpB[i].process_block(sceneout[1][0], sceneout[1][1]); // TODO: quadify
+            freeRetiredVoices(s);
+            vcount += job.vcount[s];
+            sc_state[s] = job.sc_state[s];
         }
-    }
 
-    for (int cls = 0; cls < n_scenes; ++cls)
+        storage.activeVoiceCount = vcount;
+    }
+    else
     {
-        switch (storage.sceneHardclipMode[cls])
+        int vcount = 0;
+
+        for (int s = 0; s < n_scenes; s++)
         {
-        case SurgeStorage::HARDCLIP_TO_18DBFS:
-            sdsp::hardclip_block8<BLOCK_SIZE>(sceneout[cls][0]);
-            sdsp::hardclip_block8<BLOCK_SIZE>(sceneout[cls][1]);
-            break;
-        case SurgeStorage::HARDCLIP_TO_0DBFS:
-            sdsp::hardclip_block<BLOCK_SIZE>(sceneout[cls][0]);
-            sdsp::hardclip_block<BLOCK_SIZE>(sceneout[cls][1]);
-            break;
-        default:
-            break;
+            SurgeStorage::threadRNGOverride = sceneRNG[s];
+            vcount += renderSceneVoices(s);
+            freeRetiredVoices(s);
+            renderSceneFilterBlock(s);
         }
-    }
-
-    // TODO: FIX SCENE ASSUMPTION
-    bool sc_state[n_scenes];
 
-    for (int i = 0; i < n_scenes; i++)
-    {
-        sc_state[i] = play_scene[i];
-    }
+        storage.activeVoiceCount = vcount;
 
-    for (int i = 0; i < n_scenes; i++)
-        for (int channel = 0; channel < N_OUTPUTS; channel++)
-            storage.scenesOutputData.provideSceneData(i, channel, sceneout[i][channel]);
-
-    // apply insert effects
-    if (fx_bypass != fxb_no_fx)
-    {
-        for (auto v : {fxslot_ains1, fxslot_ains2, fxslot_ains3, fxslot_ains4})
+        for (int s = 0; s < n_scenes; s++)
         {
-            if (fx[v] && !(storage.getPatch().fx_disable.val.i & (1 << v)))
-            {
-                sc_state[0] = fx[v]->process_ringout(sceneout[0][0], sceneout[0][1], sc_state[0]);
-            }
+            SurgeStorage::threadRNGOverride = sceneRNG[s];
+            renderScenePostFilter(s, play_scene[s]);
         }
 
-        for (auto v : {fxslot_bins1, fxslot_bins2, fxslot_bins3, fxslot_bins4})
+        for (int i = 0; i < n_scenes; i++)
         {
-            if (fx[v] && !(storage.getPatch().fx_disable.val.i & (1 << v)))
-            {
-                sc_state[1] = fx[v]->process_ringout(sceneout[1][0], sceneout[1][1], sc_state[1]);
-            }
+            sc_state[i] = play_scene[i];
+
+            for (int channel = 0; channel < N_OUTPUTS; channel++)
+                storage.scenesOutputData.provideSceneData(i, channel, sceneout[i][channel]);
         }
-    }
 
-    for (int cls = 0; cls < n_scenes; ++cls)
-    {
-        switch (storage.sceneHardclipMode[cls])
+        for (int s = 0; s < n_scenes; s++)
         {
-        case SurgeStorage::HARDCLIP_TO_18DBFS:
-            sdsp::hardclip_block8<BLOCK_SIZE>(sceneout[cls][0]);
-            sdsp::hardclip_block8<BLOCK_SIZE>(sceneout[cls][1]);
-            break;
-        case SurgeStorage::HARDCLIP_TO_0DBFS:
-            sdsp::hardclip_block<BLOCK_SIZE>(sceneout[cls][0]);
-            sdsp::hardclip_block<BLOCK_SIZE>(sceneout[cls][1]);
-            break;
-        default:
-            break;
+            SurgeStorage::threadRNGOverride = sceneRNG[s];
+            sc_state[s] = renderSceneInsertFX(s, fx_bypass, sc_state[s]);
         }
+
+        SurgeStorage::threadRNGOverride = nullptr;
     }
 
     // sum scenes
@@ -4987,12 +5354,13 @@ void SurgeSynthesizer::process()
 
             if (fx[slot] && !(storage.getPatch().fx_disable.val.i & (1 << slot)))
             {
+                SURGE_PROFILE_STAGE(stageProfiler, Surge::Profiling::fxStage(slot));
                 send[idx][0].MAC_2_blocks_to(sceneout[0][0], sceneout[0][1], fxsendout[idx][0],
                                              fxsendout[idx][1], BLOCK_SIZE_QUAD);
                 send[idx][1].MAC_2_blocks_to(sceneout[1][0], sceneout[1][1], fxsendout[idx][0],
                                              fxsendout[idx][1], BLOCK_SIZE_QUAD);
-                sendused[idx] = fx[slot]->process_ringout(fxsendout[idx][0], fxsendout[idx][1],
-                                                          sc_state[0] || sc_state[1]);
+                sendused[idx] = processFxSlot(slot, fxsendout[idx][0], fxsendout[idx][1],
+                                              sc_state[0] || sc_state[1]);
                 FX[idx].MAC_2_blocks_to(fxsendout[idx][0], fxsendout[idx][1], output[0], output[1],
                                         BLOCK_SIZE_QUAD);
             }
@@ -5010,11 +5378,14 @@ void SurgeSynthesizer::process()
         {
             if (fx[v] && !(storage.getPatch().fx_disable.val.i & (1 << v)))
             {
-                glob = fx[v]->process_ringout(output[0], output[1], glob);
+                SURGE_PROFILE_STAGE(stageProfiler, Surge::Profiling::fxStage(v));
+                glob = processFxSlot(v, output[0], output[1], glob);
             }
         }
     }
 
+    SURGE_PROFILE_STAGE(stageProfiler, Surge::Profiling::ps_output);
+
     amp.multiply_2_blocks(output[0], output[1], BLOCK_SIZE_QUAD);
     amp_mute.multiply_2_blocks(output[0], output[1], BLOCK_SIZE_QUAD);
 
@@ -5052,6 +5423,8 @@ void SurgeSynthesizer::process()
         amp_mute.multiply_2_blocks(sceneout[sc][0], sceneout[sc][1], BLOCK_SIZE_QUAD);
     }
 
+    advanceFxSwapFades();
+
     // Calculate how close we are to overloading the CPU
     // (how close is the process() duration to duration)
     auto process_end = std::chrono::high_resolution_clock::now();
@@ -5308,6 +5681,7 @@ void SurgeSynthesizer::swapMetaControllers(int c1, int c2)
         }
     }
 
+    storage.publishModulationRoutings();
     storage.modRoutingMutex.unlock();
 
     refresh_editor = true;
@@ -5494,6 +5868,8 @@ void SurgeSynthesizer::reorderFx(int source, int target, FXReorderMode m)
         mv->erase(mv->begin() + *dt);
     }
 
+    storage.publishModulationRoutings();
+
     if (m != FXReorderMode::COPY)
     {
         fx_reload[source] = true;
@@ -5564,6 +5940,10 @@ void SurgeSynthesizer::reclaimVoiceFor(SurgeVoice *v, char key, char channel, ch
 
     v->host_note_id = host_noteid;
     v->originating_host_channel = host_originating_channel;
+
+    int vs, slot;
+    if (findVoiceSlot(v, vs, slot))
+        voiceTable.reassignNoteId(vs, slot, host_noteid);
     v->originating_host_key = host_originating_key;
 
     channelState[channel].keyState[key].voiceOrder = voiceCounter++;
@@ -5575,19 +5955,7 @@ void SurgeSynthesizer::reclaimVoiceFor(SurgeVoice *v, char key, char channel, ch
     v->resetPortamentoFrom(priorKey, channel);
 
     // Now end this note unless it is used by another scene
-    bool endHostVoice = true;
-    for (auto s = 0; s < n_scenes; ++s)
-    {
-        if (s == scene)
-            continue;
-        for (auto v : voices[s])
-        {
-            if (v->host_note_id == priorNoteId)
-            {
-                endHostVoice = false;
-            }
-        }
-    }
+    bool endHostVoice = voiceTable.countOutsideScene(priorNoteId, scene) == 0;
     if (endHostVoice)
         notifyEndedNote(priorNoteId, priorKey, priorChannel, false);
 }
@@ -26,6 +26,10 @@
 #include "SurgeVoice.h"
 #include "Effect.h"
 #include "BiquadFilter.h"
+#include "SceneRenderPool.h"
+#include "ActiveVoiceTable.h"
+#include "FxSpawnService.h"
+#include "StageProfiler.h"
 #include <set>
 #include <sst/filters/HalfRateFilter.h>
 
@@ -105,7 +109,16 @@ class alignas(16) SurgeSynthesizer
     void programChange(char channel, int value);
     void allNotesOff();
     void allSoundOff();
+    // not realtime safe, so never from the audio callback; see SurgeStorage::setSamplerate
     void setSamplerate(float sr);
+
+    /*
+     * Puts every random stream the engine draws from back to a fixed start: the storage RNG,
+     * which voices and oscillators take their random phases and drift from, and each scene's
+     * random and alternate modulators. Offline renderers which reuse an instance call this so
+     * that what they render doesn't depend on what the instance rendered before.
+     */
+    void resetRandomState(unsigned int seed);
     void updateHighLowKeys(int scene);
     int getNumInputs() { return N_INPUTS; }
     int getNumOutputs() { return N_OUTPUTS; }
@@ -145,6 +158,28 @@ class alignas(16) SurgeSynthesizer
      */
     std::mutex fxSpawnMutex;
     std::mutex patchLoadSpawnMutex;
+
+    /*
+     * With this on, live FX type changes construct the new effect on a worker thread and
+     * crossfade through bypass (silence, for sends) from the old instance to the new one over
+     * fxSwapFadeBlocks each way. Patch loads still swap every slot immediately, building the
+     * new effects wherever the load runs. A patch queued with enqueuePatchForLoad is loaded by
+     * processEnqueuedPatchIfNeeded at the start of processControl, so that is on the audio
+     * thread, and it allocates there just as the rest of the patch load does.
+     */
+    void setSpawnEffectsInBackground(bool b); // call from the UI thread, not the audio thread
+    std::atomic<bool> spawnEffectsInBackground{false};
+    static constexpr int fxSwapFadeBlocks = 16;
+
+    // how far in a background FX swap has faded slot: 1 is fully wet, 0 is bypassed
+    float fxSwapWetGain(int slot) const { return (float)fxSwapFade[slot].pos / fxSwapFadeBlocks; }
+
+    /*
+     * Not the audio thread. Wait until the FX worker has built, freed and published everything
+     * the blocks so far asked it to, so that stepping process() and this in turn renders a
+     * background swap the same every time.
+     */
+    void waitForBackgroundFxWork();
     enum FXReorderMode
     {
         NONE,
@@ -165,15 +200,19 @@ class alignas(16) SurgeSynthesizer
     int getNonUltrareleaseVoices(int scene) const;
     int getNonReleasedVoices(int scene) const;
 
+    typedef Surge::VoiceManagement::VoiceList<SurgeVoice, MAX_VOICES> VoiceList;
+
     SurgeVoice *getUnusedVoice(int scene); // not const since it updates voice state
+    void activateVoice(int scene, SurgeVoice *v); // call once the voice is constructed
     void freeVoice(SurgeVoice *);
+    bool findVoiceSlot(const SurgeVoice *v, int &scene, int &slot) const;
     void reclaimVoiceFor(SurgeVoice *v, char key, char channel, char velocity, int scene,
                          int host_note_id, int host_originating_channel, int host_originating_key,
                          bool envFromZero = false);
     void notifyEndedNote(int32_t nid, int16_t key, int16_t chan, bool thisBlock = true);
-    std::array<std::array<SurgeVoice, MAX_VOICES>, 2> voices_array;
-    // TODO: FIX SCENE ASSUMPTION!
-    unsigned int voices_usedby[2][MAX_VOICES]; // 0 indicates no user, 1 is scene A, 2 is scene B
+    std::array<std::array<SurgeVoice, MAX_VOICES>, n_scenes> voices_array;
+    // which slots of voices_array are in use, and which host note ids they carry
+    Surge::VoiceManagement::ActiveVoiceTable<n_scenes, MAX_VOICES> voiceTable;
 
     int64_t voiceCounter = 1L;
 
@@ -494,6 +533,14 @@ class alignas(16) SurgeSynthesizer
     float vu_peak[8]{};
     std::atomic<float> cpu_level{0.f};
 
+#if SURGE_STAGE_PROFILER
+    /*
+     * Per-stage timing histograms for process(). Only present when built with
+     * SURGE_BUILD_STAGE_PROFILER, and safe to read and reset from any thread.
+     */
+    Surge::Profiling::StageProfiler stageProfiler;
+#endif
+
     void populateDawExtraState();
 
     void loadFromDawExtraState();
@@ -504,7 +551,7 @@ class alignas(16) SurgeSynthesizer
     bool approachingAllSoundOff{false};
     // TODO: FIX SCENE ASSUMPTION (for halfbandA/B - use std::array)
     sst::filters::HalfRate::HalfRateFilter halfbandA, halfbandB, halfbandIN;
-    std::list<SurgeVoice *> voices[n_scenes];
+    VoiceList voices[n_scenes];
     std::unique_ptr<Effect> fx[n_fx_slots];
     std::atomic<bool> halt_engine;
     MidiChannelState channelState[16];
@@ -567,6 +614,36 @@ class alignas(16) SurgeSynthesizer
     void stopSound();
 
     QuadFilterChainState *FBQ[n_scenes];
+    int FBentry[n_scenes]{};
+
+    /*
+     * Run the filter block two quads at a time with the 8 wide chain (see GetFBQWidePointer).
+     * It is off unless a host asks for it, and is ignored on a CPU without AVX. Its output is
+     * only held to within 1e-6 of the quad chain, so leaving it off keeps a render the same on
+     * every machine.
+     */
+    bool useWideFilterChain{false};
+
+    /*
+     * Parallel scene rendering. When it is on and nothing in the block couples the scenes
+     * (see canRenderScenesInParallel), each scene's voices, filter block, halfband, lowcut and
+     * insert FX render on their own thread, and we join before the send and global FX. The
+     * per-scene stages below are also what the serial path runs, so the two match exactly.
+     * While it is on, each scene also draws random numbers from its own stream, so noise and
+     * drift render the same whether a block ran in parallel or fell back to serial, but not
+     * the same as with the mode off, where the scenes share rngGen as before.
+     */
+    void setRenderScenesInParallel(bool b); // call from the UI thread, not the audio thread
+    bool getRenderScenesInParallel() const { return renderScenesInParallel; }
+    bool canRenderScenesInParallel() const;
+
+    int renderSceneVoices(int scene);
+    void renderSceneFilterBlock(int scene);
+    void renderScenePostFilter(int scene, bool playScene);
+    bool renderSceneInsertFX(int scene, int fx_bypass, bool sceneState);
+    void freeRetiredVoices(int scene);
+
+    VoiceList retiredVoices[n_scenes];
 
     std::string hostProgram = "Unknown Host";
     std::string juceWrapperType = "Unknown Wrapper Type";
@@ -580,6 +657,34 @@ class alignas(16) SurgeSynthesizer
   private:
     PluginLayer *_parent = nullptr;
 
+    struct ParallelSceneRender
+    {
+        SurgeSynthesizer *synth{nullptr};
+        int fx_bypass{0};
+        bool play_scene[n_scenes]{};
+        bool sc_state[n_scenes]{};
+        int vcount[n_scenes]{};
+    };
+    static void renderSceneJob(void *ctx, int scene);
+
+    bool processFxSlot(int slot, float *dataL, float *dataR, bool indata_present);
+    void finishModulationRoutingChanges();
+    bool routingPublishPending{false};
+    void advanceFxSwapFades();
+
+    struct FxSwapFade
+    {
+        int pos{fxSwapFadeBlocks}; // wet gain is pos / fxSwapFadeBlocks
+        int dir{0};                // -1 fading out the old instance, 1 fading in the new
+    } fxSwapFade[n_fx_slots];
+    std::unique_ptr<Surge::Threading::FxSpawnService> fxSpawner;
+
+    bool wideFilterChainAvailable{false};
+
+    std::atomic<bool> renderScenesInParallel{false};
+    std::unique_ptr<Surge::Threading::SceneRenderPool> sceneRenderPool;
+    SurgeStorage::RNGGen sceneRNGGen[n_scenes];
+
     void switch_toggled();
 
     // MIDI control interpolators
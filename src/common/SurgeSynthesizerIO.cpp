@@ -29,7 +29,9 @@
 #include <algorithm>
 #include <fstream>
 #include <iterator>
+#include "SharedStorage.h"
 #include "SurgeMemoryPools.h"
+#include "WavetableBuildService.h"
 
 #include "sst/basic-blocks/mechanics/endian-ops.h"
 #include "PatchFileHeaderStructs.h"
@@ -405,6 +407,13 @@ void SurgeSynthesizer::processEnqueuedPatchIfNeeded()
     bool expected = true;
     if (rawLoadEnqueued.compare_exchange_weak(expected, true) && expected)
     {
+        /*
+         * The load replaces every routing. If an editor holds the routing lock, leave the
+         * load enqueued and try again next block rather than wait for it.
+         */
+        if (!storage.tryBeginModulationRoutingChanges())
+            return;
+
         {
             // If we are forcing values on, we don't want to do any enqueued loads
             // or want to wait for them to complete
@@ -417,6 +426,10 @@ void SurgeSynthesizer::processEnqueuedPatchIfNeeded()
         loadRaw(enqueuedLoadData.get(), enqueuedLoadSize);
         loadFromDawExtraState();
 
+        // loadRaw's own batch nests inside ours, so the publish falls to us
+        if (storage.endModulationRoutingChanges())
+            storage.publishModulationRoutings();
+
         rawLoadNeedsUIDawExtraState = true;
         refresh_editor = true;
     }
@@ -424,15 +437,22 @@ void SurgeSynthesizer::processEnqueuedPatchIfNeeded()
 
 void SurgeSynthesizer::loadRaw(const void *data, int size, bool preset)
 {
+    // the load replaces every routing, and loadFx clears some more; publish all that once
+    storage.beginModulationRoutingChanges();
+
     halt_engine = true;
     stopSound();
     for (int s = 0; s < n_scenes; s++)
         for (int i = 0; i < n_customcontrollers; i++)
             storage.getPatch().scene[s].modsources[ms_ctrl1 + i]->reset();
 
+    if (storage.wavetableBuilder)
+        storage.wavetableBuilder->cancelAll();
+
     storage.getPatch().init_default_values();
     storage.getPatch().load_patch(data, size, preset);
     storage.getPatch().update_controls(false, nullptr, true);
+    storage.publishModulationRoutings();
     for (int i = 0; i < n_fx_slots; i++)
     {
         fxsync[i] = storage.getPatch().fx[i];
@@ -458,6 +478,14 @@ void SurgeSynthesizer::loadRaw(const void *data, int size, bool preset)
         }
     }
 
+    /*
+     * This one stays on the calling thread even when that is the audio thread: the load has
+     * parsed and allocated all the way through anyway, and the first block of the new patch
+     * has to render with its own routings.
+     */
+    if (storage.endModulationRoutingChanges())
+        storage.publishModulationRoutings();
+
     storage.getPatch().isDirty = false;
 
     halt_engine = false;
@@ -666,6 +694,10 @@ void SurgeSynthesizer::savePatchToPath(fs::path filename, bool refreshPatchList)
 
     if (refreshPatchList)
     {
+        // writing over a patch doesn't touch its folder, so the scan cache can't notice
+        if (storage.scanCache)
+            storage.scanCache->forget(filename.parent_path());
+
         // refresh list
         storage.refresh_patchlist();
         storage.initializePatchDb(true);
@@ -69,6 +69,12 @@ std::string defaultKeyToString(DefaultKey k)
     case MIDISoftTakeover:
         r = "MIDISoftTakeover";
         break;
+    case RenderScenesInParallel:
+        r = "renderScenesInParallel";
+        break;
+    case NeverAllocateOnAudioThread:
+        r = "neverAllocateOnAudioThread";
+        break;
     case RestoreMSEGSnapFromPatch:
         r = "restoreMSEGSnapFromPatch";
         break;
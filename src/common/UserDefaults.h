@@ -103,6 +103,9 @@ enum DefaultKey
     SmoothingMode,
     MonoPedalMode,
 
+    RenderScenesInParallel,
+    NeverAllocateOnAudioThread,
+
     // these are persistent options sprinkled outside of the menu
     UseODDMTS_Deprecated,
     Use3DWavetableView,
@@ -0,0 +1,349 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#include "WavetableBuildService.h"
+
+#include <utility>
+#include <vector>
+
+namespace Surge
+{
+namespace Storage
+{
+WavetableBuildService::WavetableBuildService(SurgeStorage *s) : storage(s)
+{
+    scratchOsc = std::make_unique<OscillatorStorage>();
+    worker = std::thread(&WavetableBuildService::workerLoop, this);
+}
+
+WavetableBuildService::~WavetableBuildService()
+{
+    {
+        std::lock_guard<std::mutex> g(m);
+        keepRunning = false;
+    }
+    cv.notify_one();
+
+    if (worker.joinable())
+        worker.join();
+}
+
+bool WavetableBuildService::requestById(int scene, int osc, int id)
+{
+    std::unique_lock<std::mutex> lk(m, std::try_to_lock);
+
+    if (!lk.owns_lock())
+        return false;
+
+    auto &slot = slots[scene][osc];
+    auto &r = slot.request;
+    auto &wtl = storage->wt_list;
+    slot.requested = true;
+    r.id = id;
+    r.fromFile = false;
+    r.builtIn = wtl.empty() && id == 0;
+    r.filename.clear();
+    r.displayName.clear();
+
+    // an id out of range loads nothing, as load_wt does, but still becomes the current id
+    if (id >= 0 && id < (int)wtl.size())
+    {
+        r.filename = path_to_string(wtl[id].path);
+        r.displayName = wtl[id].name;
+    }
+
+    slot.requestGeneration++;
+
+    lk.unlock();
+    cv.notify_one();
+    return true;
+}
+
+bool WavetableBuildService::requestByFilename(int scene, int osc, std::string &filename)
+{
+    std::unique_lock<std::mutex> lk(m, std::try_to_lock);
+
+    if (!lk.owns_lock())
+        return false;
+
+    auto &slot = slots[scene][osc];
+    auto &r = slot.request;
+    slot.requested = true;
+    r.fromFile = true;
+    r.builtIn = false;
+    r.displayName.clear();
+    std::swap(r.filename, filename);
+    filename.clear();
+
+    // the same lookup the synchronous load makes
+    int ct = 0;
+    r.id = -1;
+
+    for (const auto &wti : storage->wt_list)
+    {
+        if (path_to_string(wti.path) == r.filename)
+        {
+            r.id = ct;
+        }
+        ct++;
+    }
+
+    slot.requestGeneration++;
+
+    lk.unlock();
+    cv.notify_one();
+    return true;
+}
+
+void WavetableBuildService::cancel(int scene, int osc)
+{
+    std::lock_guard<std::mutex> g(m);
+    auto &slot = slots[scene][osc];
+    slot.requested = false;
+    slot.requestGeneration++;
+}
+
+void WavetableBuildService::cancelAll()
+{
+    std::lock_guard<std::mutex> g(m);
+
+    for (auto &sc : slots)
+    {
+        for (auto &slot : sc)
+        {
+            slot.requested = false;
+            slot.requestGeneration++;
+        }
+    }
+}
+
+void WavetableBuildService::collect()
+{
+    bool anyInHand{false}, anyRetired{false};
+
+    {
+        std::unique_lock<std::mutex> lk(m, std::try_to_lock);
+
+        if (!lk.owns_lock())
+            return;
+
+        for (auto &sc : slots)
+        {
+            for (auto &slot : sc)
+            {
+                if (slot.inHand && slot.inHand->generation != slot.requestGeneration &&
+                    !slot.toRetire)
+                {
+                    slot.toRetire = std::move(slot.inHand);
+                }
+
+                if (slot.toRetire && !slot.retired)
+                {
+                    slot.retired = std::move(slot.toRetire);
+                    anyRetired = true;
+                }
+
+                if (slot.ready && !slot.inHand)
+                {
+                    if (slot.ready->generation == slot.requestGeneration)
+                    {
+                        slot.inHand = std::move(slot.ready);
+                    }
+                    else if (!slot.retired)
+                    {
+                        slot.retired = std::move(slot.ready);
+                        anyRetired = true;
+                    }
+                }
+
+                anyInHand |= (slot.inHand && !slot.toRetire);
+            }
+        }
+    }
+
+    if (anyRetired)
+        cv.notify_one();
+
+    if (!anyInHand)
+        return;
+
+    // the wavetable display reads tables under this lock, so if it's busy just wait a block
+    std::unique_lock<std::mutex> wtlk(storage->waveTableDataMutex, std::try_to_lock);
+
+    if (!wtlk.owns_lock())
+        return;
+
+    for (int sc = 0; sc < n_scenes; ++sc)
+    {
+        for (int o = 0; o < n_oscs; ++o)
+        {
+            auto &slot = slots[sc][o];
+
+            if (slot.inHand && !slot.toRetire)
+            {
+                apply(sc, o, *slot.inHand);
+                // which now holds the table we replaced
+                slot.toRetire = std::move(slot.inHand);
+            }
+        }
+    }
+}
+
+void WavetableBuildService::apply(int scene, int o, Built &b)
+{
+    auto &patch = storage->getPatch();
+    auto &osc = patch.scene[scene].osc[o];
+
+    if (osc.wt.everBuilt)
+        patch.isDirty = true;
+
+    osc.wt.current_id = b.currentId;
+
+    // a table loaded by id has no current filename, just as load_wt leaves it
+    if (b.setFilename)
+        std::swap(osc.wt.current_filename, b.currentFilename);
+
+    if (b.wt.everBuilt)
+    {
+        osc.wt.swapContents(b.wt);
+
+        if (!b.displayName.empty())
+            std::swap(osc.wavetable_display_name, b.displayName);
+
+        if (b.fromFile)
+        {
+            std::swap(osc.wavetable_script, b.script);
+            osc.wavetable_script_res_base = b.scriptResBase;
+            osc.wavetable_script_nframes = b.scriptNFrames;
+            osc.wt.refresh_script_editor = true;
+        }
+    }
+
+    osc.wt.force_refresh_display = b.fromFile;
+    osc.wt.refresh_display = true;
+}
+
+void WavetableBuildService::build(const Request &r, Built &b)
+{
+    auto *so = scratchOsc.get();
+    so->wavetable_display_name.clear();
+    so->wavetable_script.clear();
+    so->wavetable_script_res_base = 5;
+    so->wavetable_script_nframes = 10;
+
+    b.currentId = r.id;
+    b.fromFile = r.fromFile;
+    // we're off the audio thread, so the mip maps can fan out
+    b.wt.parallelMipMaps = true;
+
+    if (r.builtIn)
+    {
+        storage->load_wt_builtin(&b.wt, so);
+    }
+    else if (!r.filename.empty())
+    {
+        if (r.fromFile)
+            b.wt.queue_filename = r.filename;
+
+        storage->load_wt(r.filename, &b.wt, so);
+        b.currentFilename = b.wt.current_filename;
+        b.setFilename = true;
+
+        if (!r.fromFile)
+            so->wavetable_display_name = r.displayName;
+    }
+
+    b.displayName = std::move(so->wavetable_display_name);
+    b.script = std::move(so->wavetable_script);
+    b.scriptResBase = so->wavetable_script_res_base;
+    b.scriptNFrames = so->wavetable_script_nframes;
+}
+
+void WavetableBuildService::workerLoop()
+{
+    std::unique_lock<std::mutex> lk(m);
+
+    while (true)
+    {
+        cv.wait(lk, [this]() {
+            if (!keepRunning)
+                return true;
+
+            for (auto &sc : slots)
+                for (auto &slot : sc)
+                    if (slot.requested || slot.retired)
+                        return true;
+
+            return false;
+        });
+
+        if (!keepRunning)
+            break;
+
+        std::vector<std::unique_ptr<Built>> garbage;
+        int scene{-1}, osc{-1};
+        uint32_t generation{0};
+        Request request;
+
+        for (int sc = 0; sc < n_scenes; ++sc)
+        {
+            for (int o = 0; o < n_oscs; ++o)
+            {
+                auto &slot = slots[sc][o];
+
+                if (slot.retired)
+                    garbage.push_back(std::move(slot.retired));
+
+                if (slot.requested && scene < 0)
+                {
+                    scene = sc;
+                    osc = o;
+                    std::swap(request, slot.request);
+                    generation = slot.requestGeneration;
+                    slot.requested = false;
+                }
+            }
+        }
+
+        lk.unlock();
+
+        garbage.clear();
+
+        if (scene >= 0)
+        {
+            auto b = std::make_unique<Built>();
+            b->generation = generation;
+            build(request, *b);
+
+            lk.lock();
+            std::swap(b, slots[scene][osc].ready);
+            lk.unlock();
+
+            // b is now whatever superseded build was sitting there unclaimed, if any
+            b.reset();
+        }
+
+        lk.lock();
+    }
+}
+} // namespace Storage
+} // namespace Surge
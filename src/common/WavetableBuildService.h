@@ -0,0 +1,122 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+
+#ifndef SURGE_SRC_COMMON_WAVETABLEBUILDSERVICE_H
+#define SURGE_SRC_COMMON_WAVETABLEBUILDSERVICE_H
+
+#include "SurgeStorage.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace Surge
+{
+namespace Storage
+{
+/*
+ * Loads and builds queued wavetables (file I/O, BuildWT and the mip maps) on a worker
+ * thread, so the audio thread only ever exchanges table pointers with a finished build.
+ *
+ * Each oscillator has one slot. The audio thread posts the newest request into it, and a
+ * newer request simply supersedes an older one. Every build is tagged with the generation of
+ * the request it answers, and anything which no longer matches is thrown away. Tables
+ * swapped out of the patch go back to the worker to be freed, so the audio thread never
+ * allocates or frees.
+ *
+ * The audio thread only ever try_locks, here and on waveTableDataMutex. If either is busy it
+ * leaves things as they are and tries again next block.
+ */
+struct WavetableBuildService
+{
+    explicit WavetableBuildService(SurgeStorage *storage);
+    ~WavetableBuildService();
+
+    /*
+     * Audio thread. Return false if the request could not be posted without waiting, in
+     * which case leave it queued and try again next block. The filename version takes the
+     * contents of filename.
+     *
+     * Both look up what they need from wt_list here, on the thread that queued the load,
+     * and post the resolved path. The worker never reads wt_list, which the UI can rescan
+     * at any time.
+     */
+    bool requestById(int scene, int osc, int id);
+    bool requestByFilename(int scene, int osc, std::string &filename);
+
+    // audio thread; swaps any finished tables into the patch
+    void collect();
+
+    // forget about in-flight builds for one or all oscillators, e.g. since a patch loaded
+    void cancel(int scene, int osc);
+    void cancelAll();
+
+  private:
+    struct Request
+    {
+        int id{-1};
+        bool fromFile{false}, builtIn{false};
+        std::string filename, displayName;
+    };
+
+    struct Built
+    {
+        uint32_t generation{0};
+        Wavetable wt;
+        int currentId{-1};
+        bool fromFile{false}, setFilename{false};
+        std::string currentFilename, displayName, script;
+        int scriptResBase{5}, scriptNFrames{10};
+    };
+
+    struct Slot
+    {
+        // guarded by m
+        bool requested{false};
+        Request request;
+        uint32_t requestGeneration{0};
+        std::unique_ptr<Built> ready, retired;
+
+        // audio thread only
+        std::unique_ptr<Built> inHand, toRetire;
+    };
+
+    void workerLoop();
+    void build(const Request &r, Built &b);
+    void apply(int scene, int osc, Built &b);
+
+    SurgeStorage *storage;
+    std::unique_ptr<OscillatorStorage> scratchOsc;
+
+    Slot slots[n_scenes][n_oscs];
+    std::mutex m;
+    std::condition_variable cv;
+    bool keepRunning{true};
+    std::thread worker;
+};
+} // namespace Storage
+} // namespace Surge
+
+#endif // SURGE_SRC_COMMON_WAVETABLEBUILDSERVICE_H
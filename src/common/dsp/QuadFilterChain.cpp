@@ -451,6 +451,478 @@ FBQFPtr GetFBQPointer(int config, bool A, bool WS, bool B)
     return 0;
 }
 
+/*
+ * The 8 wide chain. Everything here is compiled for AVX via a target attribute, rather than
+ * building the file with -mavx, so nothing else in the file (or anything inline it pulls in from
+ * a header) can end up with AVX instructions on a machine which doesn't have them.
+ */
+#if (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)) &&          \
+    !defined(_M_ARM64EC)
+#define SURGE_FBQ_HAS_WIDE 1
+#else
+#define SURGE_FBQ_HAS_WIDE 0
+#endif
+
+#if SURGE_FBQ_HAS_WIDE
+#include <immintrin.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define FBQ_WIDE_TARGET __attribute__((target("avx")))
+#define FBQ_WIDE_INLINE __attribute__((target("avx"), always_inline)) inline
+#else
+#define FBQ_WIDE_TARGET
+#define FBQ_WIDE_INLINE __forceinline
+#endif
+
+namespace
+{
+FBQ_WIDE_INLINE __m256 wideJoin(__m128 lo, __m128 hi)
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+}
+FBQ_WIDE_INLINE __m128 wideLo(__m256 v) { return _mm256_castps256_ps128(v); }
+FBQ_WIDE_INLINE __m128 wideHi(__m256 v) { return _mm256_extractf128_ps(v, 1); }
+
+FBQ_WIDE_INLINE __m256 wideSoftclip(__m256 v)
+{
+    return wideJoin(sdsp::softclip_ps(wideLo(v)), sdsp::softclip_ps(wideHi(v)));
+}
+
+FBQ_WIDE_INLINE __m256 wideFilter(sst::filters::FilterUnitQFPtr f, QuadFilterChainState &d0,
+                                  QuadFilterChainState &d1, int unit, __m256 v)
+{
+    return wideJoin(f(&d0.FU[unit], wideLo(v)), f(&d1.FU[unit], wideHi(v)));
+}
+
+FBQ_WIDE_INLINE __m256 wideShape(sst::waveshapers::QuadWaveshaperPtr f, QuadFilterChainState &d0,
+                                 QuadFilterChainState &d1, int unit, __m256 v, __m256 drive)
+{
+    return wideJoin(f(&d0.WSS[unit], wideLo(v), wideLo(drive)),
+                    f(&d1.WSS[unit], wideHi(v), wideHi(drive)));
+}
+
+/*
+ * Sums each quad's four voices the way mech::sum_ps_to_ss does and adds the first quad's total
+ * before the second's, so the rounding is the same as processing the quads in turn.
+ */
+FBQ_WIDE_INLINE void wideAccumulate(float *out, __m256 v)
+{
+    auto a = _mm256_add_ps(v, _mm256_permute_ps(v, _MM_SHUFFLE(3, 2, 3, 2)));
+    a = _mm256_add_ps(a, _mm256_permute_ps(a, _MM_SHUFFLE(0, 0, 0, 1)));
+    *out = (*out + _mm_cvtss_f32(wideLo(a))) + _mm_cvtss_f32(wideHi(a));
+}
+
+struct WideChainState
+{
+    __m256 Gain, FB, Mix1, Mix2, Drive;
+    __m256 dGain, dFB, dMix1, dMix2, dDrive;
+    __m256 wsLPF, FBlineL, FBlineR;
+    __m256 OutL, OutR, dOutL, dOutR;
+    __m256 Out2L, Out2R, dOut2L, dOut2R;
+    __m256 mask;
+};
+
+#define FBQ_WIDE_FIELDS(M)                                                                         \
+    M(Gain) M(FB) M(Mix1) M(Mix2) M(Drive) M(dGain) M(dFB) M(dMix1) M(dMix2) M(dDrive) M(wsLPF)    \
+        M(FBlineL) M(FBlineR) M(OutL) M(OutR) M(dOutL) M(dOutR) M(Out2L) M(Out2R) M(dOut2L)        \
+            M(dOut2R)
+
+FBQ_WIDE_INLINE void wideLoad(WideChainState &w, const QuadFilterChainState &d0,
+                              const QuadFilterChainState &d1)
+{
+#define FBQ_WIDE_LOAD(x) w.x = wideJoin(d0.x, d1.x);
+    FBQ_WIDE_FIELDS(FBQ_WIDE_LOAD)
+#undef FBQ_WIDE_LOAD
+    w.mask = wideJoin(SIMD_MM(load_ps)((float *)&d0.FU[0].active),
+                      SIMD_MM(load_ps)((float *)&d1.FU[0].active));
+}
+
+FBQ_WIDE_INLINE void wideStore(const WideChainState &w, QuadFilterChainState &d0,
+                               QuadFilterChainState &d1)
+{
+#define FBQ_WIDE_STORE(x)                                                                          \
+    d0.x = wideLo(w.x);                                                                            \
+    d1.x = wideHi(w.x);
+    FBQ_WIDE_FIELDS(FBQ_WIDE_STORE)
+#undef FBQ_WIDE_STORE
+}
+
+#define MWriteOutputsWide(x)                                                                       \
+    w.OutL = _mm256_add_ps(w.OutL, w.dOutL);                                                       \
+    w.OutR = _mm256_add_ps(w.OutR, w.dOutR);                                                       \
+    wideAccumulate(&OutL[k], _mm256_mul_ps(x, w.OutL));                                            \
+    wideAccumulate(&OutR[k], _mm256_mul_ps(x, w.OutR));
+
+#define MWriteOutputsDualWide(x, y)                                                                \
+    w.OutL = _mm256_add_ps(w.OutL, w.dOutL);                                                       \
+    w.OutR = _mm256_add_ps(w.OutR, w.dOutR);                                                       \
+    w.Out2L = _mm256_add_ps(w.Out2L, w.dOut2L);                                                    \
+    w.Out2R = _mm256_add_ps(w.Out2R, w.dOut2R);                                                    \
+    wideAccumulate(&OutL[k], _mm256_add_ps(_mm256_mul_ps(x, w.OutL), _mm256_mul_ps(y, w.Out2L)));  \
+    wideAccumulate(&OutR[k], _mm256_add_ps(_mm256_mul_ps(x, w.OutR), _mm256_mul_ps(y, w.Out2R)));
+
+template <int config, bool A, bool WS, bool B>
+FBQ_WIDE_TARGET void ProcessFBWide(QuadFilterChainState &d0, QuadFilterChainState &d1,
+                                   fbq_global &g, float *OutL, float *OutR)
+{
+    const auto hb_c = _mm256_set1_ps(0.5f);
+    const auto one = _mm256_set1_ps(1.0f);
+
+    WideChainState w;
+    wideLoad(w, d0, d1);
+    const auto mask = w.mask;
+
+    switch (config)
+    {
+    case fc_serial1:
+        for (int k = 0; k < BLOCK_SIZE_OS; k++)
+        {
+            auto input = wideJoin(d0.DL[k], d1.DL[k]);
+            auto x = input, y = wideJoin(d0.DR[k], d1.DR[k]);
+
+            if (A)
+                x = wideFilter(g.FU1ptr, d0, d1, 0, x);
+            if (WS)
+            {
+                w.wsLPF = _mm256_mul_ps(hb_c, _mm256_add_ps(w.wsLPF, _mm256_and_ps(mask, x)));
+                w.Drive = _mm256_add_ps(w.Drive, w.dDrive);
+                x = wideShape(g.WSptr, d0, d1, 0, w.wsLPF, w.Drive);
+            }
+
+            if (A || WS)
+            {
+                w.Mix1 = _mm256_add_ps(w.Mix1, w.dMix1);
+                x = _mm256_add_ps(_mm256_mul_ps(input, _mm256_sub_ps(one, w.Mix1)),
+                                  _mm256_mul_ps(x, w.Mix1));
+            }
+
+            y = _mm256_add_ps(x, y);
+
+            if (B)
+                y = wideFilter(g.FU2ptr, d0, d1, 1, y);
+
+            w.Mix2 = _mm256_add_ps(w.Mix2, w.dMix2);
+            x = _mm256_add_ps(_mm256_mul_ps(x, _mm256_sub_ps(one, w.Mix2)),
+                              _mm256_mul_ps(y, w.Mix2));
+            w.Gain = _mm256_add_ps(w.Gain, w.dGain);
+            auto out = _mm256_and_ps(mask, _mm256_mul_ps(x, w.Gain));
+
+            MWriteOutputsWide(out)
+        }
+        break;
+    case fc_serial2:
+        for (int k = 0; k < BLOCK_SIZE_OS; k++)
+        {
+            w.FB = _mm256_add_ps(w.FB, w.dFB);
+            auto input = _mm256_mul_ps(w.FB, w.FBlineL);
+            input = _mm256_add_ps(wideJoin(d0.DL[k], d1.DL[k]), wideSoftclip(input));
+            auto x = input, y = wideJoin(d0.DR[k], d1.DR[k]);
+
+            if (A)
+                x = wideFilter(g.FU1ptr, d0, d1, 0, x);
+            if (WS)
+            {
+                w.wsLPF = _mm256_mul_ps(hb_c, _mm256_add_ps(w.wsLPF, _mm256_and_ps(mask, x)));
+                w.Drive = _mm256_add_ps(w.Drive, w.dDrive);
+                x = wideShape(g.WSptr, d0, d1, 0, w.wsLPF, w.Drive);
+            }
+
+            if (A || WS)
+            {
+                w.Mix1 = _mm256_add_ps(w.Mix1, w.dMix1);
+                x = _mm256_add_ps(_mm256_mul_ps(input, _mm256_sub_ps(one, w.Mix1)),
+                                  _mm256_mul_ps(x, w.Mix1));
+            }
+
+            y = _mm256_add_ps(x, y);
+
+            if (B)
+                y = wideFilter(g.FU2ptr, d0, d1, 1, y);
+
+            w.Mix2 = _mm256_add_ps(w.Mix2, w.dMix2);
+            x = _mm256_add_ps(_mm256_mul_ps(x, _mm256_sub_ps(one, w.Mix2)),
+                              _mm256_mul_ps(y, w.Mix2));
+            w.Gain = _mm256_add_ps(w.Gain, w.dGain);
+            auto out = _mm256_and_ps(mask, _mm256_mul_ps(x, w.Gain));
+            w.FBlineL = out;
+
+            MWriteOutputsWide(out)
+        }
+        break;
+    case fc_serial3:
+        for (int k = 0; k < BLOCK_SIZE_OS; k++)
+        {
+            w.FB = _mm256_add_ps(w.FB, w.dFB);
+            auto input = _mm256_mul_ps(w.FB, w.FBlineL);
+            input = _mm256_add_ps(wideJoin(d0.DL[k], d1.DL[k]), wideSoftclip(input));
+            auto x = input, y = wideJoin(d0.DR[k], d1.DR[k]);
+
+            if (A)
+                x = wideFilter(g.FU1ptr, d0, d1, 0, x);
+            if (WS)
+            {
+                w.wsLPF = _mm256_mul_ps(hb_c, _mm256_add_ps(w.wsLPF, _mm256_and_ps(mask, x)));
+                w.Drive = _mm256_add_ps(w.Drive, w.dDrive);
+                x = wideShape(g.WSptr, d0, d1, 0, w.wsLPF, w.Drive);
+            }
+
+            if (A || WS)
+            {
+                w.Mix1 = _mm256_add_ps(w.Mix1, w.dMix1);
+                x = _mm256_add_ps(_mm256_mul_ps(input, _mm256_sub_ps(one, w.Mix1)),
+                                  _mm256_mul_ps(x, w.Mix1));
+            }
+
+            w.Gain = _mm256_add_ps(w.Gain, w.dGain);
+            x = _mm256_and_ps(mask, _mm256_mul_ps(x, w.Gain));
+
+            MWriteOutputsWide(x)
+
+            y = _mm256_add_ps(x, y);
+
+            if (B)
+                y = wideFilter(g.FU2ptr, d0, d1, 1, y);
+
+            w.Mix2 = _mm256_add_ps(w.Mix2, w.dMix2);
+            x = _mm256_add_ps(_mm256_mul_ps(x, _mm256_sub_ps(one, w.Mix2)),
+                              _mm256_mul_ps(y, w.Mix2));
+
+            w.FBlineL = y;
+        }
+        break;
+    case fc_dual1:
+        for (int k = 0; k < BLOCK_SIZE_OS; k++)
+        {
+            w.FB = _mm256_add_ps(w.FB, w.dFB);
+            auto fb = wideSoftclip(_mm256_mul_ps(w.FB, w.FBlineL));
+            auto x = _mm256_add_ps(wideJoin(d0.DL[k], d1.DL[k]), fb);
+            auto y = _mm256_add_ps(wideJoin(d0.DR[k], d1.DR[k]), fb);
+
+            if (A)
+                x = wideFilter(g.FU1ptr, d0, d1, 0, x);
+            if (B)
+                y = wideFilter(g.FU2ptr, d0, d1, 1, y);
+
+            w.Mix1 = _mm256_add_ps(w.Mix1, w.dMix1);
+            w.Mix2 = _mm256_add_ps(w.Mix2, w.dMix2);
+            x = _mm256_add_ps(_mm256_mul_ps(x, w.Mix1), _mm256_mul_ps(y, w.Mix2));
+
+            if (WS)
+            {
+                w.wsLPF = _mm256_mul_ps(hb_c, _mm256_add_ps(w.wsLPF, _mm256_and_ps(mask, x)));
+                w.Drive = _mm256_add_ps(w.Drive, w.dDrive);
+                x = wideShape(g.WSptr, d0, d1, 0, w.wsLPF, w.Drive);
+            }
+
+            w.Gain = _mm256_add_ps(w.Gain, w.dGain);
+            auto out = _mm256_and_ps(mask, _mm256_mul_ps(x, w.Gain));
+            w.FBlineL = out;
+
+            MWriteOutputsWide(out)
+        }
+        break;
+    case fc_dual2:
+        for (int k = 0; k < BLOCK_SIZE_OS; k++)
+        {
+            w.FB = _mm256_add_ps(w.FB, w.dFB);
+            auto fb = wideSoftclip(_mm256_mul_ps(w.FB, w.FBlineL));
+            auto x = _mm256_add_ps(wideJoin(d0.DL[k], d1.DL[k]), fb);
+            auto y = _mm256_add_ps(wideJoin(d0.DR[k], d1.DR[k]), fb);
+
+            if (A)
+                x = wideFilter(g.FU1ptr, d0, d1, 0, x);
+            if (WS)
+            {
+                w.wsLPF = _mm256_mul_ps(hb_c, _mm256_add_ps(w.wsLPF, _mm256_and_ps(mask, x)));
+                w.Drive = _mm256_add_ps(w.Drive, w.dDrive);
+                x = wideShape(g.WSptr, d0, d1, 0, w.wsLPF, w.Drive);
+            }
+
+            if (B)
+                y = wideFilter(g.FU2ptr, d0, d1, 1, y);
+
+            w.Mix1 = _mm256_add_ps(w.Mix1, w.dMix1);
+            w.Mix2 = _mm256_add_ps(w.Mix2, w.dMix2);
+            x = _mm256_add_ps(_mm256_mul_ps(x, w.Mix1), _mm256_mul_ps(y, w.Mix2));
+
+            w.Gain = _mm256_add_ps(w.Gain, w.dGain);
+            auto out = _mm256_and_ps(mask, _mm256_mul_ps(x, w.Gain));
+            w.FBlineL = out;
+
+            MWriteOutputsWide(out)
+        }
+        break;
+    case fc_ring:
+        for (int k = 0; k < BLOCK_SIZE_OS; k++)
+        {
+            w.FB = _mm256_add_ps(w.FB, w.dFB);
+            auto fb = wideSoftclip(_mm256_mul_ps(w.FB, w.FBlineL));
+            auto x = _mm256_add_ps(wideJoin(d0.DL[k], d1.DL[k]), fb);
+            auto y = _mm256_add_ps(wideJoin(d0.DR[k], d1.DR[k]), fb);
+
+            if (A)
+                x = wideFilter(g.FU1ptr, d0, d1, 0, x);
+            if (B)
+                y = wideFilter(g.FU2ptr, d0, d1, 1, y);
+
+            w.Mix1 = _mm256_add_ps(w.Mix1, w.dMix1);
+            w.Mix2 = _mm256_add_ps(w.Mix2, w.dMix2);
+
+            x = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(one, w.Mix1), y),
+                                            _mm256_mul_ps(x, w.Mix1)),
+                              _mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(one, w.Mix2), x),
+                                            _mm256_mul_ps(y, w.Mix2)));
+
+            if (WS)
+            {
+                w.wsLPF = _mm256_mul_ps(hb_c, _mm256_add_ps(w.wsLPF, x));
+                w.Drive = _mm256_add_ps(w.Drive, w.dDrive);
+                x = wideShape(g.WSptr, d0, d1, 0, _mm256_and_ps(mask, w.wsLPF), w.Drive);
+            }
+
+            w.Gain = _mm256_add_ps(w.Gain, w.dGain);
+            auto out = _mm256_and_ps(mask, _mm256_mul_ps(x, w.Gain));
+            w.FBlineL = out;
+
+            MWriteOutputsWide(out)
+        }
+        break;
+    case fc_stereo:
+        for (int k = 0; k < BLOCK_SIZE_OS; k++)
+        {
+            w.FB = _mm256_add_ps(w.FB, w.dFB);
+            auto fb = wideSoftclip(_mm256_mul_ps(w.FB, w.FBlineL));
+            auto x = _mm256_add_ps(wideJoin(d0.DL[k], d1.DL[k]), fb);
+            auto y = _mm256_add_ps(wideJoin(d0.DR[k], d1.DR[k]), fb);
+
+            if (A)
+                x = wideFilter(g.FU1ptr, d0, d1, 0, x);
+            if (B)
+                y = wideFilter(g.FU2ptr, d0, d1, 1, y);
+
+            if (WS)
+            {
+                w.Drive = _mm256_add_ps(w.Drive, w.dDrive);
+                x = wideShape(g.WSptr, d0, d1, 0, _mm256_and_ps(mask, x), w.Drive);
+                y = wideShape(g.WSptr, d0, d1, 1, _mm256_and_ps(mask, y), w.Drive);
+            }
+
+            w.Mix1 = _mm256_add_ps(w.Mix1, w.dMix1);
+            w.Mix2 = _mm256_add_ps(w.Mix2, w.dMix2);
+            x = _mm256_mul_ps(x, w.Mix1);
+            y = _mm256_mul_ps(y, w.Mix2);
+
+            w.Gain = _mm256_add_ps(w.Gain, w.dGain);
+            x = _mm256_and_ps(mask, _mm256_mul_ps(x, w.Gain));
+            y = _mm256_and_ps(mask, _mm256_mul_ps(y, w.Gain));
+            w.FBlineL = _mm256_add_ps(x, y);
+
+            MWriteOutputsDualWide(x, y)
+        }
+        break;
+    case fc_wide:
+        for (int k = 0; k < BLOCK_SIZE_OS; k++)
+        {
+            w.FB = _mm256_add_ps(w.FB, w.dFB);
+            auto fbL = _mm256_mul_ps(w.FB, w.FBlineL);
+            auto fbR = _mm256_mul_ps(w.FB, w.FBlineR);
+            auto xin = _mm256_add_ps(wideJoin(d0.DL[k], d1.DL[k]), wideSoftclip(fbL));
+            auto yin = _mm256_add_ps(wideJoin(d0.DR[k], d1.DR[k]), wideSoftclip(fbR));
+            auto x = xin;
+            auto y = yin;
+
+            if (A)
+            {
+                x = wideFilter(g.FU1ptr, d0, d1, 0, x);
+                y = wideFilter(g.FU1ptr, d0, d1, 2, y);
+            }
+
+            if (WS)
+            {
+                w.Drive = _mm256_add_ps(w.Drive, w.dDrive);
+                x = wideShape(g.WSptr, d0, d1, 0, _mm256_and_ps(mask, x), w.Drive);
+                y = wideShape(g.WSptr, d0, d1, 1, _mm256_and_ps(mask, y), w.Drive);
+            }
+
+            if (A || WS)
+            {
+                w.Mix1 = _mm256_add_ps(w.Mix1, w.dMix1);
+                auto t = _mm256_sub_ps(one, w.Mix1);
+                x = _mm256_add_ps(_mm256_mul_ps(xin, t), _mm256_mul_ps(x, w.Mix1));
+                y = _mm256_add_ps(_mm256_mul_ps(yin, t), _mm256_mul_ps(y, w.Mix1));
+            }
+
+            if (B)
+            {
+                auto z = wideFilter(g.FU2ptr, d0, d1, 1, x);
+                auto v = wideFilter(g.FU2ptr, d0, d1, 3, y);
+
+                w.Mix2 = _mm256_add_ps(w.Mix2, w.dMix2);
+                auto t = _mm256_sub_ps(one, w.Mix2);
+                x = _mm256_add_ps(_mm256_mul_ps(x, t), _mm256_mul_ps(z, w.Mix2));
+                y = _mm256_add_ps(_mm256_mul_ps(y, t), _mm256_mul_ps(v, w.Mix2));
+            }
+
+            w.Gain = _mm256_add_ps(w.Gain, w.dGain);
+            x = _mm256_and_ps(mask, _mm256_mul_ps(x, w.Gain));
+            y = _mm256_and_ps(mask, _mm256_mul_ps(y, w.Gain));
+            w.FBlineL = x;
+            w.FBlineR = y;
+
+            MWriteOutputsDualWide(x, y)
+        }
+        break;
+    }
+
+    wideStore(w, d0, d1);
+}
+
+template <int config> FBQWideFPtr GetFBQWidePointer2(bool A, bool WS, bool B)
+{
+    if (A)
+    {
+        if (B)
+            return WS ? ProcessFBWide<config, 1, 1, 1> : ProcessFBWide<config, 1, 0, 1>;
+        else
+            return WS ? ProcessFBWide<config, 1, 1, 0> : ProcessFBWide<config, 1, 0, 0>;
+    }
+    else
+    {
+        if (B)
+            return WS ? ProcessFBWide<config, 0, 1, 1> : ProcessFBWide<config, 0, 0, 1>;
+        else
+            return WS ? ProcessFBWide<config, 0, 1, 0> : ProcessFBWide<config, 0, 0, 0>;
+    }
+}
+} // namespace
+#endif
+
+FBQWideFPtr GetFBQWidePointer(int config, bool A, bool WS, bool B)
+{
+#if SURGE_FBQ_HAS_WIDE
+    switch (config)
+    {
+    case fc_serial1:
+        return GetFBQWidePointer2<fc_serial1>(A, WS, B);
+    case fc_serial2:
+        return GetFBQWidePointer2<fc_serial2>(A, WS, B);
+    case fc_serial3:
+        return GetFBQWidePointer2<fc_serial3>(A, WS, B);
+    case fc_dual1:
+        return GetFBQWidePointer2<fc_dual1>(A, WS, B);
+    case fc_dual2:
+        return GetFBQWidePointer2<fc_dual2>(A, WS, B);
+    case fc_ring:
+        return GetFBQWidePointer2<fc_ring>(A, WS, B);
+    case fc_stereo:
+        return GetFBQWidePointer2<fc_stereo>(A, WS, B);
+    case fc_wide:
+        return GetFBQWidePointer2<fc_wide>(A, WS, B);
+    }
+#endif
+    return nullptr;
+}
+
 void InitQuadFilterChainStateToZero(QuadFilterChainState *Q)
 {
     Q->Gain = SIMD_MM(setzero_ps)();
@@ -158,4 +158,19 @@ typedef void (*FBQFPtr)(QuadFilterChainState &, fbq_global &, float *, float *);
 
 FBQFPtr GetFBQPointer(int config, bool A, bool WS, bool B);
 
+/*
+ * The same chains, run on two adjacent quads at once with 8 wide AVX registers. The filter and
+ * waveshaper units are still 4 wide, so they are called once per quad, but all of the gain,
+ * mix, feedback and output work in between is done for 8 voices per instruction and the
+ * output is summed once per sample rather than once per quad.
+ *
+ * This returns null on platforms where it isn't compiled in. Where it is, only use it if the
+ * CPU supports AVX (see sst::plugininfra::cpufeatures::hasAVX). Results match running the two
+ * quads one after the other through the GetFBQPointer chain.
+ */
+typedef void (*FBQWideFPtr)(QuadFilterChainState &, QuadFilterChainState &, fbq_global &,
+                            float *, float *);
+
+FBQWideFPtr GetFBQWidePointer(int config, bool A, bool WS, bool B);
+
 #endif // SURGE_SRC_COMMON_DSP_QUADFILTERCHAIN_H
@@ -499,9 +499,11 @@ void SurgeVoice::switch_toggled()
     /*
      * Since we have updated the keytrack output here we need to re-update the localcopy modulators
      */
-    vector<ModulationRouting>::iterator iter;
-    iter = scene->modulation_voice.begin();
-    while (iter != scene->modulation_voice.end())
+    auto &routings = storage->audioModulationRoutings();
+    auto &modulation_voice = routings.modulation_voice[state.scene_id];
+    vector<ModulationRouting>::const_iterator iter;
+    iter = modulation_voice.begin();
+    while (iter != modulation_voice.end())
     {
         int src_id = iter->source_id;
         int dst_id = iter->destination_id;
@@ -1248,32 +1250,19 @@ bool SurgeVoice::process_block(QuadFilterChainState &Q, int Qe)
 
 template <bool noLFOSources> void SurgeVoice::applyModulationToLocalcopy()
 {
-    vector<ModulationRouting>::iterator iter;
-    iter = scene->modulation_voice.begin();
-    while (iter != scene->modulation_voice.end())
-    {
-        int src_id = iter->source_id;
-        int dst_id = iter->destination_id;
-        float depth = iter->depth;
-
-        if (noLFOSources && isLFO((::modsources)src_id))
-        {
-        }
-        else if (modsources[src_id])
-        {
-            localcopy[dst_id].f +=
-                depth * modsources[src_id]->get_output(iter->source_index) * (1.0 - iter->muted);
-        }
-        iter++;
-    }
+    auto &routings = storage->audioModulationRoutings();
+    auto &program = noLFOSources ? routings.voiceProgramNoLFO[state.scene_id]
+                                 : routings.voiceProgram[state.scene_id];
+    program.apply(localcopy, [this](int, int id) { return modsources[id]; });
 
     if (mpeEnabled)
     {
         // See github issue 1214. This basically compensates for
         // channel AT being per-voice in MPE mode (since it is per channel)
         // vs per-scene (since it is per keyboard in non MPE mode).
-        iter = scene->modulation_scene.begin();
-        while (iter != scene->modulation_scene.end())
+        vector<ModulationRouting>::const_iterator iter;
+        iter = routings.modulation_scene[state.scene_id].begin();
+        while (iter != routings.modulation_scene[state.scene_id].end())
         {
             int src_id = iter->source_id;
             if (src_id == ms_aftertouch && modsources[src_id])
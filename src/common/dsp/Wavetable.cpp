@@ -21,6 +21,9 @@
  */
 #include "Wavetable.h"
 #include <assert.h>
+#include <utility>
+#include <thread>
+#include <vector>
 #include "DSPUtils.h"
 #include <vembertech/basic_dsp.h>
 #include "SurgeStorage.h"
@@ -174,6 +177,21 @@ void Wavetable::Copy(Wavetable *wt)
     current_id = wt->current_id;
 }
 
+void Wavetable::swapContents(Wavetable &other)
+{
+    std::swap(everBuilt, other.everBuilt);
+    std::swap(size, other.size);
+    std::swap(n_tables, other.n_tables);
+    std::swap(size_po2, other.size_po2);
+    std::swap(flags, other.flags);
+    std::swap(dt, other.dt);
+    std::swap(dataSizes, other.dataSizes);
+    std::swap(TableF32Data, other.TableF32Data);
+    std::swap(TableI16Data, other.TableI16Data);
+    std::swap(TableF32WeakPointers, other.TableF32WeakPointers);
+    std::swap(TableI16WeakPointers, other.TableI16WeakPointers);
+}
+
 bool Wavetable::BuildWT(void *wdata, wt_header &wh, bool AppendSilence)
 {
     assert(wdata);
@@ -289,6 +307,155 @@ bool Wavetable::BuildWT(void *wdata, wt_header &wh, bool AppendSilence)
     return true;
 }
 
+namespace
+{
+const int filter_size = 63;
+const int filter_id_of = (filter_size - 1) >> 1;
+
+/*
+ * Scratch for one table at one level. The source row is laid out unwrapped, with tap a of
+ * output i at row[2i + a], and then split into even and odd halves so that for a fixed tap
+ * consecutive outputs read consecutive samples. That makes the half band filter a plain
+ * broadcast-multiply-add over 4 (float) or 8 (int16) outputs at a time, with no index
+ * wrapping in the inner loop.
+ */
+struct MipMapScratch
+{
+    std::vector<float> evenF, oddF;
+    std::vector<short> evenI, oddI;
+
+    void resize(int lsize)
+    {
+        size_t n = lsize + filter_id_of;
+        evenF.resize(n);
+        oddF.resize(n);
+        evenI.resize(n);
+        oddI.resize(n);
+    }
+};
+
+/*
+ * Each lane adds the taps in the same order as the scalar filter always has, so the result is
+ * the same as before, not merely close to it.
+ */
+void halfBandF32(const float *even, const float *odd, float *dst, int lsize)
+{
+    int i = 0;
+
+    for (; i + 4 <= lsize; i += 4)
+    {
+        auto acc = SIMD_MM(setzero_ps)();
+
+        for (int a = 0; a < filter_size; a++)
+        {
+            auto src = (a & 1) ? odd : even;
+            auto x = SIMD_MM(loadu_ps)(src + i + (a >> 1));
+            acc = SIMD_MM(add_ps)(acc, SIMD_MM(mul_ps)(SIMD_MM(set1_ps)(hrfilter[a]), x));
+        }
+
+        SIMD_MM(storeu_ps)(dst + i, acc);
+    }
+
+    for (; i < lsize; i++)
+    {
+        float acc = 0;
+
+        for (int a = 0; a < filter_size; a++)
+        {
+            auto src = (a & 1) ? odd : even;
+            acc += hrfilter[a] * src[i + (a >> 1)];
+        }
+
+        dst[i] = acc;
+    }
+}
+
+void halfBandI16(const short *even, const short *odd, short *dst, int lsize)
+{
+    int i = 0;
+
+    for (; i + 8 <= lsize; i += 8)
+    {
+        auto acc0 = SIMD_MM(setzero_si128)();
+        auto acc1 = SIMD_MM(setzero_si128)();
+
+        for (int a = 0; a < filter_size; a++)
+        {
+            auto src = (a & 1) ? odd : even;
+            auto x = SIMD_MM(loadu_si128)((const SIMD_M128I *)(src + i + (a >> 1)));
+            auto c = SIMD_MM(set1_epi16)((short)HRFilterI16[a]);
+            // full 32 bit products from the low and high halves of the 16 bit multiply
+            auto lo = SIMD_MM(mullo_epi16)(x, c);
+            auto hi = SIMD_MM(mulhi_epi16)(x, c);
+            acc0 = SIMD_MM(add_epi32)(acc0, SIMD_MM(unpacklo_epi16)(lo, hi));
+            acc1 = SIMD_MM(add_epi32)(acc1, SIMD_MM(unpackhi_epi16)(lo, hi));
+        }
+
+        // >> 16 then truncate to short, like the scalar version; sign extend first so the
+        // pack never saturates
+        acc0 = SIMD_MM(srai_epi32)(SIMD_MM(slli_epi32)(SIMD_MM(srai_epi32)(acc0, 16), 16), 16);
+        acc1 = SIMD_MM(srai_epi32)(SIMD_MM(slli_epi32)(SIMD_MM(srai_epi32)(acc1, 16), 16), 16);
+        SIMD_MM(storeu_si128)((SIMD_M128I *)(dst + i), SIMD_MM(packs_epi32)(acc0, acc1));
+    }
+
+    for (; i < lsize; i++)
+    {
+        int ival = 0;
+
+        for (int a = 0; a < filter_size; a++)
+        {
+            auto src = (a & 1) ? odd : even;
+            ival += HRFilterI16[a] * src[i + (a >> 1)];
+        }
+
+        dst[i] = ival >> 16;
+    }
+}
+
+/*
+ * Runs fn(begin, end) over [0, n) split across a few threads, the calling thread included.
+ * Small jobs stay on the calling thread, since starting threads costs more than they save,
+ * and so does everything unless parallel is set, since the audio thread builds tables too.
+ */
+template <typename F> void mipMapParallelFor(bool parallel, int n, size_t work, F &&fn)
+{
+    static constexpr size_t minWorkPerThread = 1 << 16;
+
+    if (!parallel)
+    {
+        fn(0, n);
+        return;
+    }
+
+    int hw = (int)std::thread::hardware_concurrency();
+    int nThreads = std::min({std::max(hw, 1), n, (int)(work / minWorkPerThread) + 1, 8});
+
+    if (nThreads <= 1)
+    {
+        fn(0, n);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(nThreads - 1);
+
+    int per = (n + nThreads - 1) / nThreads;
+
+    for (int t = 1; t < nThreads; ++t)
+    {
+        int b = std::min(n, t * per), e = std::min(n, (t + 1) * per);
+
+        if (b < e)
+            threads.emplace_back([&fn, b, e]() { fn(b, e); });
+    }
+
+    fn(0, std::min(n, per));
+
+    for (auto &t : threads)
+        t.join();
+}
+} // namespace
+
 void Wavetable::MipMapWT()
 {
     int levels = 1;
@@ -296,73 +463,105 @@ void Wavetable::MipMapWT()
         levels++;
     int ns = this->n_tables;
 
-    const int filter_size = 63;
-    const int filter_id_of = (filter_size - 1) >> 1;
-
     for (int l = 1; l < levels; l++)
     {
-        int psize = size >> (l - 1);
-        int lsize = size >> l;
-
         for (int s = 0; s < ns; s++)
         {
             this->TableF32WeakPointers[l][s] = TableF32Data + GetWTIndex(s, size, n_tables, l);
             this->TableI16WeakPointers[l][s] =
                 TableI16Data + GetWTIndex(s, size, n_tables, l, FIRipolI16_N);
+        }
+    }
 
-            if (this->flags & wtf_is_sample)
+    auto mipMapTable = [this, ns](int l, int s, MipMapScratch &scratch) {
+        int psize = size >> (l - 1);
+        int lsize = size >> l;
+        int halfrow = lsize + filter_id_of;
+
+        scratch.resize(lsize);
+
+        auto *evenF = scratch.evenF.data();
+        auto *oddF = scratch.oddF.data();
+        auto *dstF = this->TableF32WeakPointers[l][s];
+        auto *dstI = this->TableI16WeakPointers[l][s];
+
+        if (this->flags & wtf_is_sample)
+        {
+            // samples run on into the following tables rather than wrapping
+            auto at = [&](int srcindex) {
+                int srctable = std::max(0, s + (srcindex / psize));
+                srcindex = srcindex & (psize - 1);
+
+                if (srctable < ns)
+                    return this->TableF32WeakPointers[l - 1][srctable][srcindex];
+                return 0.f;
+            };
+
+            for (int j = 0; j < halfrow; j++)
             {
-                for (int i = 0; i < lsize; i++)
-                {
-                    this->TableF32WeakPointers[l][s][i] = 0;
-                    for (int a = 0; a < filter_size; a++)
-                    {
-                        int srcindex = (i << 1) + a - filter_id_of;
-                        int srctable = max(0, s + (srcindex / psize));
-                        srcindex = srcindex & (psize - 1);
-                        if (srctable < ns)
-                            this->TableF32WeakPointers[l][s][i] +=
-                                hrfilter[a] * this->TableF32WeakPointers[l - 1][srctable][srcindex];
-                    }
-                    this->TableI16WeakPointers[l][s][i + FIRoffsetI16] =
-                        0; // not supported in int16 atm
-                }
+                evenF[j] = at(2 * j - filter_id_of);
+                oddF[j] = at(2 * j + 1 - filter_id_of);
             }
-            else
+
+            halfBandF32(evenF, oddF, dstF, lsize);
+
+            // not supported in int16 atm
+            memset(dstI + FIRoffsetI16, 0, lsize * sizeof(short));
+        }
+        else
+        {
+            auto *evenI = scratch.evenI.data();
+            auto *oddI = scratch.oddI.data();
+            const float *srcF = this->TableF32WeakPointers[l - 1][s];
+            const short *srcI = this->TableI16WeakPointers[l - 1][s] + FIRoffsetI16;
+
+            for (int j = 0; j < halfrow; j++)
             {
-                for (int i = 0; i < lsize; i++)
-                {
-                    this->TableF32WeakPointers[l][s][i] = 0;
-                    for (int a = 0; a < filter_size; a++)
-                    {
-                        this->TableF32WeakPointers[l][s][i] +=
-                            hrfilter[a] * this->TableF32WeakPointers[l - 1][s][(
-                                              ((i << 1) + a - filter_id_of) & (psize - 1))];
-                    }
-                    int ival = 0;
-                    for (int a = 0; a < filter_size; a++)
-                    {
-                        ival += HRFilterI16[a] *
-                                this->TableI16WeakPointers[l - 1][s]
-                                                          [(((i << 1) + a - 31) & (psize - 1)) +
-                                                           FIRoffsetI16];
-                    }
-                    this->TableI16WeakPointers[l][s][i + FIRoffsetI16] = ival >> 16;
-                }
+                int ei = (2 * j - filter_id_of) & (psize - 1);
+                int oi = (2 * j + 1 - filter_id_of) & (psize - 1);
+                evenF[j] = srcF[ei];
+                oddF[j] = srcF[oi];
+                evenI[j] = srcI[ei];
+                oddI[j] = srcI[oi];
             }
-            // float2i16_block(this->TableF32WeakPointers[l][s],this->TableI16WeakPointers[l][s],lsize);
-            auto toCopy = std::min(FIRoffsetI16, lsize);
-            memcpy(&this->TableI16WeakPointers[l][s][lsize + FIRoffsetI16],
-                   &this->TableI16WeakPointers[l][s][FIRoffsetI16], toCopy * sizeof(short));
-            memcpy(&this->TableI16WeakPointers[l][s][0], &this->TableI16WeakPointers[l][s][lsize],
-                   toCopy * sizeof(short));
+
+            halfBandF32(evenF, oddF, dstF, lsize);
+            halfBandI16(evenI, oddI, dstI + FIRoffsetI16, lsize);
+        }
+
+        auto toCopy = std::min(FIRoffsetI16, lsize);
+        memcpy(&dstI[lsize + FIRoffsetI16], &dstI[FIRoffsetI16], toCopy * sizeof(short));
+        memcpy(&dstI[0], &dstI[lsize], toCopy * sizeof(short));
+    };
+
+    size_t work = (size_t)ns * size;
+
+    if (this->flags & wtf_is_sample)
+    {
+        // a sample table reads its neighbours' previous level, so finish each level first
+        for (int l = 1; l < levels; l++)
+        {
+            mipMapParallelFor(parallelMipMaps, ns, work >> (l - 1), [&](int b, int e) {
+                MipMapScratch scratch;
+                for (int s = b; s < e; s++)
+                    mipMapTable(l, s, scratch);
+            });
         }
-        // fwrite(this->TableI16WeakPointers[l][0],lsize*sizeof(short),1,F);
     }
-    // fclose(F);
+    else
+    {
+        // whereas a wavetable frame only ever reads itself, so each thread takes whole frames
+        mipMapParallelFor(parallelMipMaps, ns, work, [&](int b, int e) {
+            MipMapScratch scratch;
+            for (int s = b; s < e; s++)
+                for (int l = 1; l < levels; l++)
+                    mipMapTable(l, s, scratch);
+        });
+    }
 
     // TODO I16 mipmaps end up out of phase
     // The click/knot/bug probably results from the fact that there is no padding in the beginning,
     // so it becomes out of phase at mipmap switch - makes sense because as they were off by a whole
     // sample at the mipmap switch, which cannot be explained by the half rate filter
 }
+
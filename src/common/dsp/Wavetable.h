@@ -27,6 +27,10 @@ const int max_wtable_size = 4096;
 const int max_subtables = 512;
 const int max_mipmap_levels = 16;
 
+// the half band filters MipMapWT decimates each level with
+extern const float hrfilter[63];
+extern const int HRFilterI16[64];
+
 #pragma pack(push, 1)
 struct wt_header
 {
@@ -45,6 +49,12 @@ class Wavetable
     Wavetable();
     ~Wavetable();
     void Copy(Wavetable *wt);
+
+    /*
+     * Exchange table data and shape with another wavetable without allocating or copying
+     * samples. Ids, filenames and the display flags stay where they are.
+     */
+    void swapContents(Wavetable &other);
     bool BuildWT(void *wdata, wt_header &wh, bool AppendSilence);
     void MipMapWT();
 
@@ -71,6 +81,13 @@ class Wavetable
     std::string queue_filename;
     std::string current_filename;
     int frame_size_if_absent{-1};
+
+    /*
+     * Let MipMapWT spread a big table over a few threads of its own. Only set this on a table
+     * built off the audio thread (see WavetableBuildService); it stays with the table object
+     * rather than moving with swapContents.
+     */
+    bool parallelMipMaps{false};
 };
 
 enum wtflags
@@ -33,6 +33,207 @@ namespace Surge
 {
 namespace Formula
 {
+#if HAS_LUA
+// the general fields first, then the voice ones
+#define SURGE_FORMULA_NAME(x) #x,
+static constexpr const char *stateFieldNames[] = {
+    SURGE_FORMULA_STATE_FIELDS(SURGE_FORMULA_NAME, SURGE_FORMULA_NAME)
+        SURGE_FORMULA_VOICE_FIELDS(SURGE_FORMULA_NAME)};
+#undef SURGE_FORMULA_NAME
+#define SURGE_FORMULA_COUNT(x) +1
+static constexpr int n_general_state_fields =
+    0 SURGE_FORMULA_STATE_FIELDS(SURGE_FORMULA_COUNT, SURGE_FORMULA_COUNT);
+#undef SURGE_FORMULA_COUNT
+
+static constexpr const char *stateBindingName{"surge_reserved_formula_state_binding"};
+
+/*
+ * Defines stateBindingName(), which makes the FFI struct and state metatable for one evaluator
+ * and returns the metatable along with the struct's address. It is defined outside the formula
+ * sandbox, so scripts get neither ffi nor the raw struct.
+ *
+ * Reading a built-in goes through __index since the table doesn't hold it. Assigning one
+ * stores it in the table, which then shadows ours until the next valueAt clears it; that's the
+ * same lifetime an assignment had when we rewrote every field each block.
+ *
+ * pairs(state) lists the built-ins after the table's own entries through __pairs, and the
+ * pairs which the sandbox copies from here is replaced by one which calls that. next(state)
+ * only sees the table's own entries.
+ */
+static std::string stateBindingSource()
+{
+    std::ostringstream oss;
+    oss << "local ffi = require('ffi')\n"
+        << "ffi.cdef[[ typedef struct {";
+#define SURGE_FORMULA_NUM(x) oss << " double " #x ";";
+#define SURGE_FORMULA_BOOL(x) oss << " bool " #x ";";
+    SURGE_FORMULA_STATE_FIELDS(SURGE_FORMULA_NUM, SURGE_FORMULA_BOOL)
+    SURGE_FORMULA_VOICE_FIELDS(SURGE_FORMULA_NUM)
+#undef SURGE_FORMULA_NUM
+#undef SURGE_FORMULA_BOOL
+    oss << " bool shadowed; } surge_formula_state; ]]\n";
+
+    oss << "local names = {";
+    for (auto *n : stateFieldNames)
+        oss << " '" << n << "',";
+    oss << " }\nlocal fields, voiceFields = {}, {}\n"
+        << "for i, n in ipairs(names) do\n"
+        << "    if i <= " << n_general_state_fields << " then fields[n] = true "
+        << "else voiceFields[n] = true end\n"
+        << "end\n";
+
+    oss << "function " << stateBindingName << R"FN(()
+    local cd = ffi.new('surge_formula_state')
+    local mt = {}
+    mt.__index = function(t, k)
+        if fields[k] or (voiceFields[k] and cd.is_voice) then
+            return cd[k]
+        end
+        return nil
+    end
+    mt.__newindex = function(t, k, v)
+        if fields[k] or voiceFields[k] then
+            cd.shadowed = true
+        end
+        rawset(t, k, v)
+    end
+    mt.__pairs = function(t)
+        local key, inTable, i = nil, true, 0
+        return function()
+            if inTable then
+                local k, v = next(t, key)
+                if k ~= nil then
+                    key = k
+                    return k, v
+                end
+                inTable = false
+            end
+            while true do
+                i = i + 1
+                local k = names[i]
+                if k == nil then
+                    return nil
+                end
+                if rawget(t, k) == nil and (fields[k] or cd.is_voice) then
+                    return k, cd[k]
+                end
+            end
+        end, t, nil
+    end
+    return mt, tonumber(ffi.cast('uintptr_t', ffi.cast('surge_formula_state *', cd)))
+end
+
+-- LuaJIT only honours __pairs when built for 5.2 compatibility, which ours isn't
+local rawpairs = pairs
+function pairs(t)
+    local mt = getmetatable(t)
+    if type(mt) == 'table' and mt.__pairs then
+        return mt.__pairs(t)
+    end
+    return rawpairs(t)
+end
+)FN";
+    return oss.str();
+}
+
+static void releaseStateBinding(EvaluatorState &s)
+{
+    if (s.L && s.metatableRef)
+    {
+        luaL_unref(s.L, LUA_REGISTRYINDEX, s.metatableRef);
+    }
+    s.metatableRef = 0;
+    s.boundFields = nullptr;
+}
+
+static void createStateBinding(EvaluatorState &s)
+{
+    auto g = Surge::LuaSupport::SGLD("createStateBinding", s.L);
+
+    releaseStateBinding(s);
+
+    lua_getglobal(s.L, stateBindingName);
+    if (!lua_isfunction(s.L, -1) || lua_pcall(s.L, 0, 2, 0) != LUA_OK)
+    {
+        // no FFI in this LuaJIT, so valueAt pushes the fields like it used to
+        lua_pop(s.L, 1);
+        return;
+    }
+
+    if (lua_istable(s.L, -2) && lua_isnumber(s.L, -1))
+    {
+        s.boundFields = reinterpret_cast<StateFields *>((uintptr_t)lua_tonumber(s.L, -1));
+        lua_pop(s.L, 1);
+        s.metatableRef = luaL_ref(s.L, LUA_REGISTRYINDEX);
+    }
+    else
+    {
+        lua_pop(s.L, 2);
+    }
+}
+
+static bool isBoundStateTable(const EvaluatorState &s, int idx)
+{
+    if (!s.metatableRef || !lua_getmetatable(s.L, idx))
+        return false;
+
+    lua_rawgeti(s.L, LUA_REGISTRYINDEX, s.metatableRef);
+    bool res = lua_rawequal(s.L, -1, -2);
+    lua_pop(s.L, 2);
+    return res;
+}
+
+/*
+ * Make sure the state table at idx reads its built-ins from our struct: a process() which
+ * returns a fresh table needs the metatable, and one which assigned to a built-in has a copy
+ * in the table hiding the struct.
+ */
+static void bindStateTable(EvaluatorState &s, int idx)
+{
+    if (!s.boundFields || !lua_istable(s.L, idx))
+        return;
+
+    if (idx < 0)
+        idx = lua_gettop(s.L) + idx + 1;
+
+    if (isBoundStateTable(s, idx))
+    {
+        if (!s.boundFields->shadowed)
+            return;
+    }
+    else
+    {
+        lua_rawgeti(s.L, LUA_REGISTRYINDEX, s.metatableRef);
+        lua_setmetatable(s.L, idx);
+    }
+
+    for (auto *n : stateFieldNames)
+    {
+        lua_pushstring(s.L, n);
+        lua_pushnil(s.L);
+        lua_rawset(s.L, idx);
+    }
+    s.boundFields->shadowed = false;
+}
+
+// The unbound path: copy the fields into the table on top of the stack
+static void pushStateFields(lua_State *L, const StateFields &f)
+{
+#define SURGE_FORMULA_NUM(x)                                                                       \
+    lua_pushnumber(L, f.x);                                                                        \
+    lua_setfield(L, -2, #x);
+#define SURGE_FORMULA_BOOL(x)                                                                      \
+    lua_pushboolean(L, f.x);                                                                       \
+    lua_setfield(L, -2, #x);
+    SURGE_FORMULA_STATE_FIELDS(SURGE_FORMULA_NUM, SURGE_FORMULA_BOOL)
+    if (f.is_voice)
+    {
+        SURGE_FORMULA_VOICE_FIELDS(SURGE_FORMULA_NUM)
+    }
+#undef SURGE_FORMULA_NUM
+#undef SURGE_FORMULA_BOOL
+}
+#endif
 
 void setupStorage(SurgeStorage *s) { s->formulaGlobalData = std::make_unique<GlobalData>(); }
 
@@ -101,6 +302,16 @@ end
         {
             lua_setglobal(s.L, "surge_reserved_formula_error_stub");
         }
+
+        auto binding = stateBindingSource();
+        if (luaL_loadbuffer(s.L, binding.c_str(), binding.size(), stateBindingName) != LUA_OK ||
+            lua_pcall(s.L, 0, 0, 0) != LUA_OK)
+        {
+            storage->reportError(std::string("Unable to set up the formula state binding: ") +
+                                     (lua_isstring(s.L, -1) ? lua_tostring(s.L, -1) : "(unknown)"),
+                                 "Formula Setup Error");
+            lua_pop(s.L, 1);
+        }
     }
 
     // OK so now evaluate the formula. This is a mistake - the loading and
@@ -194,6 +405,11 @@ end
 
     if (s.isvalid)
     {
+        if (s.bindStateFields)
+            createStateBinding(s);
+        else
+            releaseStateBinding(s);
+
         // Create my state object each time
         lua_getglobal(s.L, s.funcNameInit);
         lua_createtable(s.L, 0, 10);
@@ -301,6 +517,9 @@ end
             }
         }
 
+        // what init() set up for the built-ins gives way to the struct from here on
+        bindStateTable(s, -1);
+
         // FIXME - we have to clean this up when evaluation is done
         lua_setglobal(s.L, s.stateName);
 
@@ -408,6 +627,8 @@ void removeFunctionsAssociatedWith(SurgeStorage *storage, FormulaModulatorStorag
 bool cleanEvaluatorState(EvaluatorState &s)
 {
 #if HAS_LUA
+    releaseStateBinding(s);
+
     if (s.L && s.stateName[0] != 0)
     {
         lua_pushnil(s.L);
@@ -470,110 +691,110 @@ void valueAt(int phaseIntPart, float phaseFracPart, SurgeStorage *storage,
         return;
     }
     lua_getglobal(s->L, s->stateName);
+    bindStateTable(*s, -1);
 
-    auto addn = [s](const char *q, float f) {
-        lua_pushnumber(s->L, f);
-        lua_setfield(s->L, -2, q);
-    };
+    // Stack is now func > table. Fill in the built-ins, which only goes near the stack if we
+    // couldn't bind the struct
+    auto &f = s->fields();
 
-    auto addi = [s](const char *q, int i) {
-        lua_pushinteger(s->L, i);
-        lua_setfield(s->L, -2, q);
-    };
-
-    auto addb = [s](const char *q, bool b) {
-        lua_pushboolean(s->L, b);
-        lua_setfield(s->L, -2, q);
-    };
-
-    auto addnil = [s](const char *q) {
-        lua_pushnil(s->L);
-        lua_setfield(s->L, -2, q);
-    };
-
-    // Stack is now func > table so we can update the table
-    addi("intphase", phaseIntPart);
-    addi("cycle", phaseIntPart); // Alias cycle for intphase
+    f.intphase = phaseIntPart;
+    f.cycle = phaseIntPart; // Alias cycle for intphase
 
     // Fake a voice count of one for display calls
     int voiceCount = storage->activeVoiceCount;
     if (voiceCount == 0 && s->is_display)
         voiceCount = 1;
-    addi("voice_count", voiceCount);
-
-    addn("delay", s->del);
-    addn("decay", s->dec);
-    addn("attack", s->a);
-    addn("hold", s->h);
-    addn("sustain", s->s);
-    addn("release", s->r);
-
-    addn("rate", s->rate);
-    addn("startphase", s->phase);
-    addn("amplitude", s->amp);
-    addn("deform", s->deform);
-
-    addn("phase", phaseFracPart);
-    addn("tempo", s->tempo);
-    addn("songpos", s->songpos);
-
-    addn("pb", s->pitchbend);
-    addn("pb_range_up", s->pbrange_up);
-    addn("pb_range_dn", s->pbrange_dn);
-    addn("chan_at", s->aftertouch);
-    addn("cc_mw", s->modwheel);
-    addn("cc_breath", s->breath);
-    addn("cc_expr", s->expression);
-    addn("cc_sus", s->sustain);
-    addn("lowest_key", s->lowest_key);
-    addn("highest_key", s->highest_key);
-    addn("latest_key", s->latest_key);
-
-    addi("poly_limit", s->polylimit);
-    addi("scene_mode", s->scenemode);
-    addi("play_mode", s->polymode);
-    addi("split_point", s->splitpoint);
-
-    addb("released", s->released);
-    addb("is_rendering_to_ui", s->is_display);
-    addb("mpe_enabled", s->mpeenabled);
-
-    addnil("retrigger_AEG");
-    addnil("retrigger_FEG");
+    f.voice_count = voiceCount;
+
+    f.delay = s->del;
+    f.decay = s->dec;
+    f.attack = s->a;
+    f.hold = s->h;
+    f.sustain = s->s;
+    f.release = s->r;
+
+    f.rate = s->rate;
+    f.startphase = s->phase;
+    f.amplitude = s->amp;
+    f.deform = s->deform;
+
+    f.phase = phaseFracPart;
+    f.tempo = s->tempo;
+    f.songpos = s->songpos;
+
+    f.pb = s->pitchbend;
+    f.pb_range_up = s->pbrange_up;
+    f.pb_range_dn = s->pbrange_dn;
+    f.chan_at = s->aftertouch;
+    f.cc_mw = s->modwheel;
+    f.cc_breath = s->breath;
+    f.cc_expr = s->expression;
+    f.cc_sus = s->sustain;
+    f.lowest_key = s->lowest_key;
+    f.highest_key = s->highest_key;
+    f.latest_key = s->latest_key;
+
+    f.poly_limit = s->polylimit;
+    f.scene_mode = s->scenemode;
+    f.play_mode = s->polymode;
+    f.split_point = s->splitpoint;
+
+    f.released = s->released;
+    f.is_rendering_to_ui = s->is_display;
+    f.mpe_enabled = s->mpeenabled;
+    f.is_voice = s->isVoice;
 
     if (s->isVoice)
     {
-        addi("key", s->key);
-        addi("velocity", s->velocity);
-        addi("rel_velocity", s->releasevelocity);
-        addi("channel", s->channel);
-
-        addn("poly_at", s->polyat);
-        addn("mpe_bend", s->mpebend);
-        addn("mpe_bendrange", s->mpebendrange);
-        addn("mpe_timbre", s->mpetimbre);
-        addn("mpe_pressure", s->mpepressure);
-
-        addb("is_voice", s->isVoice);
-        addb("released", s->released);
-
-        // LuaJIT has no exposed API for 64-bit int so push this as number
-        addn("voice_id", s->voiceOrderAtCreate);
+        f.key = s->key;
+        f.velocity = s->velocity;
+        f.rel_velocity = s->releasevelocity;
+        f.channel = s->channel;
+
+        f.poly_at = s->polyat;
+        f.mpe_bend = s->mpebend;
+        f.mpe_bendrange = s->mpebendrange;
+        f.mpe_timbre = s->mpetimbre;
+        f.mpe_pressure = s->mpepressure;
+
+        // this went through a float on its way to Lua before, so keep it doing that
+        f.voice_id = (float)s->voiceOrderAtCreate;
     }
-    else
+
+    if (!s->boundFields)
+    {
+        pushStateFields(s->L, f);
+    }
+
+    for (auto *n : {"retrigger_AEG", "retrigger_FEG"})
+    {
+        lua_pushstring(s->L, n);
+        lua_pushnil(s->L);
+        lua_rawset(s->L, -3);
+    }
+
+    // Load the macros, touching only the ones which moved if the table is still ours
+    lua_getfield(s->L, -1, "macros");
+    bool freshMacros = !lua_istable(s->L, -1) || lua_topointer(s->L, -1) != s->macrosTable;
+    if (!lua_istable(s->L, -1))
     {
-        addb("is_voice", false);
+        lua_pop(s->L, 1);
+        lua_createtable(s->L, n_customcontrollers, 0);
+        lua_pushvalue(s->L, -1);
+        lua_setfield(s->L, -3, "macros");
     }
+    s->macrosTable = lua_topointer(s->L, -1);
 
-    // Load the macros
-    lua_createtable(s->L, n_customcontrollers, 0);
     for (int i = 0; i < n_customcontrollers; ++i)
     {
-        lua_pushinteger(s->L, i + 1);
-        lua_pushnumber(s->L, s->macrovalues[i]);
-        lua_settable(s->L, -3);
+        if (freshMacros || s->pushedMacros[i] != s->macrovalues[i])
+        {
+            lua_pushnumber(s->L, s->macrovalues[i]);
+            lua_rawseti(s->L, -2, i + 1);
+            s->pushedMacros[i] = s->macrovalues[i];
+        }
     }
-    lua_setfield(s->L, -2, "macros");
+    lua_pop(s->L, 1);
 
     if (justSetup)
     {
@@ -613,6 +834,7 @@ void valueAt(int phaseIntPart, float phaseFracPart, SurgeStorage *storage,
             return;
         }
         // Store the value and keep it on top of the stack
+        bindStateTable(*s, -1);
         lua_setglobal(s->L, s->stateName);
         lua_getglobal(s->L, s->stateName);
 
@@ -795,6 +1017,21 @@ std::vector<DebugRow> createDebugDataOfModState(const EvaluatorState &es, std::s
                 lua_pop(es.L, 1);
             }
 
+            // the built-ins live in the FFI struct, so lua_next doesn't find them
+            if (depth == 0 && isBoundStateTable(es, -1))
+            {
+                for (auto *n : stateFieldNames)
+                {
+                    if (std::find(skeys.begin(), skeys.end(), n) != skeys.end())
+                        continue;
+
+                    lua_getfield(es.L, -1, n);
+                    if (!lua_isnil(es.L, -1))
+                        skeys.emplace_back(n);
+                    lua_pop(es.L, 1);
+                }
+            }
+
             if (!skeys.empty())
                 std::sort(skeys.begin(), skeys.end(), [](const auto &a, const auto &b) {
                     if (a == "subscriptions")
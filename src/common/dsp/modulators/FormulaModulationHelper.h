@@ -47,6 +47,78 @@ static constexpr int max_formula_outputs{max_lfo_indices};
 static constexpr uint64_t formulaFeatures = Surge::LuaSupport::EnvironmentFeatures::BASE;
 static constexpr const char *sharedTableName{"shared"};
 
+/*
+ * The built-in values process() reads as state.<name>. They live in a struct shared with Lua
+ * through the LuaJIT FFI, so valueAt writes them with plain stores instead of pushing each one
+ * through the stack, and the state table reads them through its metatable. The voice fields
+ * read as nil outside a voice, as they always have.
+ *
+ * Everything is a double or a bool since that's what a script would see anyway. The cdef for
+ * the Lua side is generated from these same lists, so the layouts can't drift apart.
+ */
+#define SURGE_FORMULA_STATE_FIELDS(NUM, BOOL)                                                      \
+    NUM(intphase)                                                                                  \
+    NUM(cycle)                                                                                     \
+    NUM(voice_count)                                                                               \
+    NUM(delay)                                                                                     \
+    NUM(decay)                                                                                     \
+    NUM(attack)                                                                                    \
+    NUM(hold)                                                                                      \
+    NUM(sustain)                                                                                   \
+    NUM(release)                                                                                   \
+    NUM(rate)                                                                                      \
+    NUM(startphase)                                                                                \
+    NUM(amplitude)                                                                                 \
+    NUM(deform)                                                                                    \
+    NUM(phase)                                                                                     \
+    NUM(tempo)                                                                                     \
+    NUM(songpos)                                                                                   \
+    NUM(pb)                                                                                        \
+    NUM(pb_range_up)                                                                               \
+    NUM(pb_range_dn)                                                                               \
+    NUM(chan_at)                                                                                   \
+    NUM(cc_mw)                                                                                     \
+    NUM(cc_breath)                                                                                 \
+    NUM(cc_expr)                                                                                   \
+    NUM(cc_sus)                                                                                    \
+    NUM(lowest_key)                                                                                \
+    NUM(highest_key)                                                                               \
+    NUM(latest_key)                                                                                \
+    NUM(poly_limit)                                                                                \
+    NUM(scene_mode)                                                                                \
+    NUM(play_mode)                                                                                 \
+    NUM(split_point)                                                                               \
+    BOOL(released)                                                                                 \
+    BOOL(is_rendering_to_ui)                                                                       \
+    BOOL(mpe_enabled)                                                                              \
+    BOOL(is_voice)
+
+#define SURGE_FORMULA_VOICE_FIELDS(NUM)                                                            \
+    NUM(key)                                                                                       \
+    NUM(velocity)                                                                                  \
+    NUM(rel_velocity)                                                                              \
+    NUM(channel)                                                                                   \
+    NUM(poly_at)                                                                                   \
+    NUM(mpe_bend)                                                                                  \
+    NUM(mpe_bendrange)                                                                             \
+    NUM(mpe_timbre)                                                                                \
+    NUM(mpe_pressure)                                                                              \
+    NUM(voice_id)
+
+struct StateFields
+{
+#define SURGE_FORMULA_NUM(x) double x{0};
+#define SURGE_FORMULA_BOOL(x) bool x{false};
+    SURGE_FORMULA_STATE_FIELDS(SURGE_FORMULA_NUM, SURGE_FORMULA_BOOL)
+    SURGE_FORMULA_VOICE_FIELDS(SURGE_FORMULA_NUM)
+#undef SURGE_FORMULA_NUM
+#undef SURGE_FORMULA_BOOL
+
+    // set from Lua when a script assigns one of the above, which leaves a copy in the table
+    // shadowing ours until valueAt clears it
+    bool shadowed{false};
+};
+
 struct EvaluatorState
 {
     bool released;
@@ -92,6 +164,24 @@ struct EvaluatorState
     int activeoutputs;
 
     lua_State *L{nullptr}; // This is assigned by prepareForEvaluation to be one per thread
+
+    /*
+     * boundFields points into the Lua state once prepareForEvaluation has bound one; it stays
+     * alive as long as metatableRef (a registry reference on the state table's metatable)
+     * does. Without a binding valueAt fills unboundFields and pushes them into the table.
+     */
+    StateFields *boundFields{nullptr};
+    StateFields unboundFields;
+    int metatableRef{0}; // 0 is never handed out by luaL_ref
+
+    // clear before prepareForEvaluation to push the fields every block even with FFI around
+    bool bindStateFields{true};
+
+    StateFields &fields() { return boundFields ? *boundFields : unboundFields; }
+
+    // the state.macros table we last filled and what we put in it
+    const void *macrosTable{nullptr};
+    float pushedMacros[n_customcontrollers]{};
 };
 
 void setupStorage(SurgeStorage *s);
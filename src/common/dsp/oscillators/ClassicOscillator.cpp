@@ -25,6 +25,7 @@
 
 #include "sst/basic-blocks/mechanics/block-ops.h"
 #include "sst/basic-blocks/mechanics/simd-ops.h"
+#include "sst/plugininfra/cpufeatures.h"
 namespace mech = sst::basic_blocks::mechanics;
 
 /*
@@ -176,6 +177,7 @@ ClassicOscillator::ClassicOscillator(SurgeStorage *storage, OscillatorStorage *o
                                      pdata *localcopy)
     : AbstractBlitOscillator(storage, oscdata, localcopy), charFilt(storage)
 {
+    useWideConvolution = storage->useWideBlitConvolution && wideConvolutionAvailable();
 }
 
 ClassicOscillator::~ClassicOscillator() {}
@@ -281,6 +283,115 @@ void ClassicOscillator::init_default_values()
     oscdata->p[co_unison_voices].val.i = 1;
 }
 
+/*
+** The kernels convolute adds each impulse with. The wide one is compiled for AVX and FMA via a
+** target attribute, as the wide filter chain is, so nothing else in the file can pick up those
+** instructions on a machine which doesn't have them.
+*/
+#if (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)) &&          \
+    !defined(_M_ARM64EC)
+#define SURGE_BLIT_HAS_WIDE 1
+#else
+#define SURGE_BLIT_HAS_WIDE 0
+#endif
+
+#if SURGE_BLIT_HAS_WIDE
+#include <immintrin.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define BLIT_WIDE_TARGET __attribute__((target("avx,fma")))
+#else
+#include <intrin.h>
+#define BLIT_WIDE_TARGET
+#endif
+#endif
+
+namespace
+{
+inline void addImpulse(const float *sinctable, float *ob, float *obR, unsigned int m, float lipol,
+                       float g, float gR, bool stereo)
+{
+    auto lipol128 = SIMD_MM(set1_ps)(lipol);
+    auto g128 = SIMD_MM(set1_ps)(g);
+    auto g128R = SIMD_MM(set1_ps)(gR);
+
+    for (int k = 0; k < FIRipol_N; k += 4)
+    {
+        auto obf = SIMD_MM(loadu_ps)(ob + k);                      // Get buffer[pos + delay + k ]
+        auto st = SIMD_MM(load_ps)(&sinctable[m + k]);             // the sinctable for our position
+        auto so = SIMD_MM(load_ps)(&sinctable[m + k + FIRipol_N]); // get the sinctable deriv
+        so = SIMD_MM(mul_ps)(so, lipol128); // scale the deriv by the lipol fractional time
+        st = SIMD_MM(add_ps)(st, so);       // this is now st = sinctable + dt * dsinctable
+        obf = SIMD_MM(add_ps)(obf, SIMD_MM(mul_ps)(st, g128)); // add g * kernel to the buffer
+        SIMD_MM(storeu_ps)(ob + k, obf);                      // and store.
+
+        if (stereo)
+        {
+            auto obfR = SIMD_MM(loadu_ps)(obR + k);
+            obfR = SIMD_MM(add_ps)(obfR, SIMD_MM(mul_ps)(st, g128R));
+            SIMD_MM(storeu_ps)(obR + k, obfR);
+        }
+    }
+}
+
+#if SURGE_BLIT_HAS_WIDE
+/*
+** The 12 taps are one 8 wide and one 4 wide register, and the kernel interpolation and the
+** accumulation are each a single fused multiply-add.
+*/
+BLIT_WIDE_TARGET void addImpulseWide(const float *sinctable, float *ob, float *obR,
+                                     unsigned int m, float lipol, float g, float gR, bool stereo)
+{
+    static_assert(FIRipol_N == 12, "The wide kernel is written for 12 taps");
+
+    const float *st = &sinctable[m];
+
+    auto lipol256 = _mm256_set1_ps(lipol);
+    auto k8 = _mm256_fmadd_ps(_mm256_loadu_ps(st + FIRipol_N), lipol256, _mm256_loadu_ps(st));
+    auto k4 = _mm_fmadd_ps(_mm_load_ps(st + FIRipol_N + 8), _mm256_castps256_ps128(lipol256),
+                           _mm_load_ps(st + 8));
+
+    auto g256 = _mm256_set1_ps(g);
+    _mm256_storeu_ps(ob, _mm256_fmadd_ps(k8, g256, _mm256_loadu_ps(ob)));
+    _mm_storeu_ps(ob + 8, _mm_fmadd_ps(k4, _mm256_castps256_ps128(g256), _mm_loadu_ps(ob + 8)));
+
+    if (stereo)
+    {
+        auto g256R = _mm256_set1_ps(gR);
+        _mm256_storeu_ps(obR, _mm256_fmadd_ps(k8, g256R, _mm256_loadu_ps(obR)));
+        _mm_storeu_ps(obR + 8,
+                      _mm_fmadd_ps(k4, _mm256_castps256_ps128(g256R), _mm_loadu_ps(obR + 8)));
+    }
+
+    // leave the upper halves clean for the SSE code we return to
+    _mm256_zeroupper();
+}
+#endif
+} // namespace
+
+bool ClassicOscillator::wideConvolutionAvailable()
+{
+#if SURGE_BLIT_HAS_WIDE
+    static const bool res = []() {
+        // hasAVX also checks that the OS saves the wide registers
+        if (!sst::plugininfra::cpufeatures::hasAVX())
+            return false;
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_cpu_init();
+        return (bool)__builtin_cpu_supports("fma");
+#else
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 12)) != 0;
+#endif
+    }();
+
+    return res;
+#else
+    return false;
+#endif
+}
+
 template <bool FM> void ClassicOscillator::convolute(int voice, bool stereo)
 {
     /*
@@ -372,7 +483,7 @@ template <bool FM> void ClassicOscillator::convolute(int voice, bool stereo)
     }
 
     /*
-    ** m and lipol128 are the integer and fractional part of the number of 256ths
+    ** m and lipolui16 are the integer and fractional part of the number of 256ths
     ** (FIRipol_N-ths really) that our current position places us at. These are obviously
     ** not great variable names. Especially lipolui16 doesn't seem to be fractional at all
     ** it seems to range between 0 and 0xffff, but it is multiplied by the sinctable
@@ -383,11 +494,7 @@ template <bool FM> void ClassicOscillator::convolute(int voice, bool stereo)
     */
     unsigned int m = ((ipos >> 16) & 0xff) * (FIRipol_N << 1);
     unsigned int lipolui16 = (ipos & 0xffff);
-    auto lipol128 = SIMD_MM(setzero_ps)();
-    lipol128 = SIMD_MM(cvtsi32_ss)(lipol128, lipolui16);
-    lipol128 = SIMD_MM(shuffle_ps)(lipol128, lipol128, SIMD_MM_SHUFFLE(0, 0, 0, 0));
 
-    int k;
     const float s = 0.99952f;
     float sync = min((float)l_sync.v, (12 + 72 + 72) - pitch);
     float t;
@@ -493,52 +600,18 @@ template <bool FM> void ClassicOscillator::convolute(int voice, bool stereo)
         g *= panL[voice];
     }
 
-    if (stereo)
-    {
-        auto g128L = SIMD_MM(load_ss)(&g);
-        g128L = SIMD_MM(shuffle_ps)(g128L, g128L, SIMD_MM_SHUFFLE(0, 0, 0, 0));
-        auto g128R = SIMD_MM(load_ss)(&gR);
-        g128R = SIMD_MM(shuffle_ps)(g128R, g128R, SIMD_MM_SHUFFLE(0, 0, 0, 0));
+    /*
+    ** This is SIMD for the convolution described above
+    */
+    float *obf = &oscbuffer[bufpos + delay];
+    float *obfR = &oscbufferR[bufpos + delay];
 
-        for (k = 0; k < FIRipol_N; k += 4)
-        {
-            float *obfL = &oscbuffer[bufpos + k + delay];
-            float *obfR = &oscbufferR[bufpos + k + delay];
-            auto obL = SIMD_MM(loadu_ps)(obfL);
-            auto obR = SIMD_MM(loadu_ps)(obfR);
-            auto st = SIMD_MM(load_ps)(&storage->sinctable[m + k]);
-            auto so = SIMD_MM(load_ps)(&storage->sinctable[m + k + FIRipol_N]);
-            so = SIMD_MM(mul_ps)(so, lipol128);
-            st = SIMD_MM(add_ps)(st, so);
-            obL = SIMD_MM(add_ps)(obL, SIMD_MM(mul_ps)(st, g128L));
-            SIMD_MM(storeu_ps)(obfL, obL);
-            obR = SIMD_MM(add_ps)(obR, SIMD_MM(mul_ps)(st, g128R));
-            SIMD_MM(storeu_ps)(obfR, obR);
-        }
-    }
+#if SURGE_BLIT_HAS_WIDE
+    if (useWideConvolution)
+        addImpulseWide(storage->sinctable, obf, obfR, m, (float)lipolui16, g, gR, stereo);
     else
-    {
-        /*
-        ** This is SSE for the convolution described above
-        */
-        auto g128 = SIMD_MM(load_ss)(&g);
-        g128 = SIMD_MM(shuffle_ps)(g128, g128, SIMD_MM_SHUFFLE(0, 0, 0, 0));
-
-        for (k = 0; k < FIRipol_N; k += 4)
-        {
-            float *obf = &oscbuffer[bufpos + k + delay]; // Get buffer[pos + delay + k ]
-            auto ob = SIMD_MM(loadu_ps)(obf);
-            auto st = SIMD_MM(load_ps)(
-                &storage->sinctable[m + k]); // get the sinctable for our fractional position
-            auto so =
-                SIMD_MM(load_ps)(&storage->sinctable[m + k + FIRipol_N]); // get the sinctable deriv
-            so = SIMD_MM(mul_ps)(so, lipol128); // scale the deriv by the lipol fractional time
-            st = SIMD_MM(add_ps)(st, so);       // this is now st = sinctable + dt * dsinctable
-            st = SIMD_MM(mul_ps)(st, g128); // so this is now the convolved difference, g * kernel
-            ob = SIMD_MM(add_ps)(ob, st);   // which we add back onto the buffer
-            SIMD_MM(storeu_ps)(obf, ob);    // and store.
-        }
-    }
+#endif
+        addImpulse(storage->sinctable, obf, obfR, m, (float)lipolui16, g, gR, stereo);
 
     float olddc = dc_uni[voice];
     dc_uni[voice] = t_inv * (1.f + wf) * (1 - sub);
@@ -52,6 +52,14 @@ class ClassicOscillator : public AbstractBlitOscillator
     template <bool FM> void convolute(int voice, bool stereo);
     virtual ~ClassicOscillator();
 
+    /*
+     * Where the CPU has AVX and FMA, convolute can add each impulse 8 taps to a register with
+     * fused multiply-adds. That rounds differently from the SSE kernel, so it is only on when
+     * SurgeStorage::useWideBlitConvolution asks for it; otherwise every machine renders alike.
+     */
+    static bool wideConvolutionAvailable();
+    bool useWideConvolution{false};
+
   private:
     bool first_run;
     float dc, dc_uni[MAX_UNISON], elapsed_time[MAX_UNISON], last_level[MAX_UNISON],
@@ -90,42 +90,217 @@ std::string stringosc_excitation_name(int i)
 
 StringOscillator::~StringOscillator()
 {
-    if (storage && !ownDelayLines)
+    switch (delayTier)
     {
-        if (delayLine[0])
-            storage->memoryPools->stringDelayLines.returnItem(delayLine[0]);
-        if (delayLine[1])
-            storage->memoryPools->stringDelayLines.returnItem(delayLine[1]);
+    case 0:
+        returnDelayLines<0>();
+        break;
+    case 1:
+        returnDelayLines<1>();
+        break;
+    case 2:
+        returnDelayLines<2>();
+        break;
     }
-    else
+};
+
+static constexpr double delayTierCombSizes[StringOscillator::nDelayTiers] = {
+    StringOscillator::delayLine_t<0>::comb_size, StringOscillator::delayLine_t<1>::comb_size,
+    StringOscillator::delayLine_t<2>::comb_size};
+
+int StringOscillator::delayTierFor(double delay)
+{
+    // an octave to spare, and room for the sinc taps and the clamp in process_block_internal
+    for (int tier = 0; tier < nDelayTiers - 1; ++tier)
     {
-        if (delayLine[0])
-            delete delayLine[0];
-        if (delayLine[1])
-            delete delayLine[1];
+        if (2 * delay < delayTierSizes[tier] - 100)
+            return tier;
     }
-};
 
-void StringOscillator::init(float pitch, bool is_display, bool nzi)
+    return nDelayTiers - 1;
+}
+
+bool StringOscillator::isFMCarrier()
 {
-    // fixme - alloc in is_display but for now just deal with the race
-    // delayLine[0] = std::make_unique<SSESincDelayLine<16384>>();
-    // delayLine[1] = std::make_unique<SSESincDelayLine<16384>>();
-    if (is_display)
+    for (const auto &sc : storage->getPatch().scene)
     {
-        ownDelayLines = true;
-        delayLine[0] = new SSESincDelayLine<16384>(storage->sinctable);
-        delayLine[1] = new SSESincDelayLine<16384>(storage->sinctable);
+        for (int o = 0; o < n_oscs; ++o)
+        {
+            if (&sc.osc[o] != oscdata)
+                continue;
+
+            switch (sc.fm_switch.val.i)
+            {
+            case fm_2to1:
+            case fm_2and3to1:
+                return o == 0;
+            case fm_3to2to1:
+                return o < 2;
+            default:
+                return false;
+            }
+        }
     }
-    else
+
+    return false;
+}
+
+bool StringOscillator::hasDelayLines()
+{
+    switch (delayTier)
+    {
+    case 0:
+        return std::get<0>(delayLines)[0] && std::get<0>(delayLines)[1];
+    case 1:
+        return std::get<1>(delayLines)[0] && std::get<1>(delayLines)[1];
+    case 2:
+        return std::get<2>(delayLines)[0] && std::get<2>(delayLines)[1];
+    }
+
+    return false;
+}
+
+template <int tier> bool StringOscillator::takeDelayLines()
+{
+    auto &dl = std::get<tier>(delayLines);
+    auto &pool = storage->memoryPools->stringDelayLinePool<tier>();
+
+    for (auto &d : dl)
+    {
+        if (!d)
+            d = pool.getItem(storage->sinctable);
+    }
+
+    if (dl[0] && dl[1])
+        return true;
+
+    // the pool ran dry and may not allocate here, so give back what we got
+    for (auto &d : dl)
     {
-        ownDelayLines = false;
-        if (!delayLine[0])
-            delayLine[0] = storage->memoryPools->stringDelayLines.getItem(storage->sinctable);
-        if (!delayLine[1])
-            delayLine[1] = storage->memoryPools->stringDelayLines.getItem(storage->sinctable);
+        if (d)
+            pool.returnItem(d);
+        d = nullptr;
     }
 
+    return false;
+}
+
+template <int tier> void StringOscillator::returnDelayLines()
+{
+    for (auto &d : std::get<tier>(delayLines))
+    {
+        if (!d)
+            continue;
+
+        if (ownDelayLines)
+            delete d;
+        else
+            storage->memoryPools->stringDelayLinePool<tier>().returnItem(d);
+
+        d = nullptr;
+    }
+}
+
+template <int from, int to> void StringOscillator::moveDelayLines()
+{
+    if (!takeDelayLines<to>())
+        return;
+
+    auto &src = std::get<from>(delayLines);
+    auto &dst = std::get<to>(delayLines);
+    constexpr int n = delayTierSizes[from], nTo = delayTierSizes[to];
+
+    /*
+     * Replay the old line into the new one, so the string carries on where it was. The old line
+     * only holds the last n - 1 samples and a jump down can read further back than that, so past
+     * those the string is carried back a period at a time. That is close to what the bigger line
+     * would have held, though not exact, since the string was a little louder back then.
+     */
+    for (int t = 0; t < 2; ++t)
+    {
+        auto &s = src[t];
+        auto period = std::clamp((double)tap[t].v * getOversampleLevel(), 1.0, n - 2.0);
+        auto at = [&s](int age) { return s->buffer[(s->wp - age) & (n - 1)]; };
+
+        dst[t]->clear();
+
+        for (int k = nTo - 1; k > 0; --k)
+        {
+            if (k < n)
+            {
+                dst[t]->write(at(k));
+                continue;
+            }
+
+            auto age = k - period * std::ceil((k - (n - 1)) / period);
+            auto ia = (int)age;
+            auto frac = (float)(age - ia);
+
+            dst[t]->write(at(ia) * (1.f - frac) + at(std::min(ia + 1, n - 1)) * frac);
+        }
+    }
+
+    returnDelayLines<from>();
+    delayTier = to;
+}
+
+void StringOscillator::moveToDelayTier(int tier)
+{
+    if (tier <= delayTier || ownDelayLines)
+        return;
+
+    switch (delayTier * nDelayTiers + tier)
+    {
+    case 0 * nDelayTiers + 1:
+        moveDelayLines<0, 1>();
+        break;
+    case 0 * nDelayTiers + 2:
+        moveDelayLines<0, 2>();
+        break;
+    case 1 * nDelayTiers + 2:
+        moveDelayLines<1, 2>();
+        break;
+    }
+}
+
+void StringOscillator::clearDelayLines()
+{
+    auto clear = [](auto &dl) {
+        for (auto d : dl)
+            if (d)
+                d->clear();
+    };
+
+    std::apply([&clear](auto &...dl) { (clear(dl), ...); }, delayLines);
+}
+
+void StringOscillator::writeDelayLines(float v0, float v1)
+{
+    auto write = [v0, v1](auto &dl) {
+        if (dl[0] && dl[1])
+        {
+            dl[0]->write(v0);
+            dl[1]->write(v1);
+        }
+    };
+
+    std::apply([&write](auto &...dl) { (write(dl), ...); }, delayLines);
+}
+
+float StringOscillator::lastWrittenSample(int t)
+{
+    float res = 0.f;
+    auto last = [&res, t](auto &dl) {
+        if (dl[t])
+            res = dl[t]->buffer[(dl[t]->wp - 1) & dl[t]->comb_size];
+    };
+
+    std::apply([&last](auto &...dl) { (last(dl), ...); }, delayLines);
+    return res;
+}
+
+void StringOscillator::init(float pitch, bool is_display, bool nzi)
+{
     memset((void *)dustBuffer, 0, 2 * (BLOCK_SIZE_OS) * sizeof(float));
 
     id_exciterlvl = oscdata->p[str_exciter_level].param_id_in_scene;
@@ -170,8 +345,48 @@ void StringOscillator::init(float pitch, bool is_display, bool nzi)
                                            storage->note_to_pitch_inv(pitch2_t));
     }
 
-    pitchmult_inv = std::min(pitchmult_inv, (delayLine[0]->comb_size - 100) * 1.0);
-    pitchmult2_inv = std::min(pitchmult2_inv, (delayLine[0]->comb_size - 100) * 1.0);
+    if (delayTier < 0)
+    {
+        if (is_display)
+        {
+            ownDelayLines = true;
+            delayTier = nDelayTiers - 1;
+            std::get<nDelayTiers - 1>(delayLines) = {
+                new delayLine_t<nDelayTiers - 1>(storage->sinctable),
+                new delayLine_t<nDelayTiers - 1>(storage->sinctable)};
+        }
+        else
+        {
+            ownDelayLines = false;
+
+            auto tier = isFMCarrier() ? nDelayTiers - 1
+                                      : delayTierFor(std::max(pitchmult_inv, pitchmult2_inv) *
+                                                     getOversampleLevel());
+            bool took{false};
+
+            switch (tier)
+            {
+            case 0:
+                took = takeDelayLines<0>();
+                break;
+            case 1:
+                took = takeDelayLines<1>();
+                break;
+            default:
+                took = takeDelayLines<2>();
+                break;
+            }
+
+            // the pool ran dry and may not allocate here, so this voice stays silent
+            if (!took)
+                return;
+
+            delayTier = tier;
+        }
+    }
+
+    pitchmult_inv = std::min(pitchmult_inv, delayTierCombSizes[delayTier] - 100);
+    pitchmult2_inv = std::min(pitchmult2_inv, delayTierCombSizes[delayTier] - 100);
 
     noiseLp.coeff_LP2B(noiseLp.calc_omega(0) * OSC_OVERSAMPLING, 0.9);
     for (int i = 0; i < 3; ++i)
@@ -186,9 +401,10 @@ void StringOscillator::init(float pitch, bool is_display, bool nzi)
     // we need a big prefill to support the delay line for FM
     auto prefill = (int)floor(10 * std::max(pitchmult_inv, pitchmult2_inv) * getOversampleLevel());
 
+    clearDelayLines();
+
     for (int i = 0; i < 2; ++i)
     {
-        delayLine[i]->clear();
         driftLFO[i].init(nzi);
     }
 
@@ -364,15 +580,12 @@ void StringOscillator::init(float pitch, bool is_display, bool nzi)
         lp.process_sample(dlv[0], dlv[1], lpt[0], lpt[1]);
         hp.process_sample(dlv[0], dlv[1], hpt[0], hpt[1]);
 
-        for (int t = 0; t < 2; ++t)
-        {
-            delayLine[t]->write(tone.v < 0 ? lpt[t] : hpt[t]);
-        }
+        writeDelayLines(tone.v < 0 ? lpt[0] : hpt[0], tone.v < 0 ? lpt[1] : hpt[1]);
     }
 
     for (int t = 0; t < 2; ++t)
     {
-        priorSample[t] = delayLine[t]->buffer[(delayLine[t]->wp - 1) & delayLine[t]->comb_size];
+        priorSample[t] = lastWrittenSample(t);
     }
 
     charFilt.init(storage->getPatch().character.val.i);
@@ -472,6 +685,75 @@ int StringOscillator::getOversampleLevel()
 }
 
 void StringOscillator::process_block(float pitch, float drift, bool stereo, bool FM, float fmdepthV)
+{
+    if (!hasDelayLines())
+    {
+        memset(output, 0, BLOCK_SIZE_OS * sizeof(float));
+        memset(outputR, 0, BLOCK_SIZE_OS * sizeof(float));
+        return;
+    }
+
+    // FM may have been switched on since the note started
+    if (FM)
+        moveToDelayTier(nDelayTiers - 1);
+
+    // if this block heads down past what the lines hold, move before rendering it, so it plays
+    // at the right pitch and reads history the old line still has
+    auto incomingDelay = std::max(longestDelay, longestDelayFor(pitch));
+
+    if (delayTier < nDelayTiers - 1 &&
+        incomingDelay > 0.75 * (delayTierCombSizes[delayTier] - 100))
+    {
+        moveToDelayTier(std::max(delayTier + 1, delayTierFor(incomingDelay)));
+    }
+
+    switch (delayTier)
+    {
+    case 0:
+        process_block_tier<0>(pitch, drift, stereo, FM, fmdepthV);
+        break;
+    case 1:
+        process_block_tier<1>(pitch, drift, stereo, FM, fmdepthV);
+        break;
+    default:
+        process_block_tier<2>(pitch, drift, stereo, FM, fmdepthV);
+        break;
+    }
+}
+
+double StringOscillator::longestDelayFor(float pitch)
+{
+    // the delays process_block_internal will ask for, less the drift, which the headroom above
+    // the move point covers
+    auto pitchadj = pitchAdjustmentForStiffness();
+    auto pitch_t = std::min(148.f, pitch + pitchadj);
+    double pitchmult_inv =
+        storage->dsamplerate_os * (1 / 8.175798915) * storage->note_to_pitch_inv(pitch_t);
+    double pitchmult2_inv;
+
+    if (oscdata->p[str_str2_detune].absolute)
+    {
+        auto frequency = Tunings::MIDI_0_FREQ * storage->note_to_pitch(pitch_t);
+        auto fac = oscdata->p[str_str2_detune].extend_range ? 12 * 16 : 16;
+
+        frequency = std::max(10.0, frequency + localcopy[id_str2detune].f * fac);
+        pitchmult2_inv = storage->dsamplerate_os / frequency;
+    }
+    else
+    {
+        auto p2off = oscdata->p[str_str2_detune].get_extended(localcopy[id_str2detune].f);
+        auto pitch2_t = std::min(148.f, pitch + p2off + pitchadj);
+
+        pitchmult2_inv =
+            storage->dsamplerate_os * (1 / 8.175798915) * storage->note_to_pitch_inv(pitch2_t);
+    }
+
+    return std::max(pitchmult_inv, pitchmult2_inv) * getOversampleLevel();
+}
+
+template <int tier>
+void StringOscillator::process_block_tier(float pitch, float drift, bool stereo, bool FM,
+                                          float fmdepthV)
 {
 #define P(m)                                                                                       \
     case m:                                                                                        \
@@ -479,22 +761,22 @@ void StringOscillator::process_block(float pitch, float drift, bool stereo, bool
         {                                                                                          \
             if (oss & StringOscillator::os_onex)                                                   \
             {                                                                                      \
-                process_block_internal<true, m, 1>(pitch, drift, stereo, fmdepthV);                \
+                process_block_internal<true, m, 1, tier>(pitch, drift, stereo, fmdepthV);          \
             }                                                                                      \
             else                                                                                   \
             {                                                                                      \
-                process_block_internal<true, m, 2>(pitch, drift, stereo, fmdepthV);                \
+                process_block_internal<true, m, 2, tier>(pitch, drift, stereo, fmdepthV);          \
             }                                                                                      \
         }                                                                                          \
         else                                                                                       \
         {                                                                                          \
             if (oss & StringOscillator::os_onex)                                                   \
             {                                                                                      \
-                process_block_internal<false, m, 1>(pitch, drift, stereo, fmdepthV);               \
+                process_block_internal<false, m, 1, tier>(pitch, drift, stereo, fmdepthV);         \
             }                                                                                      \
             else                                                                                   \
             {                                                                                      \
-                process_block_internal<false, m, 2>(pitch, drift, stereo, fmdepthV);               \
+                process_block_internal<false, m, 2, tier>(pitch, drift, stereo, fmdepthV);         \
             }                                                                                      \
         }                                                                                          \
         break;
@@ -526,7 +808,7 @@ void StringOscillator::process_block(float pitch, float drift, bool stereo, bool
 #undef P
 }
 
-template <bool FM, StringOscillator::exciter_modes mode, int OS>
+template <bool FM, StringOscillator::exciter_modes mode, int OS, int tier>
 void StringOscillator::process_block_internal(float pitch, float drift, bool stereo, float fmdepthV)
 {
     auto lfodetune = drift * driftLFO[0].next();
@@ -585,6 +867,9 @@ void StringOscillator::process_block_internal(float pitch, float drift, bool ste
     dp1 /= OS;
     dp2 /= OS;
 
+    auto &delayLine = std::get<tier>(delayLines);
+    longestDelay = std::max(pitchmult_inv, pitchmult2_inv) * OS;
+
     pitchmult_inv = std::min(pitchmult_inv, (delayLine[0]->comb_size - 100) * 1.0);
     pitchmult2_inv = std::min(pitchmult2_inv, (delayLine[0]->comb_size - 100) * 1.0);
 
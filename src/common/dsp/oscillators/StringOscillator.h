@@ -27,6 +27,7 @@
 #include "BiquadFilter.h"
 #include "OscillatorCommonFunctions.h"
 #include <random>
+#include <tuple>
 #include <sst/filters/HalfRateFilter.h>
 
 class StringOscillator : public Oscillator
@@ -100,7 +101,9 @@ class StringOscillator : public Oscillator
     virtual void process_block(float pitch, float drift = 0.f, bool stereo = false, bool FM = false,
                                float FMdepth = 0.f) override;
 
-    template <bool FM, exciter_modes mode, int OS>
+    template <int tier>
+    void process_block_tier(float pitch, float drift, bool stereo, bool FM, float FMdepth);
+    template <bool FM, exciter_modes mode, int OS, int tier>
     void process_block_internal(float pitch, float drift, bool stereo, float FMdepth);
 
     float phase1 = 0, phase2 = 0;
@@ -109,8 +112,39 @@ class StringOscillator : public Oscillator
 
     lag<float, true> examp, tap[2], t2level, feedback[2], tone, fmdepth;
 
-    std::array<SSESincDelayLine<16384> *, 2> delayLine{nullptr, nullptr};
+    /*
+     * The delay lines come in a few sizes, so that high notes run in small ones which stay in
+     * cache. A voice takes the smallest size which holds its longest delay an octave down, and
+     * before a block whose pitch takes it past most of that, moves up a size and brings the
+     * string along. FM stretches the delay by up to e^4, so FM carriers always take the biggest.
+     * Until a move the strings sound exactly as they would in the biggest line. A jump further
+     * down than the smaller line's history reaches plays on from a copy of the string's last
+     * period, rather than from what the bigger line would really have held.
+     */
+    static constexpr int nDelayTiers = 3;
+    static constexpr size_t delayTierSizes[nDelayTiers] = {2048, 4096, 16384};
+    template <int tier> using delayLine_t = SSESincDelayLine<delayTierSizes[tier]>;
+
+    std::tuple<std::array<delayLine_t<0> *, 2>, std::array<delayLine_t<1> *, 2>,
+               std::array<delayLine_t<2> *, 2>>
+        delayLines{};
+    int delayTier{-1};
     bool ownDelayLines{false};
+
+    // the longest delay the last block asked for, in samples at the rate the string runs at
+    double longestDelay{0};
+
+    static int delayTierFor(double delay);
+    double longestDelayFor(float pitch);
+    bool isFMCarrier();
+    bool hasDelayLines();
+    template <int tier> bool takeDelayLines();
+    template <int tier> void returnDelayLines();
+    template <int from, int to> void moveDelayLines();
+    void moveToDelayTier(int tier);
+    void clearDelayLines();
+    void writeDelayLines(float v0, float v1);
+    float lastWrittenSample(int t);
     float priorSample[2] = {0, 0};
     Surge::Oscillator::DriftLFO driftLFO[2];
     Surge::Oscillator::CharacterFilter<float> charFilt;
@@ -22,6 +22,9 @@
 
 #include "TwistOscillator.h"
 #include "DebugHelpers.h"
+#include "SurgeMemoryPools.h"
+
+#include <new>
 
 #define TEST
 #ifndef _MSC_VER
@@ -276,19 +279,39 @@ static struct EngineDynamicDeact : public ParameterDynamicDeactivationFunction
     }
 } etDynamicDeact;
 
-TwistOscillator::TwistOscillator(SurgeStorage *storage, OscillatorStorage *oscdata,
-                                 pdata *localcopy)
-    : Oscillator(storage, oscdata, localcopy), charFilt(storage)
+static constexpr size_t twistSharedBufferSize = 16384;
+
+TwistOscillator::Engine::Engine(double dsamplerate_os)
 {
-    lancRes = std::make_unique<resamp_t>(48000, storage->dsamplerate_os);
+    lancRes = std::make_unique<resamp_t>(48000, dsamplerate_os);
     voice = std::make_unique<plaits::Voice>();
-    shared_buffer = new char[16384];
-    alloc = std::make_unique<stmlib::BufferAllocator>(shared_buffer, 16384);
+    shared_buffer = std::make_unique<char[]>(twistSharedBufferSize);
+    alloc = std::make_unique<stmlib::BufferAllocator>(shared_buffer.get(), twistSharedBufferSize);
     patch = std::make_unique<plaits::Patch>();
     mod = std::make_unique<plaits::Modulations>();
 
     // FM downsampling with a linear interpolator is absolutely fine
-    fmDownSampler = std::make_unique<resamp_t>(storage->dsamplerate_os, 48000);
+    fmDownSampler = std::make_unique<resamp_t>(dsamplerate_os, 48000);
+}
+
+TwistOscillator::Engine::~Engine() = default;
+
+void TwistOscillator::Engine::reset(double dsamplerate_os)
+{
+    // the voice takes its memory from the allocator again in Init, so start that over
+    *alloc = stmlib::BufferAllocator(shared_buffer.get(), twistSharedBufferSize);
+
+    // and rebuild the resamplers where they are, so nothing from the last note is left in them
+    lancRes->~resamp_t();
+    new (lancRes.get()) resamp_t(48000, dsamplerate_os);
+    fmDownSampler->~resamp_t();
+    new (fmDownSampler.get()) resamp_t(dsamplerate_os, 48000);
+}
+
+TwistOscillator::TwistOscillator(SurgeStorage *storage, OscillatorStorage *oscdata,
+                                 pdata *localcopy)
+    : Oscillator(storage, oscdata, localcopy), charFilt(storage)
+{
 }
 
 float TwistOscillator::tuningAwarePitch(float pitch)
@@ -311,13 +334,33 @@ float TwistOscillator::tuningAwarePitch(float pitch)
 
 void TwistOscillator::init(float pitch, bool is_display, bool nonzero_drift)
 {
-    voice->Init(alloc.get());
+    if (!engine)
+    {
+        if (is_display)
+        {
+            ownEngine = true;
+            engine = new Engine(storage->dsamplerate_os);
+        }
+        else
+        {
+            ownEngine = false;
+            engine = storage->memoryPools->twistEngines.getItem(storage->dsamplerate_os);
+
+            // the pool ran dry and may not allocate here, so this voice stays silent
+            if (!engine)
+                return;
+
+            engine->reset(storage->dsamplerate_os);
+        }
+    }
+
+    engine->voice->Init(engine->alloc.get());
 
     charFilt.init(storage->getPatch().character.val.i);
 
     float tpitch = tuningAwarePitch(pitch);
-    memset((void *)patch.get(), 0, sizeof(plaits::Patch));
-    memset((void *)mod.get(), 0, sizeof(plaits::Modulations));
+    memset((void *)engine->patch.get(), 0, sizeof(plaits::Patch));
+    memset((void *)engine->mod.get(), 0, sizeof(plaits::Modulations));
 
     driftLFO.init(nonzero_drift);
 
@@ -341,22 +384,27 @@ void TwistOscillator::init(float pitch, bool is_display, bool nonzero_drift)
 }
 TwistOscillator::~TwistOscillator()
 {
-    if (shared_buffer)
-        delete[] shared_buffer;
+    if (!engine)
+        return;
+
+    if (ownEngine)
+        delete engine;
+    else
+        storage->memoryPools->twistEngines.returnItem(engine);
 }
 
 template <bool FM, bool throwaway>
 void TwistOscillator::process_block_internal(float pitch, float drift, bool stereo, float FMdepth,
                                              int throwawayBlocks)
 {
-    if (FM && !fmDownSampler)
+    if (FM && !engine->fmDownSampler)
         return;
 
     pitch = tuningAwarePitch(pitch);
 
     auto driftv = driftLFO.next();
-    patch->note = pitch + drift * driftv;
-    patch->engine = oscdata->p[twist_engine].val.i;
+    engine->patch->note = pitch + drift * driftv;
+    engine->patch->engine = oscdata->p[twist_engine].val.i;
 
     harm.newValue(limit_range(fvbp(twist_harmonics), -1.f, 1.f));
     timb.newValue(limit_range(fvbp(twist_timbre), -1.f, 1.f));
@@ -385,7 +433,7 @@ void TwistOscillator::process_block_internal(float pitch, float drift, bool ster
     {
         float dsmaster[2][BLOCK_SIZE_OS << 2];
         for (int i = 0; i < BLOCK_SIZE_OS; ++i)
-            fmDownSampler->push(master_osc[i], 0.f);
+            engine->fmDownSampler->push(master_osc[i], 0.f);
 
         const float bl = -143.5, bhi = 71.7, oos = 1.0 / (bhi - bl);
         float adb = limit_range(amp_to_db(FMdepth), bl, bhi);
@@ -394,7 +442,7 @@ void TwistOscillator::process_block_internal(float pitch, float drift, bool ster
         normFMdepth = limit_range(nfm, 0.f, 1.f);
 
         auto outputFramesGen =
-            fmDownSampler->populateNext(dsmaster[0], dsmaster[1], BLOCK_SIZE_OS << 2);
+            engine->fmDownSampler->populateNext(dsmaster[0], dsmaster[1], BLOCK_SIZE_OS << 2);
         for (int i = 0; i < outputFramesGen; ++i)
         {
             fmlagbuffer[fmwp] = dsmaster[0][i];
@@ -405,22 +453,22 @@ void TwistOscillator::process_block_internal(float pitch, float drift, bool ster
     int required_blocks = throwaway ? throwawayBlocks : BLOCK_SIZE_OS;
 
     int total_generated =
-        required_blocks - lancRes->inputsRequiredToGenerateOutputs(required_blocks);
+        required_blocks - engine->lancRes->inputsRequiredToGenerateOutputs(required_blocks);
 
     if (lpgIsOn)
     {
-        mod->trigger = gate ? 1.0 : 0.0;
-        mod->trigger_patched = true;
+        engine->mod->trigger = gate ? 1.0 : 0.0;
+        engine->mod->trigger_patched = true;
     }
 
     while (total_generated < required_blocks)
     {
         plaits::Voice::Frame poutput[max_subblock];
-        patch->harmonics = harm.v;
-        patch->timbre = timb.v;
-        patch->morph = morph.v;
-        patch->decay = lpgdec.v;
-        patch->lpg_colour = lpgcol.v;
+        engine->patch->harmonics = harm.v;
+        engine->patch->timbre = timb.v;
+        engine->patch->morph = morph.v;
+        engine->patch->decay = lpgdec.v;
+        engine->patch->lpg_colour = lpgcol.v;
 
         harm.process();
         timb.process();
@@ -430,35 +478,35 @@ void TwistOscillator::process_block_internal(float pitch, float drift, bool ster
 
         if (FM)
         {
-            mod->frequency_patched = true;
-            mod->frequency = 137 * fmlagbuffer[fmrp]; // this is in 'notes'
+            engine->mod->frequency_patched = true;
+            engine->mod->frequency = 137 * fmlagbuffer[fmrp]; // this is in 'notes'
             fmrp = (fmrp + 1) & ((BLOCK_SIZE_OS << 1) - 1);
-            patch->frequency_modulation_amount = normFMdepth;
+            engine->patch->frequency_modulation_amount = normFMdepth;
         }
         else
         {
-            mod->frequency_patched = false;
-            patch->frequency_modulation_amount = 0;
+            engine->mod->frequency_patched = false;
+            engine->patch->frequency_modulation_amount = 0;
         }
 
-        voice->Render(*patch, *mod, poutput, subblock);
+        engine->voice->Render(*engine->patch, *engine->mod, poutput, subblock);
 
         for (int i = 0; i < subblock; ++i)
         {
-            lancRes->push(poutput[i].out / 32768.f, poutput[i].aux / 32768.f);
+            engine->lancRes->push(poutput[i].out / 32768.f, poutput[i].aux / 32768.f);
         }
         total_generated =
-            required_blocks - lancRes->inputsRequiredToGenerateOutputs(required_blocks);
+            required_blocks - engine->lancRes->inputsRequiredToGenerateOutputs(required_blocks);
     }
 
     if (throwaway)
     {
-        lancRes->advanceReadPointer(required_blocks);
+        engine->lancRes->advanceReadPointer(required_blocks);
     }
     else
     {
         float tL[BLOCK_SIZE_OS], tR[BLOCK_SIZE_OS];
-        lancRes->populateNextBlockSizeOS(tL, tR);
+        engine->lancRes->populateNextBlockSizeOS(tL, tR);
 
         for (int i = 0; i < BLOCK_SIZE_OS; ++i)
         {
@@ -475,7 +523,7 @@ void TwistOscillator::process_block_internal(float pitch, float drift, bool ster
             auxmix.process();
         }
     }
-    lancRes->renormalizePhases();
+    engine->lancRes->renormalizePhases();
 
     if (!throwaway && charFilt.doFilter)
     {
@@ -495,6 +543,13 @@ void TwistOscillator::process_block_internal(float pitch, float drift, bool ster
 
 void TwistOscillator::process_block(float pitch, float drift, bool stereo, bool FM, float FMdepth)
 {
+    if (!engine)
+    {
+        memset(output, 0, BLOCK_SIZE_OS * sizeof(float));
+        memset(outputR, 0, BLOCK_SIZE_OS * sizeof(float));
+        return;
+    }
+
     if (FM)
     {
         TwistOscillator::process_block_internal<true>(pitch, drift, stereo, FMdepth);
@@ -82,12 +82,6 @@ class TwistOscillator : public Oscillator
         return clamp01((localcopy[oscdata->p[ps].param_id_in_scene].f + 1) * 0.5f);
     }
 
-    std::unique_ptr<plaits::Voice> voice;
-    std::unique_ptr<plaits::Patch> patch;
-    std::unique_ptr<plaits::Modulations> mod;
-    std::unique_ptr<stmlib::BufferAllocator> alloc;
-    char *shared_buffer{nullptr};
-
     // Keep this here for now even if using lanczos since I'm using SRC for FM still
     float fmlagbuffer[BLOCK_SIZE_OS << 1];
     int fmwp, fmrp;
@@ -95,7 +89,31 @@ class TwistOscillator : public Oscillator
     bool useCorrectLPGBlockSize{false}; // See #6760
 
     using resamp_t = sst::basic_blocks::dsp::LanczosResampler<BLOCK_SIZE>;
-    std::unique_ptr<resamp_t> lancRes, fmDownSampler;
+
+    /*
+     * The Plaits voice and the buffers and resamplers around it. These are large and take
+     * several allocations to build, so playing voices take one from the pool in
+     * SurgeMemoryPools at init and hand it back when they go away. Display oscillators, which
+     * run off the audio thread, build their own.
+     */
+    struct Engine
+    {
+        explicit Engine(double dsamplerate_os);
+        ~Engine();
+
+        // return to the state of a new engine at this rate, without allocating
+        void reset(double dsamplerate_os);
+
+        std::unique_ptr<plaits::Voice> voice;
+        std::unique_ptr<plaits::Patch> patch;
+        std::unique_ptr<plaits::Modulations> mod;
+        std::unique_ptr<stmlib::BufferAllocator> alloc;
+        std::unique_ptr<char[]> shared_buffer;
+        std::unique_ptr<resamp_t> lancRes, fmDownSampler;
+    };
+
+    Engine *engine{nullptr};
+    bool ownEngine{false};
 
     float carryover[BLOCK_SIZE_OS][2];
     int carrover_size = 0;
@@ -261,15 +261,43 @@ void WavetableOscillator::processSamplesForDisplay(float *samples, int size, boo
     // saturation
 };
 
+/*
+ * Everything the unison detune contributes to an impulse depends only on the voice and on
+ * values which are fixed for the block, so it is worked out for all the voices here rather
+ * than again for every impulse in convolute.
+ */
+void WavetableOscillator::updateDetuneRates()
+{
+    const bool absolute = oscdata->p[wt_unison_detune].absolute;
+    const float spread =
+        n_unison > 1 ? oscdata->p[wt_unison_detune].get_extended(localcopy[id_detune].f) : 0.f;
+    const float pitchInv = storage->note_to_pitch_inv_ignoring_tuning(pitch_t);
+
+    for (int l = 0; l < n_unison; l++)
+    {
+        double detune = drift * driftLFO[l].val();
+        if (n_unison > 1)
+            detune += spread * (detune_bias * float(l) + detune_offset);
+
+        if (absolute)
+        {
+            // See the comment in ClassicOscillator.cpp at the absolute treatment
+            detuneRate[l] =
+                storage->note_to_pitch_inv_ignoring_tuning(detune * pitchInv * 16 / 0.9443);
+            if (detuneRate[l] < 0.1)
+                detuneRate[l] = 0.1;
+        }
+        else
+        {
+            detuneRate[l] = storage->note_to_pitch_inv_tuningctr(detune);
+        }
+    }
+}
+
 void WavetableOscillator::convolute(int voice, bool FM, bool stereo)
 {
     float block_pos = oscstate[voice] * BLOCK_SIZE_OS_INV * pitchmult_inv;
 
-    double detune = drift * driftLFO[voice].val();
-    if (n_unison > 1)
-        detune += oscdata->p[wt_unison_detune].get_extended(localcopy[id_detune].f) *
-                  (detune_bias * float(voice) + detune_offset);
-
     const float p24 = (1 << 24);
     unsigned int ipos;
 
@@ -362,19 +390,7 @@ void WavetableOscillator::convolute(int voice, bool FM, bool stereo)
     float dt = (oscdata->wt.dt) * wt_inc;
 
     // add time until next statechange
-    float tempt;
-    if (oscdata->p[wt_unison_detune].absolute)
-    {
-        // See the comment in ClassicOscillator.cpp at the absolute treatment
-        tempt = storage->note_to_pitch_inv_ignoring_tuning(
-            detune * storage->note_to_pitch_inv_ignoring_tuning(pitch_t) * 16 / 0.9443);
-        if (tempt < 0.1)
-            tempt = 0.1;
-    }
-    else
-    {
-        tempt = storage->note_to_pitch_inv_tuningctr(detune);
-    }
+    float tempt = detuneRate[voice];
 
     float t;
     float xt = ((float)state[voice] + 0.5f) * dt;
@@ -695,6 +711,8 @@ void WavetableOscillator::process_block(float pitch0, float drift, bool stereo,
             driftLFO[l].next();
         }
 
+        updateDetuneRates();
+
         for (int s = 0; s < BLOCK_SIZE_OS; s++)
         {
             float fmmul = limit_range(1.f + depth * master_osc[s], 0.1f, 1.9f);
@@ -719,6 +737,17 @@ void WavetableOscillator::process_block(float pitch0, float drift, bool stereo,
         for (int l = 0; l < n_unison; l++)
         {
             driftLFO[l].next();
+        }
+
+        updateDetuneRates();
+
+        /*
+         * Unlike the Window oscillator, the voices can't share registers here. Each places its
+         * impulses at its own times, and a sample-playback table steps tableid and sampleloop on
+         * in voice order, so reordering them would change what plays.
+         */
+        for (int l = 0; l < n_unison; l++)
+        {
             while (oscstate[l] < a)
                 convolute(l, false, stereo);
             oscstate[l] -= a;
@@ -65,6 +65,7 @@ class WavetableOscillator : public AbstractBlitOscillator
 
   private:
     void convolute(int voice, bool FM, bool stereo);
+    void updateDetuneRates();
     template <bool is_init> void update_lagvals();
     inline float distort_level(float);
     void readDeformType();
@@ -77,6 +78,8 @@ class WavetableOscillator : public AbstractBlitOscillator
     float (WavetableOscillator::*deformSelected)(float, int);
     bool first_run;
     float oscpitch[MAX_UNISON];
+    // the time scale the unison detune gives each voice, which only changes once per block
+    float detuneRate[MAX_UNISON];
     float dc, dc_uni[MAX_UNISON], last_level[MAX_UNISON];
     float pitch;
     int mipmap[MAX_UNISON], mipmap_ofs[MAX_UNISON];
@@ -24,6 +24,7 @@
 #include "DSPUtils.h"
 
 #include <cstdint>
+#include <type_traits>
 #include "DebugHelpers.h"
 
 #ifdef _WIN32
@@ -185,6 +186,17 @@ inline unsigned int BigMULr16(unsigned int a, unsigned int b)
     return c >> 16u;
 }
 
+// lane v of the result is the sum of the four lanes of x[v]
+inline SIMD_M128I sumLanes(const SIMD_M128I *x)
+{
+    auto ab = SIMD_MM(add_epi32)(SIMD_MM(unpacklo_epi32)(x[0], x[1]),
+                                 SIMD_MM(unpackhi_epi32)(x[0], x[1]));
+    auto cd = SIMD_MM(add_epi32)(SIMD_MM(unpacklo_epi32)(x[2], x[3]),
+                                 SIMD_MM(unpackhi_epi32)(x[2], x[3]));
+
+    return SIMD_MM(add_epi32)(SIMD_MM(unpacklo_epi64)(ab, cd), SIMD_MM(unpackhi_epi64)(ab, cd));
+}
+
 void WindowOscillator::processSamplesForDisplay(float *samples, int size, bool real)
 {
     if (!real)
@@ -301,18 +313,40 @@ template <bool FM, bool Full16> void WindowOscillator::ProcessWindowOscs(bool st
         FormantMul = std::max(FormantMul >> WindowVsWavePO2, 1);
     }
 
-    {
-        // SSE2 path
-        for (int so = 0; so < NumUnison; so++)
+    /*
+     * The unison voices run four at a time, a voice to a lane. Each voice still reads its own
+     * tables and does its own sinc products, since SSE2 can't gather and one madd_epi16 already
+     * covers all eight taps of a voice. The horizontal sums, the shifts and the morph blend are
+     * done for the whole group at once, and the group is added up before it goes to the output.
+     * Integer sums come out the same in any order, so this matches running the voices one at a
+     * time exactly, which is what useUnisonLanes = false does.
+     */
+    const auto morphA = SIMD_MM(set1_ps)(1.f - FTable), morphB = SIMD_MM(set1_ps)(FTable);
+    const auto waveShift = SIMD_MM(cvtsi32_si128)(13 + (Full16 ? 1 : 0));
+
+    auto runVoices = [&](int so0, auto nVoices, auto inLanes) {
+        constexpr int N = decltype(nVoices)::value;
+        constexpr bool lanes = decltype(inLanes)::value;
+        static_assert(lanes || N == 1);
+
+        unsigned int Pos[N], RatioA[N], MipMapA[N], MipMapB[N];
+        short *WaveAdr[N], *WaveAdrP1[N], *WinAdr[N];
+        int GainL[N], GainR[N];
+
+        for (int v = 0; v < N; v++)
         {
-            unsigned int Pos = Window.Pos[so];
-            unsigned int RatioA = Window.Ratio[so];
+            int so = so0 + v;
+
+            Pos[v] = Window.Pos[so];
+            RatioA[v] = Window.Ratio[so];
+            GainL[v] = Window.Gain[so][0];
+            GainR[v] = Window.Gain[so][1];
 
             if (FM)
-                RatioA = Window.FMRatio[so][0];
+                RatioA[v] = Window.FMRatio[so][0];
 
-            unsigned int MipMapA = 0;
-            unsigned int MipMapB = 0;
+            MipMapA[v] = 0;
+            MipMapB[v] = 0;
 
             if (Window.Table[0][so] >= oscdata->wt.n_tables || oscdata->p[win_morph].extend_range)
             {
@@ -325,64 +359,96 @@ template <bool FM, bool Full16> void WindowOscillator::ProcessWindowOscs(bool st
             }
 
             unsigned long MSBpos;
-            unsigned int bs = BigMULr16(RatioA, 3 * FormantMul);
+            unsigned int bs = BigMULr16(RatioA[v], 3 * FormantMul);
 
             if (_BitScanReverse(&MSBpos, bs))
-                MipMapB = limit_range((int)MSBpos - 17, 0, oscdata->wt.size_po2 - 1);
+                MipMapB[v] = limit_range((int)MSBpos - 17, 0, oscdata->wt.size_po2 - 1);
+
+            if (_BitScanReverse(&MSBpos, 3 * RatioA[v]))
+                MipMapA[v] = limit_range((int)MSBpos - 17, 0, storage->WindowWT.size_po2 - 1);
 
-            if (_BitScanReverse(&MSBpos, 3 * RatioA))
-                MipMapA = limit_range((int)MSBpos - 17, 0, storage->WindowWT.size_po2 - 1);
+            WaveAdr[v] = oscdata->wt.TableI16WeakPointers[MipMapB[v]][Window.Table[0][so]];
+            WaveAdrP1[v] = oscdata->wt.TableI16WeakPointers[MipMapB[v]][Window.Table[1][so]];
+            WinAdr[v] = storage->WindowWT.TableI16WeakPointers[MipMapA[v]][SelWindow];
+        }
 
-            short *WaveAdr = oscdata->wt.TableI16WeakPointers[MipMapB][Window.Table[0][so]];
-            short *WaveAdrP1 = oscdata->wt.TableI16WeakPointers[MipMapB][Window.Table[1][so]];
-            short *WinAdr = storage->WindowWT.TableI16WeakPointers[MipMapA][SelWindow];
+        // lanes past the last voice stay zero
+        SIMD_M128I Wave[4], WaveP1[4], Win[4];
+
+        for (int v = N; v < 4; v++)
+        {
+            Wave[v] = WaveP1[v] = Win[v] = SIMD_MM(setzero_si128)();
+        }
 
-            for (int i = 0; i < BLOCK_SIZE_OS; i++)
+        for (int i = 0; i < BLOCK_SIZE_OS; i++)
+        {
+            for (int v = 0; v < N; v++)
             {
+                int so = so0 + v;
+
                 if (FM)
                 {
-                    Pos += Window.FMRatio[so][i];
+                    Pos[v] += Window.FMRatio[so][i];
                 }
                 else
                 {
-                    Pos += RatioA;
+                    Pos[v] += RatioA[v];
                 }
 
-                if (Pos & ~SizeMaskWin)
+                if (Pos[v] & ~SizeMaskWin)
                 {
                     Window.FormantMul[so] = FormantMul;
                     Window.Table[0][so] = Table;
                     Window.Table[1][so] = TablePlusOne;
-                    WaveAdr = oscdata->wt.TableI16WeakPointers[MipMapB][Table];
-                    WaveAdrP1 = oscdata->wt.TableI16WeakPointers[MipMapB][TablePlusOne];
-                    Pos = Pos & SizeMaskWin;
+                    WaveAdr[v] = oscdata->wt.TableI16WeakPointers[MipMapB[v]][Table];
+                    WaveAdrP1[v] = oscdata->wt.TableI16WeakPointers[MipMapB[v]][TablePlusOne];
+                    Pos[v] = Pos[v] & SizeMaskWin;
                 }
 
-                unsigned int WinPos = Pos >> (16 + MipMapA);
-                unsigned int WinSPos = (Pos >> (8 + MipMapA)) & 0xFF;
+                unsigned int WinPos = Pos[v] >> (16 + MipMapA[v]);
+                unsigned int WinSPos = (Pos[v] >> (8 + MipMapA[v])) & 0xFF;
 
-                unsigned int FPos = BigMULr16(Window.FormantMul[so], Pos) & SizeMask;
+                unsigned int FPos = BigMULr16(Window.FormantMul[so], Pos[v]) & SizeMask;
 
-                unsigned int MPos = FPos >> (16 + MipMapB);
-                unsigned int MSPos = ((FPos >> (8 + MipMapB)) & 0xFF);
+                unsigned int MPos = FPos >> (16 + MipMapB[v]);
+                unsigned int MSPos = ((FPos >> (8 + MipMapB[v])) & 0xFF);
 
-                SIMD_M128I Wave = SIMD_MM(madd_epi16)(
-                    SIMD_MM(load_si128)(((SIMD_M128I *)storage->sinctableI16 + MSPos)),
-                    SIMD_MM(loadu_si128)((SIMD_M128I *)&WaveAdr[MPos]));
-                SIMD_M128I WaveP1 = SIMD_MM(madd_epi16)(
-                    SIMD_MM(load_si128)(((SIMD_M128I *)storage->sinctableI16 + MSPos)),
-                    SIMD_MM(loadu_si128)((SIMD_M128I *)&WaveAdrP1[MPos]));
+                auto Sinc = SIMD_MM(load_si128)(((SIMD_M128I *)storage->sinctableI16 + MSPos));
 
-                SIMD_M128I Win = SIMD_MM(madd_epi16)(
+                Wave[v] = SIMD_MM(madd_epi16)(
+                    Sinc, SIMD_MM(loadu_si128)((SIMD_M128I *)&WaveAdr[v][MPos]));
+                WaveP1[v] = SIMD_MM(madd_epi16)(
+                    Sinc, SIMD_MM(loadu_si128)((SIMD_M128I *)&WaveAdrP1[v][MPos]));
+
+                Win[v] = SIMD_MM(madd_epi16)(
                     SIMD_MM(load_si128)(((SIMD_M128I *)storage->sinctableI16 + WinSPos)),
-                    SIMD_MM(loadu_si128)((SIMD_M128I *)&WinAdr[WinPos]));
+                    SIMD_MM(loadu_si128)((SIMD_M128I *)&WinAdr[v][WinPos]));
+            }
+
+            int iWin alignas(16)[4], iWave alignas(16)[4];
 
+            if constexpr (lanes)
+            {
+                // Sum, a voice to a lane
+                auto sWin = SIMD_MM(srai_epi32)(sumLanes(Win), 13);
+                auto sWave = SIMD_MM(sra_epi32)(sumLanes(Wave), waveShift);
+                auto sWaveP1 = SIMD_MM(sra_epi32)(sumLanes(WaveP1), waveShift);
+
+                sWave = SIMD_MM(cvttps_epi32)(
+                    SIMD_MM(add_ps)(SIMD_MM(mul_ps)(morphA, SIMD_MM(cvtepi32_ps)(sWave)),
+                                    SIMD_MM(mul_ps)(morphB, SIMD_MM(cvtepi32_ps)(sWaveP1))));
+
+                SIMD_MM(store_si128)((SIMD_M128I *)&iWin, sWin);
+                SIMD_MM(store_si128)((SIMD_M128I *)&iWave, sWave);
+            }
+            else
+            {
                 // Sum
-                int iWin alignas(16)[4], iWaveP1 alignas(16)[4], iWave alignas(16)[4];
+                int iWaveP1 alignas(16)[4];
 
-                SIMD_MM(store_si128)((SIMD_M128I *)&iWin, Win);
-                SIMD_MM(store_si128)((SIMD_M128I *)&iWave, Wave);
-                SIMD_MM(store_si128)((SIMD_M128I *)&iWaveP1, WaveP1);
+                SIMD_MM(store_si128)((SIMD_M128I *)&iWin, Win[0]);
+                SIMD_MM(store_si128)((SIMD_M128I *)&iWave, Wave[0]);
+                SIMD_MM(store_si128)((SIMD_M128I *)&iWaveP1, WaveP1[0]);
 
                 iWin[0] = (iWin[0] + iWin[1] + iWin[2] + iWin[3]) >> 13;
                 iWave[0] = (iWave[0] + iWave[1] + iWave[2] + iWave[3]) >> (13 + (Full16 ? 1 : 0));
@@ -390,18 +456,66 @@ template <bool FM, bool Full16> void WindowOscillator::ProcessWindowOscs(bool st
                     (iWaveP1[0] + iWaveP1[1] + iWaveP1[2] + iWaveP1[3]) >> (13 + (Full16 ? 1 : 0));
 
                 iWave[0] = (int)((1.f - FTable) * iWave[0] + FTable * iWaveP1[0]);
+            }
+
+            int OutL = 0, OutR = 0;
 
+            for (int v = 0; v < N; v++)
+            {
                 if (stereo)
                 {
-                    int Out = (iWin[0] * iWave[0]) >> 7;
-                    IOutputL[i] += (Out * (int)Window.Gain[so][0]) >> 6;
-                    IOutputR[i] += (Out * (int)Window.Gain[so][1]) >> 6;
+                    int Out = (iWin[v] * iWave[v]) >> 7;
+                    OutL += (Out * GainL[v]) >> 6;
+                    OutR += (Out * GainR[v]) >> 6;
                 }
                 else
-                    IOutputL[i] += (iWin[0] * iWave[0]) >> 6;
+                    OutL += (iWin[v] * iWave[v]) >> 6;
             }
 
-            Window.Pos[so] = Pos;
+            IOutputL[i] += OutL;
+
+            if (stereo)
+                IOutputR[i] += OutR;
+        }
+
+        for (int v = 0; v < N; v++)
+        {
+            Window.Pos[so0 + v] = Pos[v];
+        }
+    };
+
+    using one = std::integral_constant<int, 1>;
+    using two = std::integral_constant<int, 2>;
+    using three = std::integral_constant<int, 3>;
+    using four = std::integral_constant<int, 4>;
+
+    int so = 0;
+
+    if (useUnisonLanes)
+    {
+        for (; so + 4 <= NumUnison; so += 4)
+        {
+            runVoices(so, four{}, std::true_type{});
+        }
+
+        switch (NumUnison - so)
+        {
+        case 1:
+            runVoices(so, one{}, std::true_type{});
+            break;
+        case 2:
+            runVoices(so, two{}, std::true_type{});
+            break;
+        case 3:
+            runVoices(so, three{}, std::true_type{});
+            break;
+        }
+    }
+    else
+    {
+        for (; so < NumUnison; so++)
+        {
+            runVoices(so, one{}, std::false_type{});
         }
     }
 }
@@ -56,6 +56,9 @@ class WindowOscillator : public Oscillator
 
     void processSamplesForDisplay(float *samples, int size, bool real) override;
 
+    // run the unison voices four to a register; off runs them one at a time, with the same result
+    bool useUnisonLanes{true};
+
   private:
     int IOutputL alignas(16)[BLOCK_SIZE_OS];
     int IOutputR alignas(16)[BLOCK_SIZE_OS];
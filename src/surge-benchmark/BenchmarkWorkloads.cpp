@@ -0,0 +1,274 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+#include "BenchmarkWorkloads.h"
+#include "HeadlessUtils.h"
+#include "version.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+namespace Surge
+{
+namespace Benchmark
+{
+static constexpr int polyphonySweep[] = {1, 2, 4, 8, 16, 32, 64};
+
+static Parameter *unisonParam(OscillatorStorage &osc)
+{
+    for (auto &p : osc.p)
+    {
+        if (p.ctrltype == ct_osccount)
+            return &p;
+    }
+    return nullptr;
+}
+
+static void setOscType(SurgeSynthesizer *surge, int type, int unison)
+{
+    auto &patch = surge->storage.getPatch();
+    auto &osc = patch.scene[0].osc[0];
+
+    osc.type.val.i = type;
+    patch.update_controls(false, &osc);
+
+    if (auto *u = unisonParam(osc))
+        u->val.i = std::clamp(unison, u->val_min.i, u->val_max.i);
+
+    // time the oscillator in question, not it plus two default saws
+    patch.scene[0].mute_o2.val.b = true;
+    patch.scene[0].mute_o3.val.b = true;
+}
+
+static std::string idSafe(std::string s)
+{
+    for (auto &c : s)
+    {
+        if (c == ' ' || c == '/' || c == '"' || c == '\\')
+            c = '_';
+    }
+    return s;
+}
+
+std::vector<Workload> allWorkloads()
+{
+    std::vector<Workload> res;
+
+    // oscillators without a unison control only get the single voice workload
+    auto probe = Surge::Headless::createSurge(48000);
+
+    for (int ot = 0; ot < n_osc_types; ++ot)
+    {
+        setOscType(probe.get(), ot, 1);
+        bool hasUnison = unisonParam(probe->storage.getPatch().scene[0].osc[0]) != nullptr;
+
+        for (auto unison : {1, 16})
+        {
+            if (unison > 1 && !hasUnison)
+                continue;
+
+            auto w = Workload();
+            w.group = "osc";
+            w.id = "osc/" + idSafe(osc_type_names[ot]) + "/unison" + std::to_string(unison);
+            w.voices = 4;
+            w.configure = [ot, unison](auto *surge) { setOscType(surge, ot, unison); };
+            res.push_back(w);
+        }
+    }
+
+    for (int fn = 0; fn < sst::filters::num_filter_types; ++fn)
+    {
+        if (fn == sst::filters::fut_none)
+            continue;
+
+        auto nst = std::max(1, sst::filters::fut_subcount[fn]);
+
+        for (int fs = 0; fs < nst; ++fs)
+        {
+            auto w = Workload();
+            w.group = "filter";
+            w.id = "filter/" + idSafe(sst::filters::filter_type_names[fn]) + "/subtype" +
+                   std::to_string(fs);
+            w.voices = 8;
+            w.configure = [fn, fs](auto *surge) {
+                auto &fu = surge->storage.getPatch().scene[0].filterunit[0];
+                fu.type.val.i = fn;
+                fu.subtype.val.i = fs;
+            };
+            res.push_back(w);
+        }
+    }
+
+    for (int wt = 0; wt < (int)sst::waveshapers::WaveshaperType::n_ws_types; ++wt)
+    {
+        auto w = Workload();
+        w.group = "waveshaper";
+        w.id = "waveshaper/" + idSafe(sst::waveshapers::wst_names[wt]);
+        w.voices = 8;
+        w.configure = [wt](auto *surge) {
+            auto &ws = surge->storage.getPatch().scene[0].wsunit;
+            ws.type.val.i = wt;
+            ws.drive.set_value_f01(0.8);
+        };
+        res.push_back(w);
+    }
+
+    for (int ft = 0; ft < n_fx_types; ++ft)
+    {
+        auto w = Workload();
+        w.group = "fx";
+        w.id = "fx/" + idSafe(fx_type_names[ft]);
+        w.voices = 4;
+        w.configure = [ft](auto *surge) {
+            // same route as the UI, so the effect is built and initialized by the engine
+            auto *pt = &(surge->storage.getPatch().fx[fxslot_ains1].type);
+            auto v = 1.f * ft / (pt->val_max.i - pt->val_min.i);
+            surge->setParameter01(surge->idForParameter(pt), v, false);
+        };
+        res.push_back(w);
+    }
+
+    for (auto v : polyphonySweep)
+    {
+        auto w = Workload();
+        w.group = "polyphony";
+        w.id = "polyphony/" + std::to_string(v);
+        w.voices = v;
+        w.configure = [](auto *) {};
+        res.push_back(w);
+    }
+
+    return res;
+}
+
+Result runWorkload(const Workload &w, const RunConfig &cfg)
+{
+    auto surge = Surge::Headless::createSurge(cfg.sampleRate);
+    auto &patch = surge->storage.getPatch();
+
+    surge->storage.rngGen.g.seed(cfg.seed);
+    patch.polylimit.val.i = std::max(patch.polylimit.val.i, w.voices);
+
+    w.configure(surge.get());
+
+    // let queued oscillator and effect changes land before any notes
+    for (int i = 0; i < 10; ++i)
+        surge->process();
+
+    // distinct keys so no voice steals another, spread so pitch dependent costs average out
+    for (int v = 0; v < w.voices; ++v)
+        surge->playNote(0, 30 + v, 100, 0);
+
+    for (int i = 0; i < cfg.warmupBlocks; ++i)
+        surge->process();
+
+    std::vector<double> nsPerSample;
+    double sumSquares = 0;
+    int64_t samples = 0;
+
+    for (int r = 0; r < cfg.repeats; ++r)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < cfg.blocks; ++i)
+        {
+            surge->process();
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        nsPerSample.push_back((double)ns / (cfg.blocks * BLOCK_SIZE));
+
+        // outside the timed loop: only the last block of each repeat, which is enough to
+        // notice a silent workload without adding work to what we measure
+        for (int i = 0; i < BLOCK_SIZE; ++i)
+        {
+            sumSquares += surge->output[0][i] * surge->output[0][i] +
+                          surge->output[1][i] * surge->output[1][i];
+        }
+        samples += 2 * BLOCK_SIZE;
+    }
+
+    std::sort(nsPerSample.begin(), nsPerSample.end());
+
+    auto res = Result();
+    res.workload = &w;
+    res.nsPerSampleMedian = nsPerSample[nsPerSample.size() / 2];
+    res.nsPerSampleMin = nsPerSample.front();
+
+    auto realtimeNsPerSample = 1.0e9 / cfg.sampleRate;
+    res.voicesPerCore = w.voices * realtimeNsPerSample / std::max(res.nsPerSampleMedian, 1e-9);
+    res.outputRMS = samples ? std::sqrt(sumSquares / samples) : 0.0;
+
+    return res;
+}
+
+static std::string jsonString(const std::string &s)
+{
+    std::string res = "\"";
+
+    for (auto c : s)
+    {
+        if (c == '"' || c == '\\')
+            res += '\\';
+        res += c;
+    }
+
+    return res + "\"";
+}
+
+void writeJSON(std::ostream &os, const RunConfig &cfg, const std::vector<Result> &results)
+{
+    os << std::setprecision(6);
+    os << "{\n"
+       << "  \"version\": " << jsonString(Surge::Build::FullVersionStr) << ",\n"
+       << "  \"git_hash\": " << jsonString(Surge::Build::GitHash) << ",\n"
+       << "  \"compiler\": " << jsonString(Surge::Build::BuildCompiler) << ",\n"
+       << "  \"arch\": " << jsonString(Surge::Build::BuildArch) << ",\n"
+       << "  \"block_size\": " << BLOCK_SIZE << ",\n"
+       << "  \"sample_rate\": " << cfg.sampleRate << ",\n"
+       << "  \"blocks\": " << cfg.blocks << ",\n"
+       << "  \"repeats\": " << cfg.repeats << ",\n"
+       << "  \"seed\": " << cfg.seed << ",\n"
+       << "  \"results\": [";
+
+    bool first = true;
+
+    for (const auto &r : results)
+    {
+        os << (first ? "\n" : ",\n");
+        first = false;
+
+        os << "    {\"id\": " << jsonString(r.workload->id)
+           << ", \"group\": " << jsonString(r.workload->group)
+           << ", \"voices\": " << r.workload->voices
+           << ", \"ns_per_sample\": " << r.nsPerSampleMedian
+           << ", \"ns_per_sample_min\": " << r.nsPerSampleMin
+           << ", \"voices_per_core\": " << r.voicesPerCore << ", \"output_rms\": " << r.outputRMS
+           << "}";
+    }
+
+    os << "\n  ]\n}\n";
+}
+} // namespace Benchmark
+} // namespace Surge
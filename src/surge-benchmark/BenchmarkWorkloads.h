@@ -0,0 +1,79 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+#ifndef SURGE_SRC_SURGE_BENCHMARK_BENCHMARKWORKLOADS_H
+#define SURGE_SRC_SURGE_BENCHMARK_BENCHMARKWORKLOADS_H
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "SurgeSynthesizer.h"
+
+namespace Surge
+{
+namespace Benchmark
+{
+/*
+ * One fixed benchmark. The id is built only from type names and settings, never from
+ * indices or the order workloads are listed in, so results can be diffed across commits.
+ */
+struct Workload
+{
+    std::string group; // osc, filter, waveshaper, fx or polyphony
+    std::string id;
+    int voices{1};
+
+    // called on a fresh headless synth, before any blocks run
+    std::function<void(SurgeSynthesizer *)> configure;
+};
+
+std::vector<Workload> allWorkloads();
+
+struct RunConfig
+{
+    int sampleRate{48000};
+    int blocks{1500};      // timed blocks per repeat
+    int warmupBlocks{100}; // untimed, after the notes start
+    int repeats{5};
+    unsigned int seed{0x5eed};
+};
+
+struct Result
+{
+    const Workload *workload{nullptr};
+    double nsPerSampleMedian{0}, nsPerSampleMin{0};
+    double voicesPerCore{0}; // voices a core could run in realtime at the median speed
+    double outputRMS{0};     // so a workload which went silent shows up
+};
+
+/*
+ * Every workload renders the same note sequence from the same RNG seed, so two runs of one
+ * build do identical work and only the timings differ.
+ */
+Result runWorkload(const Workload &w, const RunConfig &cfg);
+
+void writeJSON(std::ostream &os, const RunConfig &cfg, const std::vector<Result> &results);
+} // namespace Benchmark
+} // namespace Surge
+
+#endif // SURGE_SRC_SURGE_BENCHMARK_BENCHMARKWORKLOADS_H
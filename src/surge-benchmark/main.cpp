@@ -0,0 +1,124 @@
+/*
+ * Surge XT - a free and open source hybrid synthesizer,
+ * built by Surge Synth Team
+ *
+ * Learn more at https://surge-synthesizer.github.io/
+ *
+ * Copyright 2018-2024, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * Surge XT is released under the GNU General Public Licence v3
+ * or later (GPL-3.0-or-later). The license is found in the "LICENSE"
+ * file in the root of this repository, or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Surge was a commercial product from 2004-2018, copyright and ownership
+ * held by Claes Johanson at Vember Audio during that period.
+ * Claes made Surge open source in September 2018.
+ *
+ * All source for Surge XT is available at
+ * https://github.com/surge-synthesizer/surge
+ */
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "BenchmarkWorkloads.h"
+#include "version.h"
+
+/*
+ * Renders a fixed set of workloads (every oscillator, filter, waveshaper and effect type, plus
+ * a polyphony sweep) and writes ns/sample and voices per core as JSON, so runs from two
+ * commits can be diffed by workload id.
+ */
+static void usage()
+{
+    std::cout << "surge-benchmark: " << Surge::Build::FullVersionStr << "\n\n"
+              << "   --list                  # print the workload ids and exit\n"
+              << "   --match <text>          # only run workloads whose id contains text\n"
+              << "   --blocks <n>            # timed blocks per repeat\n"
+              << "   --repeats <n>           # repeats per workload; the median is reported\n"
+              << "   --sample-rate <hz>\n"
+              << "   --output <file.json>    # defaults to stdout\n";
+}
+
+int main(int argc, char **argv)
+{
+    Surge::Benchmark::RunConfig cfg;
+    std::string match, outputPath;
+    bool list{false};
+
+    for (int i = 1; i < argc; ++i)
+    {
+        auto arg = std::string(argv[i]);
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "Missing value for " << arg << "\n";
+                exit(1);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--list")
+            list = true;
+        else if (arg == "--match")
+            match = next();
+        else if (arg == "--blocks")
+            cfg.blocks = std::max(1, std::atoi(next().c_str()));
+        else if (arg == "--repeats")
+            cfg.repeats = std::max(1, std::atoi(next().c_str()));
+        else if (arg == "--sample-rate")
+            cfg.sampleRate = std::max(1, std::atoi(next().c_str()));
+        else if (arg == "--output")
+            outputPath = next();
+        else
+        {
+            usage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    auto workloads = Surge::Benchmark::allWorkloads();
+
+    if (list)
+    {
+        for (const auto &w : workloads)
+            std::cout << w.id << "\n";
+        return 0;
+    }
+
+    std::vector<Surge::Benchmark::Result> results;
+
+    for (const auto &w : workloads)
+    {
+        if (!match.empty() && w.id.find(match) == std::string::npos)
+            continue;
+
+        // progress goes to stderr so stdout stays valid JSON
+        std::cerr << "# " << w.id << std::flush;
+        results.push_back(Surge::Benchmark::runWorkload(w, cfg));
+        std::cerr << " : " << results.back().nsPerSampleMedian << " ns/sample\n";
+    }
+
+    if (outputPath.empty())
+    {
+        Surge::Benchmark::writeJSON(std::cout, cfg, results);
+    }
+    else
+    {
+        std::ofstream ofs(outputPath);
+
+        if (!ofs)
+        {
+            std::cerr << "Unable to open " << outputPath << "\n";
+            return 1;
+        }
+
+        Surge::Benchmark::writeJSON(ofs, cfg, results);
+    }
+
+    return 0;
+}
@@ -23,11 +23,14 @@
 #include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
+#include <algorithm>
+#include <atomic>
 #include <thread>
 #include <utility>
 
 #include "SurgeSynthesizer.h"
 #include "SurgeStorage.h"
+#include "SurgeMemoryPools.h"
 #include "version.h"
 #include "filesystem/import.h"
 
@@ -992,6 +995,67 @@ class SurgeSynthesizerWithPythonExtensions : public SurgeSynthesizer
         return res;
     }
 
+    py::dict getStageProfile()
+    {
+#if SURGE_STAGE_PROFILER
+        auto res = py::dict();
+
+        for (int i = 0; i < Surge::Profiling::n_profile_stages; ++i)
+        {
+            auto st = (Surge::Profiling::Stage)i;
+            auto ss = stageProfiler.snapshot(st);
+            auto d = py::dict();
+
+            d["count"] = ss.count;
+            d["mean_ns"] = ss.meanNs();
+            d["max_ns"] = ss.maxNs;
+            d["p50_ns"] = ss.percentileNs(0.5);
+            d["p99_ns"] = ss.percentileNs(0.99);
+
+            auto b = py::list();
+            for (auto c : ss.buckets)
+                b.append(c);
+            d["log2_ns_buckets"] = b;
+
+            res[Surge::Profiling::stageName(st)] = d;
+        }
+
+        return res;
+#else
+        throw std::runtime_error(stageProfilerMissing);
+#endif
+    }
+
+    void resetStageProfile()
+    {
+#if SURGE_STAGE_PROFILER
+        stageProfiler.reset();
+#else
+        throw std::runtime_error(stageProfilerMissing);
+#endif
+    }
+
+    static constexpr const char *stageProfilerMissing =
+        "The stage profiler is not compiled in; rebuild with SURGE_BUILD_STAGE_PROFILER=ON";
+
+    bool isStageProfilerCompiledIn() const { return Surge::Profiling::StageProfiler::compiledIn; }
+
+    py::dict getMemoryPoolStats()
+    {
+        auto res = py::dict();
+
+        for (const auto &ps : storage.memoryPools->getPoolStats())
+        {
+            auto d = py::dict();
+
+            d["misses"] = ps.misses;
+            d["built"] = ps.built;
+            res[ps.name] = d;
+        }
+
+        return res;
+    }
+
     void loadSCLFile(const std::string &s)
     {
         try
@@ -1048,6 +1112,260 @@ SurgeSynthesizer *createSurge(float sr)
     return surge;
 }
 
+/*
+ * Renders many short (patch, parameter overrides, notes) jobs across a pool of Surge XT
+ * instances, one per worker thread. The jobs are converted to plain structs up front, so the
+ * workers run with the GIL released and a single call can keep every core busy.
+ *
+ * Instances are kept for the lifetime of the renderer. Each job starts with a patch load,
+ * which stops all voices and rebuilds the effects, so nothing rings over from the job before.
+ */
+class SurgePyBatchRenderer
+{
+  public:
+    struct NoteEvent
+    {
+        int block, channel, key, velocity;
+    };
+
+    struct Job
+    {
+        std::string patch;
+        std::vector<std::pair<int, float>> params;
+        std::vector<NoteEvent> events;
+    };
+
+    SurgePyBatchRenderer(float sr, int nThreads)
+    {
+        if (nThreads <= 0)
+            nThreads = std::max(1u, std::thread::hardware_concurrency());
+
+        for (int i = 0; i < nThreads; ++i)
+        {
+            synths.emplace_back(
+                static_cast<SurgeSynthesizerWithPythonExtensions *>(createSurge(sr)));
+        }
+    }
+
+    int getThreadCount() const { return (int)synths.size(); }
+
+    float getSampleRate() const { return synths[0]->storage.samplerate; }
+
+    py::array_t<float> createBatchBuffer(int nJobs, int nBlocks)
+    {
+        auto res = py::array_t<float>({nJobs, 2, nBlocks * BLOCK_SIZE});
+        auto buf = res.request(true);
+        memset(buf.ptr, 0, buf.size * sizeof(float));
+        return res;
+    }
+
+    /*
+     * The array is rendered into in place, so it is taken as it comes rather than as an
+     * array_t<float>: pybind would quietly hand us a converted copy of a float64 or strided
+     * array, and the caller would never see the output.
+     */
+    void render(const py::list &pyJobs, const py::array &arr)
+    {
+        if (!arr.dtype().is(py::dtype::of<float>()))
+        {
+            std::ostringstream oss;
+            oss << "Output numpy array must have dtype float32, as createBatchBuffer makes; you "
+                   "provided "
+                << py::str(arr.dtype()).cast<std::string>();
+            throw std::invalid_argument(oss.str().c_str());
+        }
+
+        if (!(arr.flags() & py::array::c_style))
+        {
+            throw std::invalid_argument(
+                "Output numpy array must be C contiguous, as createBatchBuffer makes; you "
+                "provided a strided view or a Fortran ordered array");
+        }
+
+        auto buf = arr.request(true);
+
+        if (buf.ndim != 3 || buf.shape[1] != 2 || buf.shape[2] % BLOCK_SIZE != 0 ||
+            buf.shape[0] != (py::ssize_t)pyJobs.size())
+        {
+            std::ostringstream oss;
+            oss << "Output numpy array must have dimensions (nJobs, 2, m*BLOCK_SIZE) "
+                   "and one row per job; you provided "
+                << buf.ndim << " dimensions for " << pyJobs.size() << " jobs";
+            throw std::invalid_argument(oss.str().c_str());
+        }
+
+        auto jobs = convertJobs(pyJobs);
+        auto nBlocks = (int)(buf.shape[2] / BLOCK_SIZE);
+        auto *out = static_cast<float *>(buf.ptr);
+        std::vector<std::string> errors(jobs.size());
+
+        {
+            py::gil_scoped_release nogil;
+
+            std::atomic<size_t> next{0};
+            auto work = [&](SurgeSynthesizerWithPythonExtensions *s) {
+                for (auto j = next++; j < jobs.size(); j = next++)
+                {
+                    auto *dL = out + j * 2 * nBlocks * BLOCK_SIZE;
+
+                    try
+                    {
+                        errors[j] = renderJob(s, jobs[j], dL, dL + nBlocks * BLOCK_SIZE, nBlocks);
+                    }
+                    catch (const std::exception &e)
+                    {
+                        errors[j] = e.what();
+                    }
+                }
+            };
+
+            auto nWorkers = std::min(synths.size(), jobs.size());
+            std::vector<std::thread> workers;
+
+            // the calling thread is a worker too, so a single job costs no thread start
+            for (size_t i = 1; i < nWorkers; ++i)
+            {
+                workers.emplace_back(work, synths[i].get());
+            }
+
+            if (nWorkers > 0)
+                work(synths[0].get());
+
+            for (auto &w : workers)
+            {
+                w.join();
+            }
+        }
+
+        for (size_t j = 0; j < errors.size(); ++j)
+        {
+            if (!errors[j].empty())
+            {
+                std::ostringstream oss;
+                oss << "Job " << j << ": " << errors[j];
+                throw std::runtime_error(oss.str().c_str());
+            }
+        }
+    }
+
+  private:
+    /*
+     * Python objects may only be touched with the GIL held, so everything the workers need is
+     * pulled out of the job list here, and any bad input is reported before rendering starts.
+     */
+    std::vector<Job> convertJobs(const py::list &pyJobs)
+    {
+        std::vector<Job> res;
+        res.reserve(pyJobs.size());
+
+        for (const auto &pj : pyJobs)
+        {
+            auto t = pj.cast<py::sequence>();
+
+            if (t.size() != 3)
+            {
+                throw std::invalid_argument(
+                    "Each job must be a (patchPath, {param: value}, [(block, channel, key, "
+                    "velocity)]) tuple");
+            }
+
+            Job job;
+            job.patch = t[0].cast<std::string>();
+
+            if (!fs::exists(string_to_path(job.patch)))
+            {
+                throw std::invalid_argument((std::string("File not found: ") + job.patch).c_str());
+            }
+
+            for (const auto &[k, v] : t[1].cast<py::dict>())
+            {
+                auto id = k.cast<SurgePyNamedParam>().getID().getSynthSideId();
+
+                if (id < 0 || id >= n_total_params)
+                {
+                    throw std::invalid_argument("Parameter override with an invalid id");
+                }
+
+                job.params.emplace_back(id, v.cast<float>());
+            }
+
+            for (const auto &pe : t[2].cast<py::sequence>())
+            {
+                auto e = pe.cast<std::tuple<int, int, int, int>>();
+                job.events.push_back(
+                    {std::get<0>(e), std::get<1>(e), std::get<2>(e), std::get<3>(e)});
+            }
+
+            std::stable_sort(job.events.begin(), job.events.end(),
+                             [](const auto &a, const auto &b) { return a.block < b.block; });
+
+            res.push_back(std::move(job));
+        }
+
+        return res;
+    }
+
+    /*
+     * Runs on a worker without the GIL. Returns an error message, or an empty string if the job
+     * rendered; a failed job leaves its rows zeroed.
+     */
+    static std::string renderJob(SurgeSynthesizerWithPythonExtensions *s, const Job &job, float *dL,
+                                 float *dR, int nBlocks)
+    {
+        auto path = string_to_path(job.patch);
+
+        s->time_data.ppqPos = 0;
+        s->process_input = false;
+
+        if (!s->loadPatchByPath(job.patch.c_str(), -1, path.filename().u8string().c_str()))
+        {
+            memset(dL, 0, nBlocks * BLOCK_SIZE * sizeof(float));
+            memset(dR, 0, nBlocks * BLOCK_SIZE * sizeof(float));
+            return "Unable to load patch " + job.patch;
+        }
+
+        s->time_data.tempo = s->storage.unstreamedTempo > -1.f ? s->storage.unstreamedTempo : 120;
+
+        // the instance is pooled, so don't let the jobs it ran before pick this one's randomness
+        s->resetRandomState(renderSeed);
+
+        for (const auto &[id, val] : job.params)
+        {
+            auto *p = s->storage.getPatch().param_ptr[id];
+            if (!p)
+                continue;
+
+            s->setParameter01(s->idForParameter(p), p->value_to_normalized(val));
+        }
+
+        auto ev = job.events.begin();
+
+        for (int b = 0; b < nBlocks; ++b)
+        {
+            for (; ev != job.events.end() && ev->block <= b; ++ev)
+            {
+                if (ev->velocity > 0)
+                    s->playNote(ev->channel, ev->key, ev->velocity, 0);
+                else
+                    s->releaseNote(ev->channel, ev->key, 0);
+            }
+
+            s->process();
+            s->time_data.ppqPos +=
+                (double)BLOCK_SIZE * s->time_data.tempo / (60. * s->storage.samplerate);
+
+            memcpy(dL + b * BLOCK_SIZE, s->output[0], BLOCK_SIZE * sizeof(float));
+            memcpy(dR + b * BLOCK_SIZE, s->output[1], BLOCK_SIZE * sizeof(float));
+        }
+
+        return {};
+    }
+
+    static constexpr unsigned int renderSeed{0x5eed};
+
+    std::vector<std::unique_ptr<SurgeSynthesizerWithPythonExtensions>> synths;
+};
+
 // Prefix _ if using shared object within a Python package built with scikit-build
 #ifdef SKBUILD
 PYBIND11_MODULE(_surgepy, m)
@@ -1057,8 +1375,33 @@ PYBIND11_MODULE(surgepy, m)
 {
     m.doc() = "Python bindings for Surge XT Synthesizer";
     m.def("createSurge", &createSurge, "Create a Surge XT instance", py::arg("sampleRate"));
+    m.def(
+        "getBlockSize", []() { return BLOCK_SIZE; },
+        "Get the block size this module's engine was built with (SURGE_COMPILE_BLOCK_SIZE)");
     m.def(
         "getVersion", []() { return Surge::Build::FullVersionStr; }, "Get the version of Surge XT");
+    py::class_<SurgePyBatchRenderer>(m, "SurgeBatchRenderer")
+        .def(py::init<float, int>(), py::arg("sampleRate"), py::arg("nThreads") = 0)
+        .def("getThreadCount", &SurgePyBatchRenderer::getThreadCount,
+             "Get the number of instances (and so threads) this renderer uses.")
+        .def("getSampleRate", &SurgePyBatchRenderer::getSampleRate,
+             "Get the sample rate the instances run at.")
+        .def("createBatchBuffer", &SurgePyBatchRenderer::createBatchBuffer,
+             "Create a zeroed numpy array of shape (nJobs, 2, nBlocks * BLOCK_SIZE) for render.",
+             py::arg("nJobs"), py::arg("nBlocks"))
+        .def("render", &SurgePyBatchRenderer::render,
+             "Render a list of (patchPath, {SurgeNamedParamId: value}, [(block, channel, key, "
+             "velocity)]) jobs\n"
+             "into the rows of an array made by createBatchBuffer, spread over the renderer's "
+             "threads with the GIL\n"
+             "released. Each job starts from a freshly loaded patch; a velocity of 0 releases "
+             "the key.",
+             py::arg("jobs"), py::arg("outVal"))
+        .def("__repr__", [](SurgePyBatchRenderer &r) {
+            return std::string("<SurgeBatchRenderer threads=") +
+                   std::to_string(r.getThreadCount()) + ">";
+        });
+
     py::class_<SurgeSynthesizer::ID>(m, "SurgeSynthesizer_ID")
         .def(py::init<>())
         .def("getSynthSideId", &SurgeSynthesizer::ID::getSynthSideId)
@@ -1185,6 +1528,19 @@ PYBIND11_MODULE(surgepy, m)
              "Get a Python dictionary with the Surge XT parameters laid out in the logical patch "
              "format")
 
+        .def("getStageProfile", &SurgeSynthesizerWithPythonExtensions::getStageProfile,
+             "Get the per-stage process() timing histograms as a dictionary keyed by stage. "
+             "Raises RuntimeError unless built with SURGE_BUILD_STAGE_PROFILER.")
+        .def("resetStageProfile", &SurgeSynthesizerWithPythonExtensions::resetStageProfile,
+             "Clear the per-stage timing histograms. Raises RuntimeError unless built with "
+             "SURGE_BUILD_STAGE_PROFILER.")
+        .def("isStageProfilerCompiledIn",
+             &SurgeSynthesizerWithPythonExtensions::isStageProfilerCompiledIn,
+             "Was this build made with the per-stage profiler?")
+        .def("getMemoryPoolStats", &SurgeSynthesizerWithPythonExtensions::getMemoryPoolStats,
+             "Get, for each oscillator memory pool, how many times a voice found it empty "
+             "('misses') and how many items the background refill has built ('built').")
+
         .def("loadSCLFile", &SurgeSynthesizerWithPythonExtensions::loadSCLFile,
              "Load an SCL tuning file and apply tuning to this instance")
         .def("retuneToStandardTuning",
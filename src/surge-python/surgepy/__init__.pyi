@@ -1,4 +1,5 @@
 from __future__ import annotations
+from surgepy._surgepy import SurgeBatchRenderer
 from surgepy._surgepy import SurgeControlGroup
 from surgepy._surgepy import SurgeControlGroupEntry
 from surgepy._surgepy import SurgeModRouting
@@ -9,6 +10,7 @@ from surgepy._surgepy import SurgeSynthesizer_ID
 from surgepy._surgepy import TuningApplicationMode
 from surgepy._surgepy import constants
 from surgepy._surgepy import createSurge
+from surgepy._surgepy import getBlockSize
 from surgepy._surgepy import getVersion
 from . import _surgepy
-__all__ = ['SurgeControlGroup', 'SurgeControlGroupEntry', 'SurgeModRouting', 'SurgeModSource', 'SurgeNamedParamId', 'SurgeSynthesizer', 'SurgeSynthesizer_ID', 'TuningApplicationMode', 'constants', 'createSurge', 'getVersion']
+__all__ = ['SurgeBatchRenderer', 'SurgeControlGroup', 'SurgeControlGroupEntry', 'SurgeModRouting', 'SurgeModSource', 'SurgeNamedParamId', 'SurgeSynthesizer', 'SurgeSynthesizer_ID', 'TuningApplicationMode', 'constants', 'createSurge', 'getBlockSize', 'getVersion']
@@ -5,7 +5,30 @@ from __future__ import annotations
 import numpy
 import typing
 from . import constants
-__all__ = ['SurgeControlGroup', 'SurgeControlGroupEntry', 'SurgeModRouting', 'SurgeModSource', 'SurgeNamedParamId', 'SurgeSynthesizer', 'SurgeSynthesizer_ID', 'TuningApplicationMode', 'constants', 'createSurge', 'getVersion']
+__all__ = ['SurgeBatchRenderer', 'SurgeControlGroup', 'SurgeControlGroupEntry', 'SurgeModRouting', 'SurgeModSource', 'SurgeNamedParamId', 'SurgeSynthesizer', 'SurgeSynthesizer_ID', 'TuningApplicationMode', 'constants', 'createSurge', 'getBlockSize', 'getVersion']
+class SurgeBatchRenderer:
+    def __init__(self, sampleRate: float, nThreads: int = 0) -> None:
+        ...
+    def __repr__(self) -> str:
+        ...
+    def createBatchBuffer(self, nJobs: int, nBlocks: int) -> numpy.ndarray[numpy.float32]:
+        """
+        Create a zeroed numpy array of shape (nJobs, 2, nBlocks * BLOCK_SIZE) for render.
+        """
+    def getSampleRate(self) -> float:
+        """
+        Get the sample rate the instances run at.
+        """
+    def getThreadCount(self) -> int:
+        """
+        Get the number of instances (and so threads) this renderer uses.
+        """
+    def render(self, jobs: list, outVal: numpy.ndarray[numpy.float32]) -> None:
+        """
+        Render a list of (patchPath, {SurgeNamedParamId: value}, [(block, channel, key, velocity)]) jobs
+        into the rows of an array made by createBatchBuffer, spread over the renderer's threads with the GIL
+        released. Each job starts from a freshly loaded patch; a velocity of 0 releases the key.
+        """
 class SurgeControlGroup:
     def __repr__(self) -> str:
         ...
@@ -273,6 +296,10 @@ def createSurge(sampleRate: float) -> SurgeSynthesizer:
     """
     Create a Surge XT instance
     """
+def getBlockSize() -> int:
+    """
+    Get the block size this module's engine was built with (SURGE_COMPILE_BLOCK_SIZE)
+    """
 def getVersion() -> str:
     """
     Get the version of Surge XT
@@ -22,6 +22,7 @@
 #include "HeadlessUtils.h"
 #include "Player.h"
 #include "filesystem/import.h"
+#include "FormulaModulationHelper.h"
 #include <iostream>
 #include <sstream>
 #include <chrono>
@@ -743,6 +744,48 @@ void generateNLFeedbackNorms()
               << "      if (useNormalization) normNumerator = lpNormTable[subtype];\n";
 }
 
+void formulaTiming()
+{
+    /*
+     * Times valueAt on a typical voice formula, once with the built-ins pushed into the state
+     * table every block as they used to be and once reading them from the FFI struct.
+     */
+    auto surge = createSurge(48000);
+    auto *storage = &surge->storage;
+
+    FormulaModulatorStorage fs;
+    fs.setFormula(R"FN(
+function process(state)
+    state.output = math.sin(state.phase * 2 * math.pi) * state.amplitude * state.cc_mw
+    return state
+end)FN");
+
+    static constexpr int evaluations = 200000;
+
+    for (auto bind : {false, true})
+    {
+        Surge::Formula::EvaluatorState es;
+        es.bindStateFields = bind;
+        Surge::Formula::prepareForEvaluation(storage, &fs, es, false);
+        Surge::Formula::setupEvaluatorStateFrom(es, storage->getPatch(), 0);
+
+        float r[Surge::Formula::max_formula_outputs];
+        for (int i = 0; i < 1000; ++i)
+            Surge::Formula::valueAt(i, 0.5f, storage, &fs, &es, r);
+
+        auto st = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < evaluations; ++i)
+            Surge::Formula::valueAt(i, (i & 255) / 256.f, storage, &fs, &es, r);
+        auto et = std::chrono::high_resolution_clock::now();
+
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(et - st).count();
+        std::cout << (es.boundFields ? "struct" : "pushed") << " : " << 1.0 * ns / evaluations
+                  << " ns per evaluation" << std::endl;
+
+        Surge::Formula::cleanEvaluatorState(es);
+    }
+}
+
 } // namespace NonTest
 } // namespace Headless
 } // namespace Surge
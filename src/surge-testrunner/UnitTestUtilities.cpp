@@ -304,15 +304,32 @@ void makePlotPNGFromData(std::string pngFileName, std::string plotTitle, float *
 #endif
 }
 void setFX(std::shared_ptr<SurgeSynthesizer> surge, int slot, fx_type type)
+{
+    queueFX(surge, slot, type);
+
+    for (int i = 0; i < 10; ++i)
+        surge->process();
+}
+
+void queueFX(std::shared_ptr<SurgeSynthesizer> surge, int slot, fx_type type)
 {
     auto *pt = &(surge->storage.getPatch().fx[slot].type);
     auto awv = 1.f * float(type) / (pt->val_max.i - pt->val_min.i);
 
     auto did = surge->idForParameter(pt);
     surge->setParameter01(did, awv, false);
+}
 
-    for (int i = 0; i < 10; ++i)
+bool processWithFxWorkerUntil(std::shared_ptr<SurgeSynthesizer> surge,
+                              const std::function<bool()> &done, int maxBlocks)
+{
+    for (int i = 0; i < maxBlocks && !done(); ++i)
+    {
         surge->process();
+        surge->waitForBackgroundFxWork();
+    }
+
+    return done();
 }
 } // namespace Test
 } // namespace Surge
@@ -26,6 +26,7 @@
 // the includer so we can set CATCH_CONFIG_RUNNER properly
 
 #include "SurgeSynthesizer.h"
+#include <functional>
 using namespace Catch;
 
 namespace Surge
@@ -61,6 +62,15 @@ void makePlotPNGFromData(std::string pngFileName, std::string plotTitle, float *
                          int nC, int startSample = -1, int endSample = -1);
 
 void setFX(std::shared_ptr<SurgeSynthesizer> surge, int slot, fx_type type);
+// change an FX slot's type the way the UI does, without rendering anything
+void queueFX(std::shared_ptr<SurgeSynthesizer> surge, int slot, fx_type type);
+
+/*
+ * Render a block at a time until done() or maxBlocks, letting the background FX worker catch
+ * up after every block, so a background swap lands on the same block every run.
+ */
+bool processWithFxWorkerUntil(std::shared_ptr<SurgeSynthesizer> surge,
+                              const std::function<bool()> &done, int maxBlocks = 1000);
 
 std::shared_ptr<SurgeSynthesizer> surgeOnPatch(const std::string &patchName);
 std::shared_ptr<SurgeSynthesizer> surgeOnTemplate(const std::string &, float sr = 44100);
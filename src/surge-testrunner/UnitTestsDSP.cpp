@@ -21,6 +21,8 @@
  */
 #include <iostream>
 #include <algorithm>
+#include <chrono>
+#include <thread>
 
 #include "HeadlessUtils.h"
 #include "Player.h"
@@ -30,6 +32,10 @@
 #include "UnitTestUtilities.h"
 
 #include "SSEComplex.h"
+#include "ClassicOscillator.h"
+#include "StringOscillator.h"
+#include "WindowOscillator.h"
+#include "SurgeMemoryPools.h"
 #include <complex>
 #include "sst/basic-blocks/mechanics/simd-ops.h"
 
@@ -393,6 +399,329 @@ TEST_CASE("Every Oscillator Plays", "[dsp]")
     }
 }
 
+TEST_CASE("String Delay Lines Fit The Note", "[dsp]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    surge->storage.getPatch().scene[0].osc[0].queue_type = ot_string;
+    for (int q = 0; q < 10; ++q)
+        surge->process();
+
+    auto tierOf = [&surge]() {
+        REQUIRE(surge->voices[0].size() == 1);
+        auto so = dynamic_cast<StringOscillator *>(surge->voices[0].front()->osc[0]);
+        REQUIRE(so);
+        return so->delayTier;
+    };
+
+    auto playFor = [&surge](int blocks) {
+        float sumAbsOut = 0;
+        for (int q = 0; q < blocks; ++q)
+        {
+            surge->process();
+            for (int s = 0; s < BLOCK_SIZE; ++s)
+                sumAbsOut += fabs(surge->output[0][s]);
+        }
+        return sumAbsOut;
+    };
+
+    SECTION("High Notes Take Small Lines, Low Notes Big Ones")
+    {
+        for (auto [note, tier] : {std::pair{96, 0}, {43, 0}, {36, 1}, {24, 2}})
+        {
+            INFO("Playing " << note);
+            surge->playNote(0, note, 127, 0);
+            REQUIRE(playFor(20) > 0.1);
+            REQUIRE(tierOf() == tier);
+            surge->allSoundOff();
+            playFor(20);
+        }
+    }
+
+    SECTION("Bending Down Moves To A Bigger Line")
+    {
+        surge->storage.getPatch().scene[0].pbrange_dn.val.i = 12;
+        surge->playNote(0, 43, 127, 0);
+        playFor(20);
+        REQUIRE(tierOf() == 0);
+
+        surge->pitchBend(0, -8192);
+        REQUIRE(playFor(50) > 0.1);
+        REQUIRE(tierOf() == 1);
+    }
+}
+
+TEST_CASE("String Drops Past Its Line Move Before They Play", "[dsp]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    auto storage = &surge->storage;
+    auto oscstorage = &(storage->getPatch().scene[0].osc[0]);
+
+    unsigned char bufA alignas(16)[oscillator_buffer_size];
+    unsigned char bufB alignas(16)[oscillator_buffer_size];
+
+    // a display oscillator owns a pair of the biggest lines, so it is how the string would sound
+    // had it never been in a small one
+    StringOscillator *o[2];
+    int i = 0;
+    for (auto *buf : {bufA, bufB})
+    {
+        auto q = spawn_osc(ot_string, storage, oscstorage, storage->getPatch().scenedata[0],
+                           storage->getPatch().scenedataOrig[0], buf);
+        q->init_ctrltypes();
+        q->init_default_values();
+        oscstorage->retrigger.val.b = true;
+        oscstorage->p[StringOscillator::str_exciter_mode].val.i = StringOscillator::burst_sine;
+        q->init(60, i == 1, false);
+        o[i++] = static_cast<StringOscillator *>(q);
+    }
+
+    REQUIRE(o[0]->delayTier == 0);
+    REQUIRE(o[1]->delayTier == StringOscillator::nDelayTiers - 1);
+
+    for (int j = 0; j < 100; ++j)
+    {
+        for (auto *q : o)
+            q->process_block(60, 0, false, false, 0);
+
+        for (int s = 0; s < BLOCK_SIZE_OS; ++s)
+            REQUIRE(o[0]->output[s] == Approx(o[1]->output[s]).margin(1e-6));
+    }
+
+    // three octaves down in one block, which is further back than the small line reaches
+    double ab = 0, aa = 0, bb = 0;
+    for (int j = 0; j < 50; ++j)
+    {
+        for (auto *q : o)
+            q->process_block(24, 0, false, false, 0);
+
+        REQUIRE(o[0]->delayTier == StringOscillator::nDelayTiers - 1);
+
+        for (int s = 0; s < BLOCK_SIZE_OS; ++s)
+        {
+            ab += o[0]->output[s] * o[1]->output[s];
+            aa += o[0]->output[s] * o[0]->output[s];
+            bb += o[1]->output[s] * o[1]->output[s];
+        }
+    }
+
+    REQUIRE(bb > 1e-3);
+    REQUIRE(ab / sqrt(aa * bb) > 0.95);
+    REQUIRE(sqrt(aa / bb) == Approx(1).margin(0.2));
+
+    for (auto *q : o)
+        q->~StringOscillator();
+}
+
+TEST_CASE("Twist Engines Come From The Pool", "[dsp]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    auto &pool = surge->storage.memoryPools->twistEngines;
+
+    surge->storage.getPatch().scene[0].osc[0].queue_type = ot_twist;
+    for (int q = 0; q < 10; ++q)
+        surge->process();
+
+    // the engines are built by the refiller, not on the patch change
+    surge->storage.memoryPools->waitForRefills();
+    pool.collectRefills();
+    auto ready = pool.position;
+    REQUIRE(ready >= surge->storage.getPatch().polylimit.val.i);
+
+    // a fast run of notes holds several engines at once, but never needs a new one
+    float sumAbsOut = 0;
+    for (int n = 0; n < 48; ++n)
+    {
+        surge->playNote(0, 48 + n % 24, 127, 0);
+        for (int q = 0; q < 4; ++q)
+        {
+            surge->process();
+            for (int s = 0; s < BLOCK_SIZE; ++s)
+                sumAbsOut += fabs(surge->output[0][s]);
+        }
+        surge->releaseNote(0, 48 + n % 24, 0);
+    }
+
+    REQUIRE(sumAbsOut > 1);
+    REQUIRE(pool.misses.load() == 0);
+
+    surge->allSoundOff();
+    for (int q = 0; q < 20; ++q)
+        surge->process();
+
+    pool.collectRefills();
+    // every engine came back, plus any the background refill built along the way
+    REQUIRE(pool.position >= ready);
+}
+
+TEST_CASE("String Pools Are Sized Off The Audio Thread", "[dsp]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    auto &pools = *surge->storage.memoryPools;
+    auto &small = pools.stringDelayLinesSmall;
+
+    surge->storage.getPatch().scene[0].osc[0].queue_type = ot_string;
+    surge->process();
+
+    // picking the string only asked for the lines; the worker builds them
+    pools.waitForRefills();
+    small.collectRefills();
+    REQUIRE(small.position >= surge->storage.getPatch().polylimit.val.i);
+
+    auto built = pools.getPoolStats()[0].built;
+    REQUIRE(built == small.built.load());
+    REQUIRE(built > 0);
+
+    // and going back hands them to the worker to delete
+    surge->storage.getPatch().scene[0].osc[0].queue_type = ot_sine;
+    surge->process();
+    pools.waitForRefills();
+    REQUIRE(small.position == 8);
+}
+
+TEST_CASE("Wavetables Build In The Background", "[dsp]")
+{
+    auto surge = Surge::Headless::createSurge(44100, true);
+    REQUIRE(surge->storage.wt_list.size() > 0);
+    surge->storage.setBuildWavetablesInBackground(true);
+
+    auto &osc = surge->storage.getPatch().scene[0].osc[0];
+    osc.type.val.i = ot_wavetable;
+    for (int q = 0; q < 10; ++q)
+        surge->process();
+
+    int idx = 0, target = -1, byFile = -1;
+    for (auto q : surge->storage.wt_list)
+    {
+        if (q.name == "Sine Power HQ")
+            target = idx;
+        else if (byFile < 0)
+            byFile = idx;
+        idx++;
+    }
+    REQUIRE(target >= 0);
+    REQUIRE(byFile >= 0);
+
+    // the request goes out on the next block, then we keep rendering until the build lands
+    auto renderUntil = [&](auto done) {
+        int blocks = 0;
+        while (!done() && blocks < 20000)
+        {
+            surge->process();
+            if (blocks++ % 16 == 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        REQUIRE(done());
+    };
+
+    auto path = path_to_string(surge->storage.wt_list[byFile].path);
+    osc.wt.queue_filename = path;
+    renderUntil([&]() { return osc.wt.current_filename == path; });
+    REQUIRE(osc.wt.current_id == byFile);
+
+    // loading by id leaves no current filename behind, as the synchronous load does
+    osc.wt.queue_id = target;
+    renderUntil([&]() { return osc.wt.current_id == target; });
+
+    REQUIRE(osc.wt.queue_id == -1);
+    REQUIRE(osc.wt.current_filename.empty());
+    REQUIRE(osc.wt.everBuilt);
+    REQUIRE(osc.wavetable_display_name == "Sine Power HQ");
+
+    float sumAbsOut = 0;
+    surge->playNote(0, 60, 127, 0);
+    for (int q = 0; q < 100; ++q)
+    {
+        surge->process();
+        for (int s = 0; s < BLOCK_SIZE; ++s)
+            sumAbsOut += fabs(surge->output[0][s]);
+    }
+    REQUIRE(sumAbsOut > 1);
+}
+
+TEST_CASE("Wavetable Mip Maps Match The Scalar Filter", "[dsp]")
+{
+    // the half band decimation as it was written before it was vectorized
+    auto checkLevels = [](Wavetable &wt) {
+        int levels = 1;
+        while (((1 << levels) < wt.size) & (levels < max_mipmap_levels))
+            levels++;
+        int ns = wt.n_tables;
+
+        for (int l = 1; l < levels; l++)
+        {
+            int psize = wt.size >> (l - 1);
+            int lsize = wt.size >> l;
+
+            for (int s = 0; s < ns; s++)
+            {
+                for (int i = 0; i < lsize; i++)
+                {
+                    float f = 0;
+                    int ival = 0;
+
+                    for (int a = 0; a < 63; a++)
+                    {
+                        int srcindex = (i << 1) + a - 31;
+                        int wrapped = srcindex & (psize - 1);
+
+                        if (wt.flags & wtf_is_sample)
+                        {
+                            int srctable = std::max(0, s + (srcindex / psize));
+                            if (srctable < ns)
+                                f += hrfilter[a] *
+                                     wt.TableF32WeakPointers[l - 1][srctable][wrapped];
+                        }
+                        else
+                        {
+                            f += hrfilter[a] * wt.TableF32WeakPointers[l - 1][s][wrapped];
+                            ival += HRFilterI16[a] *
+                                    wt.TableI16WeakPointers[l - 1][s][wrapped + FIRoffsetI16];
+                        }
+                    }
+
+                    INFO("level " << l << " table " << s << " sample " << i);
+                    REQUIRE(wt.TableF32WeakPointers[l][s][i] == Approx(f).margin(1e-6));
+                    if (wt.flags & wtf_is_sample)
+                        REQUIRE(wt.TableI16WeakPointers[l][s][i + FIRoffsetI16] == 0);
+                    else
+                        REQUIRE(wt.TableI16WeakPointers[l][s][i + FIRoffsetI16] ==
+                                (short)(ival >> 16));
+                }
+            }
+        }
+    };
+
+    for (auto parallel : {false, true})
+    {
+        for (auto flags : {0, (int)wtf_is_sample})
+        {
+            auto shapes =
+                std::vector<std::pair<int, int>>{{2048, 16}, {256, 100}, {16, 3}, {4, 1}};
+
+            for (auto [size, nt] : shapes)
+            {
+                INFO("parallel " << parallel << " flags " << flags << " size " << size
+                                 << " tables " << nt);
+
+                std::vector<float> data(size * nt);
+                for (int i = 0; i < size * nt; ++i)
+                    data[i] = 0.8f * sin(i * 0.0371f) + 0.15f * sin(i * 0.917f);
+
+                wt_header wh;
+                memset(&wh, 0, sizeof(wh));
+                wh.n_samples = size;
+                wh.n_tables = nt;
+                wh.flags = flags;
+
+                auto wt = std::make_unique<Wavetable>();
+                wt->parallelMipMaps = parallel;
+                REQUIRE(wt->BuildWT(data.data(), wh, flags & wtf_is_sample));
+                checkLevels(*wt);
+            }
+        }
+    }
+}
+
 TEST_CASE("Untuned is 2^x", "[dsp]")
 {
     auto surge = Surge::Headless::createSurge(44100);
@@ -747,3 +1076,171 @@ TEST_CASE("Oscillator Onset", "[dsp]") // See issue 7570
         }
     }
 }
+
+TEST_CASE("Window Unison Voices Run In Groups", "[dsp]")
+{
+    // counts which fill the groups of four exactly and ones which leave lanes over
+    for (auto uni : {1, 3, 4, 5, 8, 13, 16})
+    {
+        INFO("Unison " << uni);
+        auto surge = Surge::Headless::createSurge(44100, true);
+        auto &osc = surge->storage.getPatch().scene[0].osc[0];
+
+        osc.queue_type = ot_window;
+        for (int q = 0; q < 10; ++q)
+            surge->process();
+
+        osc.p[WindowOscillator::win_unison_voices].val.i = uni;
+        surge->playNote(0, 60, 127, 0);
+
+        float sumAbsL = 0, sumAbsR = 0;
+        for (int q = 0; q < 50; ++q)
+        {
+            surge->process();
+            for (int s = 0; s < BLOCK_SIZE; ++s)
+            {
+                REQUIRE(std::isfinite(surge->output[0][s]));
+                REQUIRE(std::isfinite(surge->output[1][s]));
+                sumAbsL += fabs(surge->output[0][s]);
+                sumAbsR += fabs(surge->output[1][s]);
+            }
+        }
+
+        REQUIRE(sumAbsL > 1);
+        REQUIRE(sumAbsR > 1);
+    }
+}
+
+TEST_CASE("Window Unison Lanes Match One Voice At A Time", "[dsp]")
+{
+    for (auto FM : {false, true})
+    {
+        for (auto stereo : {false, true})
+        {
+            for (auto uni : {1, 2, 3, 4, 5, 8, 13, 15})
+            {
+                DYNAMIC_SECTION("Unison " << uni << " stereo " << stereo << " FM " << FM)
+                {
+                    auto surge = Surge::Headless::createSurge(44100, true);
+                    auto storage = &surge->storage;
+                    auto oscstorage = &(storage->getPatch().scene[0].osc[0]);
+                    std::string metadata;
+
+                    storage->load_wt_wav_portable("resources/test-data/wav/05_BELL.WAV",
+                                                  &oscstorage->wt, metadata);
+                    REQUIRE(oscstorage->wt.n_tables > 1);
+
+                    unsigned char bufA alignas(16)[oscillator_buffer_size];
+                    unsigned char bufB alignas(16)[oscillator_buffer_size];
+
+                    WindowOscillator *o[2];
+                    int i = 0;
+                    for (auto *buf : {bufA, bufB})
+                    {
+                        auto q = spawn_osc(ot_window, storage, oscstorage,
+                                           storage->getPatch().scenedata[0],
+                                           storage->getPatch().scenedataOrig[0], buf);
+                        q->init_ctrltypes();
+                        q->init_default_values();
+                        oscstorage->retrigger.val.b = true;
+                        oscstorage->p[WindowOscillator::win_unison_voices].val.i = uni;
+                        // between two tables, so the morph blend is in play too
+                        auto &morph = oscstorage->p[WindowOscillator::win_morph];
+                        morph.extend_range = true;
+                        storage->getPatch().scenedata[0][morph.param_id_in_scene].f = 0.37f;
+                        q->init(60, false, false);
+                        o[i++] = static_cast<WindowOscillator *>(q);
+                    }
+
+                    REQUIRE(o[0]->useUnisonLanes);
+                    o[1]->useUnisonLanes = false;
+
+                    float fmBuffer alignas(16)[BLOCK_SIZE_OS];
+                    for (auto *q : o)
+                        q->assign_fm(fmBuffer);
+
+                    for (int j = 0; j < 100; ++j)
+                    {
+                        for (int s = 0; s < BLOCK_SIZE_OS; ++s)
+                            fmBuffer[s] = std::sin(2.0 * M_PI * (j * BLOCK_SIZE_OS + s) / 150.0);
+
+                        for (auto *q : o)
+                            q->process_block(60, 0, stereo, FM, FM ? 0.5f : 0.f);
+
+                        for (int s = 0; s < BLOCK_SIZE_OS; ++s)
+                        {
+                            REQUIRE(o[0]->output[s] == o[1]->output[s]);
+                            if (stereo)
+                                REQUIRE(o[0]->outputR[s] == o[1]->outputR[s]);
+                        }
+                    }
+
+                    for (auto *q : o)
+                        q->~WindowOscillator();
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Classic Wide Convolution Matches SSE", "[dsp]")
+{
+    // off unless asked for, so machines with and without AVX render alike
+    REQUIRE(!Surge::Headless::createSurge(44100)->storage.useWideBlitConvolution);
+
+    if (!ClassicOscillator::wideConvolutionAvailable())
+        return;
+
+    for (auto stereo : {false, true})
+    {
+        for (auto uni : {1, 7, 16})
+        {
+            DYNAMIC_SECTION("Unison " << uni << " stereo " << stereo)
+            {
+                auto surge = Surge::Headless::createSurge(44100);
+                auto storage = &surge->storage;
+                auto oscstorage = &(storage->getPatch().scene[0].osc[0]);
+
+                unsigned char bufA alignas(16)[oscillator_buffer_size];
+                unsigned char bufB alignas(16)[oscillator_buffer_size];
+
+                ClassicOscillator *o[2];
+                int i = 0;
+                for (auto *buf : {bufA, bufB})
+                {
+                    // the wide kernel is only used when the storage asks for it
+                    storage->useWideBlitConvolution = (buf == bufA);
+
+                    auto q = spawn_osc(ot_classic, storage, oscstorage,
+                                       storage->getPatch().scenedata[0],
+                                       storage->getPatch().scenedataOrig[0], buf);
+                    q->init_ctrltypes();
+                    q->init_default_values();
+                    oscstorage->retrigger.val.b = true;
+                    oscstorage->p[ClassicOscillator::co_unison_voices].val.i = uni;
+                    q->init(60, false, false);
+                    o[i++] = static_cast<ClassicOscillator *>(q);
+                }
+
+                REQUIRE(o[0]->useWideConvolution);
+                REQUIRE(!o[1]->useWideConvolution);
+
+                for (int j = 0; j < 100; ++j)
+                {
+                    for (auto *q : o)
+                        q->process_block(72, 0, stereo, false, 0);
+
+                    for (int s = 0; s < BLOCK_SIZE_OS; ++s)
+                    {
+                        REQUIRE(o[0]->output[s] == Approx(o[1]->output[s]).margin(1e-4));
+                        if (stereo)
+                            REQUIRE(o[0]->outputR[s] == Approx(o[1]->outputR[s]).margin(1e-4));
+                    }
+                }
+
+                for (auto *q : o)
+                    q->~ClassicOscillator();
+            }
+        }
+    }
+}
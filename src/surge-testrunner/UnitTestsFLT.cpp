@@ -31,6 +31,8 @@
 
 #include "UnitTestUtilities.h"
 
+#include "sst/plugininfra/cpufeatures.h"
+
 using namespace Surge::Test;
 
 // These first two are mostly useful targets for valgrind runs
@@ -100,3 +102,69 @@ TEST_CASE("Run Every Waveshaper", "[flt]")
         }
     }
 }
+
+TEST_CASE("Wide Filter Chain Matches Quad Filter Chain", "[flt]")
+{
+    // it isn't bit exact, so a host has to ask for it
+    REQUIRE(!surgeOnSaw()->useWideFilterChain);
+
+    if (!sst::plugininfra::cpufeatures::hasAVX())
+        SKIP("No AVX on this CPU");
+
+    for (int fc = 0; fc < n_filter_configs; ++fc)
+    {
+        DYNAMIC_SECTION("Filter Configuration " << fbc_names[fc])
+        {
+            auto make = [fc](bool wide) {
+                auto s = surgeOnSaw();
+                auto &sc = s->storage.getPatch().scene[0];
+                sc.osc[0].retrigger.val.b = true;
+                sc.filterblock_configuration.val.i = fc;
+                sc.filterunit[0].type.val.i = sst::filters::fut_lp24;
+                sc.filterunit[1].type.val.i = sst::filters::fut_hp12;
+                sc.filterunit[0].resonance.set_value_f01(0.6);
+                sc.wsunit.type.val.i = (int)sst::waveshapers::WaveshaperType::wst_soft;
+                sc.wsunit.drive.set_value_f01(0.7);
+                sc.feedback.set_value_f01(0.8);
+                s->useWideFilterChain = wide;
+                return s;
+            };
+
+            auto quad = make(false);
+            auto wide = make(true);
+
+            for (auto s : {quad, wide})
+            {
+                for (int i = 0; i < 10; ++i)
+                    s->process();
+                // two full quads, then two more voices in a third
+                for (int n = 0; n < 10; ++n)
+                    s->playNote(0, 48 + n * 3, 100, 0);
+            }
+
+            for (int block = 0; block < 300; ++block)
+            {
+                if (block == 150)
+                {
+                    // leaving five, so the second quad of the pair is only partly active
+                    for (int n = 0; n < 5; ++n)
+                    {
+                        quad->releaseNote(0, 48 + n * 3, 0);
+                        wide->releaseNote(0, 48 + n * 3, 0);
+                    }
+                }
+
+                quad->process();
+                wide->process();
+
+                for (int c = 0; c < 2; ++c)
+                {
+                    for (int i = 0; i < BLOCK_SIZE; ++i)
+                    {
+                        REQUIRE(wide->output[c][i] == Approx(quad->output[c][i]).margin(1e-6));
+                    }
+                }
+            }
+        }
+    }
+}
@@ -23,6 +23,8 @@
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
+#include <cmath>
+#include <typeinfo>
 
 #include "HeadlessUtils.h"
 #include "Player.h"
@@ -1081,3 +1083,133 @@ TEST_CASE("Audio Input Effect", "[fx]")
         }
     }
 }
+
+TEST_CASE("FX Swap On The Background Thread", "[fx]")
+{
+    auto ref = Surge::Headless::createSurge(44100);
+    auto surge = Surge::Headless::createSurge(44100);
+    surge->audio_processing_active = true;
+    surge->setSpawnEffectsInBackground(true);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        ref->process();
+        surge->process();
+    }
+
+    surge->playNote(0, 60, 100, 0, -1);
+
+    for (auto type : {fxt_delay, fxt_reverb2, fxt_nimbus, fxt_off})
+    {
+        INFO("Swapping to " << fx_type_names[type]);
+
+        setFX(ref, fxslot_ains1, type);
+
+        /*
+         * Follow the swap block by block. The old instance keeps running while it fades out,
+         * is only replaced once it is fully bypassed, and then the new one fades in.
+         */
+        auto *before = surge->fx[fxslot_ains1].get();
+        auto lastGain = surge->fxSwapWetGain(fxslot_ains1);
+        bool bypassed{false}, swapped{false};
+
+        queueFX(surge, fxslot_ains1, type);
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            surge->process();
+            surge->waitForBackgroundFxWork();
+
+            auto gain = surge->fxSwapWetGain(fxslot_ains1);
+
+            if (!swapped && surge->fx[fxslot_ains1].get() != before)
+            {
+                REQUIRE((bypassed || !before));
+                swapped = true;
+            }
+            else if (!swapped)
+            {
+                REQUIRE(gain <= lastGain);
+                bypassed = bypassed || gain == 0.f;
+            }
+            else
+            {
+                REQUIRE(gain >= lastGain);
+
+                if (gain == 1.f && !surge->load_fx_needed)
+                    break;
+            }
+
+            lastGain = gain;
+        }
+
+        REQUIRE(swapped);
+        REQUIRE(surge->fxSwapWetGain(fxslot_ains1) == 1.f);
+        REQUIRE(surge->storage.getPatch().fx[fxslot_ains1].type.val.i == type);
+        REQUIRE((bool)surge->fx[fxslot_ains1] == (type != fxt_off));
+
+        if (type != fxt_off)
+        {
+            auto &landed = *surge->fx[fxslot_ains1];
+            auto &expected = *ref->fx[fxslot_ains1];
+            REQUIRE(typeid(landed) == typeid(expected));
+        }
+
+        // the effect lands set up just as a synchronous spawn would leave it
+        for (int p = 0; p < n_fx_params; ++p)
+        {
+            auto &bp = surge->storage.getPatch().fx[fxslot_ains1].p[p];
+            auto &rp = ref->storage.getPatch().fx[fxslot_ains1].p[p];
+            REQUIRE(bp.ctrltype == rp.ctrltype);
+            REQUIRE(bp.val.i == rp.val.i);
+        }
+
+        // and the crossfade back in stays well behaved
+        for (int i = 0; i < SurgeSynthesizer::fxSwapFadeBlocks + 1; ++i)
+        {
+            surge->process();
+
+            for (int s = 0; s < BLOCK_SIZE; ++s)
+            {
+                REQUIRE(std::isfinite(surge->output[0][s]));
+            }
+        }
+    }
+}
+
+TEST_CASE("FX Swap Publishes Its Routing Changes Once", "[fx]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    surge->audio_processing_active = true;
+    surge->setSpawnEffectsInBackground(true);
+
+    auto &fxs = surge->storage.getPatch().fx[fxslot_ains1];
+
+    auto swapTo = [&](fx_type type) {
+        queueFX(surge, fxslot_ains1, type);
+        return processWithFxWorkerUntil(
+            surge, [&]() { return fxs.type.val.i == type && !surge->load_fx_needed; });
+    };
+
+    auto routedInSnapshot = [&]() {
+        for (const auto &r : surge->storage.audioModulationRoutings().modulation_global)
+            if (r.destination_id == fxs.p[0].id || r.destination_id == fxs.p[1].id)
+                return true;
+        return false;
+    };
+
+    REQUIRE(swapTo(fxt_delay));
+
+    // two routings onto the delay, which the swap has to clear
+    surge->setModDepth01(fxs.p[0].id, ms_ctrl1, 0, 0, 0.5f);
+    surge->setModDepth01(fxs.p[1].id, ms_ctrl2, 0, 0, 0.5f);
+    surge->process();
+    REQUIRE(routedInSnapshot());
+
+    REQUIRE(swapTo(fxt_reverb2));
+
+    // the patch copy is cleared on the audio thread, and the worker publishes it after that
+    REQUIRE(surge->getModDepth01(fxs.p[0].id, ms_ctrl1, 0, 0) == 0.f);
+    REQUIRE(surge->getModDepth01(fxs.p[1].id, ms_ctrl2, 0, 0) == 0.f);
+    REQUIRE(processWithFxWorkerUntil(surge, [&]() { return !routedInSnapshot(); }));
+}
@@ -25,6 +25,8 @@
 #include "HeadlessUtils.h"
 #include "BiquadFilter.h"
 #include "MemoryPool.h"
+#include "ActiveVoiceTable.h"
+#include "SharedStorage.h"
 
 #include "sst/plugininfra/strnatcmp.h"
 
@@ -179,6 +181,365 @@ TEST_CASE("Memory Pool Works", "[infra]")
         REQUIRE(CountAlloc<3>::alloc == 160);
         REQUIRE(CountAlloc<3>::ct == 0);
     }
+
+    SECTION("Background Refill Between Watermarks")
+    {
+        {
+            auto pool = std::make_unique<Surge::Memory::MemoryPool<CountAlloc<4>, 8, 4, 500>>();
+            bool woken{false};
+            pool->enableBackgroundRefill(4, 12, [&woken]() { woken = true; });
+            pool->setNeverAllocate(true);
+
+            std::vector<CountAlloc<4> *> held;
+            for (int i = 0; i < 4; ++i)
+                held.push_back(pool->getItem());
+            REQUIRE(!woken);
+
+            // dropping below the low watermark asks for a refill, and allocates nothing itself
+            held.push_back(pool->getItem());
+            REQUIRE(woken);
+            REQUIRE(CountAlloc<4>::alloc == 8);
+
+            // which the refilling thread does up to the high watermark
+            REQUIRE(pool->refill() == 9);
+            REQUIRE(pool->refill() == 0);
+
+            while (held.size() < 17)
+                held.push_back(pool->getItem());
+
+            // and past that, the pool is empty and won't allocate
+            REQUIRE(pool->getItem() == nullptr);
+            REQUIRE(pool->misses.load() == 1);
+            REQUIRE(CountAlloc<4>::alloc == 17);
+
+            for (auto h : held)
+                pool->returnItem(h);
+            REQUIRE(pool->position == 17);
+        }
+        REQUIRE(CountAlloc<4>::ct == 0);
+    }
+
+    SECTION("Reserve And Release Leave The Work To The Refill")
+    {
+        {
+            auto pool = std::make_unique<Surge::Memory::MemoryPool<CountAlloc<5>, 2, 2, 64>>();
+            int wakes{0};
+            pool->enableBackgroundRefill(1, 4, [&wakes]() { wakes++; });
+
+            // reserving builds nothing here, it only asks
+            pool->reserve(20);
+            REQUIRE(wakes == 1);
+            REQUIRE(CountAlloc<5>::alloc == 2);
+            REQUIRE(pool->refill() == 18);
+            pool->collectRefills();
+            REQUIRE(pool->position == 20);
+
+            std::vector<CountAlloc<5> *> held;
+            for (int i = 0; i < 3; ++i)
+                held.push_back(pool->getItem());
+
+            // and releasing deletes nothing here either
+            pool->release();
+            REQUIRE(wakes == 2);
+            REQUIRE(pool->position == 2);
+            REQUIRE(CountAlloc<5>::ct == 20);
+            REQUIRE(pool->refill() == 0);
+            REQUIRE(CountAlloc<5>::ct == 5);
+
+            for (auto h : held)
+                pool->returnItem(h);
+            REQUIRE(pool->position == 5);
+        }
+        REQUIRE(CountAlloc<5>::ct == 0);
+
+        {
+            auto pool = std::make_unique<Surge::Memory::MemoryPool<CountAlloc<6>, 2, 2, 64>>();
+            pool->enableBackgroundRefill(1, 4, []() {});
+
+            std::vector<CountAlloc<6> *> held;
+            held.push_back(pool->getItem());
+            held.push_back(pool->getItem());
+
+            // a reserve while the low watermark's request is out waits for that one
+            pool->reserve(10);
+            REQUIRE(pool->refill() == 4);
+            pool->collectRefills();
+            REQUIRE(pool->position == 4);
+            REQUIRE(pool->refill() == 6);
+            pool->collectRefills();
+            REQUIRE(pool->position == 10);
+
+            for (auto h : held)
+                pool->returnItem(h);
+        }
+        REQUIRE(CountAlloc<6>::ct == 0);
+    }
+}
+
+TEST_CASE("Active Voice Table", "[infra]")
+{
+    SECTION("Voice List Keeps Order")
+    {
+        Surge::VoiceManagement::VoiceList<int, 8> l;
+        int v[5];
+        for (auto &q : v)
+            l.push_back(&q);
+
+        auto it = l.erase(l.begin() + 1);
+        REQUIRE(*it == &v[2]);
+        REQUIRE(l.size() == 4);
+        REQUIRE(l.front() == &v[0]);
+        REQUIRE(l.back() == &v[4]);
+
+        int idx = 0;
+        for (auto q : l)
+        {
+            REQUIRE(q == &v[idx == 0 ? 0 : idx + 1]);
+            idx++;
+        }
+    }
+
+    SECTION("Slots And Note IDs")
+    {
+        auto t = std::make_unique<Surge::VoiceManagement::ActiveVoiceTable<2, 64>>();
+
+        std::vector<int> slots;
+        for (int i = 0; i < 64; ++i)
+        {
+            auto s = t->allocate(0);
+            REQUIRE(s == i);
+            slots.push_back(s);
+        }
+        REQUIRE(t->allocate(0) == -1);
+        REQUIRE(t->allocate(1) == 0);
+
+        t->activate(0, 3, 1234);
+        t->activate(0, 4, 1234);
+        t->activate(1, 0, 1234);
+        t->activate(0, 5, 77);
+
+        REQUIRE(t->count(1234) == 3);
+        REQUIRE(t->countOutsideScene(1234, 0) == 1);
+
+        REQUIRE(!t->release(0, 3));
+        REQUIRE(!t->release(1, 0));
+        REQUIRE(t->release(0, 4));
+        REQUIRE(t->count(1234) == 0);
+
+        t->reassignNoteId(0, 5, 88);
+        REQUIRE(t->count(77) == 0);
+        REQUIRE(t->release(0, 5));
+
+        // a freed slot comes straight back
+        REQUIRE(t->allocate(0) == 5);
+    }
+}
+
+TEST_CASE("Scene And Global Data Copy From Parameters", "[infra]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    auto &patch = surge->storage.getPatch();
+
+    // give every parameter a distinct bit pattern so any misplaced read shows
+    for (int i = 0; i < (int)patch.param_ptr.size(); ++i)
+        patch.param_ptr[i]->val.i = 0x1000 + i;
+
+    for (int sc = 0; sc < n_scenes; ++sc)
+    {
+        for (int i = 0; i < n_scene_params; ++i)
+            patch.scenedataOrig[sc][i].i = -1;
+
+        patch.copy_scenedata(patch.scenedata[sc], patch.scenedataOrig[sc], sc);
+
+        for (int i = 0; i < n_scene_params; ++i)
+        {
+            auto *p = patch.param_ptr[patch.scene_start[sc] + i];
+            INFO("Scene " << sc << " param " << i);
+            REQUIRE(patch.scenedata[sc][i].i == p->val.i);
+            REQUIRE(patch.scenedataOrig[sc][i].i == (p->ctrlgroup == cg_OSC ? p->val.i : -1));
+        }
+    }
+
+    patch.copy_globaldata(patch.globaldata);
+
+    for (int i = 0; i < n_global_params; ++i)
+    {
+        REQUIRE(patch.globaldata[i].i == patch.param_ptr[i]->val.i);
+    }
+}
+
+TEST_CASE("Stage Profiler Histograms", "[infra]")
+{
+    using namespace Surge::Profiling;
+
+    SECTION("Buckets Are Log2 Nanoseconds")
+    {
+        REQUIRE(StageProfiler::bucketFor(0) == 0);
+        REQUIRE(StageProfiler::bucketFor(1) == 0);
+        REQUIRE(StageProfiler::bucketFor(2) == 1);
+        REQUIRE(StageProfiler::bucketFor(3) == 1);
+        REQUIRE(StageProfiler::bucketFor(1024) == 10);
+        REQUIRE(StageProfiler::bucketFor(2047) == 10);
+        REQUIRE(StageProfiler::bucketFor(~uint64_t(0)) == StageStats::n_buckets - 1);
+    }
+
+    SECTION("Record, Snapshot And Reset")
+    {
+        auto prof = std::make_unique<StageProfiler>();
+
+        for (int i = 0; i < 99; ++i)
+            prof->record(ps_output, 1000);
+        prof->record(ps_output, 100000);
+
+        auto ss = prof->snapshot(ps_output);
+        REQUIRE(ss.count == 100);
+        REQUIRE(ss.totalNs == 99 * 1000 + 100000);
+        REQUIRE(ss.maxNs == 100000);
+        REQUIRE(ss.buckets[9] == 99);
+        REQUIRE(ss.buckets[16] == 1);
+        REQUIRE(ss.percentileNs(0.5) == 1024);
+        REQUIRE(ss.percentileNs(1.0) == 131072);
+
+        REQUIRE(prof->snapshot(ps_block).count == 0);
+
+        prof->reset();
+        REQUIRE(prof->snapshot(ps_output).count == 0);
+        REQUIRE(prof->snapshot(ps_output).maxNs == 0);
+    }
+
+#if SURGE_STAGE_PROFILER
+    SECTION("Engine Stages Are Timed")
+    {
+        auto surge = Surge::Headless::createSurge(44100);
+
+        surge->playNote(0, 60, 100, 0);
+        for (int i = 0; i < 20; ++i)
+            surge->process();
+
+        auto &prof = surge->stageProfiler;
+        auto rendered = prof.snapshot(ps_process_control).count;
+
+        REQUIRE(prof.snapshot(ps_block).count == 20);
+        REQUIRE(rendered <= 20);
+        REQUIRE(rendered > 0);
+        REQUIRE(prof.snapshot(ps_scene_voices_a).count == rendered);
+        REQUIRE(prof.snapshot(ps_scene_postfilter_b).count == rendered);
+        REQUIRE(prof.snapshot(ps_output).count == rendered);
+    }
+#endif
+
+    REQUIRE(std::string(stageName(fxStage(fxslot_send1))) == "fx/send/1");
+    REQUIRE(std::string(stageName(sceneStage(ps_scene_voices_a, 1))) == "scene/b/voices");
+}
+
+TEST_CASE("Shared Storage Between Instances", "[infra]")
+{
+    auto a = Surge::Headless::createSurge(48000);
+    auto b = Surge::Headless::createSurge(48000);
+    auto c = Surge::Headless::createSurge(44100);
+
+    SECTION("Tables Are Shared Per Process And Per Rate")
+    {
+        REQUIRE(a->storage.sharedTables == b->storage.sharedTables);
+        REQUIRE(a->storage.sharedTables == c->storage.sharedTables);
+        REQUIRE(a->storage.sinctable == c->storage.sinctable);
+
+        REQUIRE(a->storage.sampleRateTables == b->storage.sampleRateTables);
+        REQUIRE(a->storage.sampleRateTables != c->storage.sampleRateTables);
+
+        b->setSamplerate(44100);
+        REQUIRE(b->storage.sampleRateTables == c->storage.sampleRateTables);
+        REQUIRE(b->storage.envelope_rate_linear(0.3) == c->storage.envelope_rate_linear(0.3));
+    }
+
+    SECTION("Tuning Stays Per Instance")
+    {
+        auto pitch = b->storage.note_to_pitch(7.3);
+
+        a->storage.retuneToScale(Tunings::readSCLFile("resources/test-data/scl/zeus22.scl"));
+        REQUIRE(a->storage.note_to_pitch(7.3) != Approx(pitch));
+        REQUIRE(b->storage.note_to_pitch(7.3) == pitch);
+        REQUIRE(a->storage.note_to_pitch_ignoring_tuning(7.3) ==
+                b->storage.note_to_pitch_ignoring_tuning(7.3));
+
+        a->storage.retuneTo12TETScaleC261Mapping();
+        REQUIRE(a->storage.note_to_pitch(7.3) == pitch);
+    }
+
+    SECTION("Later Instances Copy The Scans")
+    {
+        REQUIRE(a->storage.sharedContent == b->storage.sharedContent);
+        REQUIRE(a->storage.patch_list.size() == b->storage.patch_list.size());
+        REQUIRE(a->storage.wt_list.size() == c->storage.wt_list.size());
+        REQUIRE(a->storage.patchOrdering == b->storage.patchOrdering);
+
+        for (int i = 0; i < a->storage.wt_list.size(); ++i)
+        {
+            INFO("Wavetable " << i);
+            REQUIRE(a->storage.wt_list[i].path == c->storage.wt_list[i].path);
+            REQUIRE(a->storage.wt_list[i].order == c->storage.wt_list[i].order);
+        }
+    }
+
+    SECTION("Scans Whose Folders Changed Are Not Adopted")
+    {
+        auto shared = a->storage.sharedContent;
+        auto patches = shared->getPatches();
+        REQUIRE(patches);
+        REQUIRE(!patches->folders.folders.empty());
+        REQUIRE(patches->folders.unchanged());
+        REQUIRE(b->storage.adoptSharedPatchlist());
+
+        // as though a folder had been touched since a scanned it
+        auto stale = std::make_shared<Surge::Storage::PatchIndex>(*patches);
+        stale->folders.folders.back().second--;
+        shared->setPatches(stale);
+        REQUIRE(!b->storage.adoptSharedPatchlist());
+
+        auto wavetables = shared->getWavetables();
+        REQUIRE(wavetables);
+        auto staleWT = std::make_shared<Surge::Storage::WavetableIndex>(*wavetables);
+        staleWT->folders.add(a->storage.userDataPath / "No Such Folder", 0);
+        shared->setWavetables(staleWT);
+        REQUIRE(!b->storage.adoptSharedWtlist());
+
+        // rescanning publishes a current snapshot again
+        b->storage.refresh_patchlist();
+        b->storage.refresh_wtlist();
+        REQUIRE(shared->getPatches()->folders.unchanged());
+        REQUIRE(a->storage.adoptSharedPatchlist());
+        REQUIRE(a->storage.adoptSharedWtlist());
+    }
+
+    SECTION("Cached Rescans Match A Full Scan")
+    {
+        REQUIRE(a->storage.scanCache);
+        REQUIRE(a->storage.scanCache == b->storage.scanCache);
+
+        auto cache = a->storage.scanCache;
+        a->storage.refresh_patchlist();
+        auto cached = a->storage.patch_list;
+
+        a->storage.scanCache = nullptr;
+        a->storage.refresh_patchlist();
+        a->storage.scanCache = cache;
+
+        REQUIRE(!cached.empty());
+        REQUIRE(cached.size() == a->storage.patch_list.size());
+
+        for (int i = 0; i < cached.size(); ++i)
+        {
+            INFO("Patch " << i);
+            REQUIRE(cached[i].path == a->storage.patch_list[i].path);
+            REQUIRE(cached[i].order == a->storage.patch_list[i].order);
+            REQUIRE(cached[i].lastModTime == a->storage.patch_list[i].lastModTime);
+            REQUIRE(cached[i].fileSize == a->storage.patch_list[i].fileSize);
+        }
+
+        auto &p = a->storage.patch_list[0];
+        REQUIRE(p.fileSize == fs::file_size(p.path));
+        REQUIRE(p.lastModTime > 0);
+    }
 }
 
 TEST_CASE("strnatcmp With Spaces", "[infra]")
@@ -609,6 +609,107 @@ end)FN");
     }
 }
 
+TEST_CASE("Formula State Built-ins", "[formula]")
+{
+    SECTION("Assigning A Built-in Lasts One Block")
+    {
+        SurgeStorage storage;
+        FormulaModulatorStorage fs;
+        fs.setFormula(R"FN(
+function process(state)
+    local p = state.phase
+    state.phase = 7
+    if state.phase == 7 and p < 1 then
+        state.output = p
+    else
+        state.output = -1
+    end
+    return state
+end)FN");
+        auto runIt = runFormula(&storage, &fs, 0.0321, 3);
+        REQUIRE(!runIt.empty());
+        for (auto c : runIt)
+        {
+            REQUIRE(c.fPhase == Approx(c.v));
+        }
+    }
+
+    SECTION("A Fresh Table Still Sees The Built-ins")
+    {
+        SurgeStorage storage;
+        FormulaModulatorStorage fs;
+        fs.setFormula(R"FN(
+function process(state)
+    return { output = state.phase, tempo = state.tempo }
+end)FN");
+        auto runIt = runFormula(&storage, &fs, 0.0321, 3);
+        REQUIRE(!runIt.empty());
+        for (auto c : runIt)
+        {
+            REQUIRE(c.fPhase == Approx(c.v));
+        }
+    }
+
+    SECTION("Pairs Lists The Built-ins Either Way")
+    {
+        for (auto bind : {true, false})
+        {
+            INFO("Binding the struct " << bind);
+            SurgeStorage storage;
+            FormulaModulatorStorage fs;
+            fs.setFormula(R"FN(
+function process(state)
+    state.mine = 0.25
+    local seen = {}
+    for k, v in pairs(state) do
+        seen[k] = v
+    end
+    if seen.tempo == state.tempo and seen.mine == 0.25 and seen.key == nil then
+        state.output = seen.phase
+    else
+        state.output = -1
+    end
+    return state
+end)FN");
+            Surge::Formula::EvaluatorState es;
+            es.bindStateFields = bind;
+            Surge::Formula::prepareForEvaluation(&storage, &fs, es, true);
+            REQUIRE((es.boundFields != nullptr) == bind);
+
+            float r[Surge::Formula::max_formula_outputs];
+            for (auto phase : {0.125f, 0.5f})
+            {
+                Surge::Formula::valueAt(0, phase, &storage, &fs, &es, r);
+                REQUIRE(r[0] == Approx(phase));
+            }
+            Surge::Formula::cleanEvaluatorState(es);
+        }
+    }
+
+    SECTION("Built-ins Show In The Debug View")
+    {
+        SurgeStorage storage;
+        FormulaModulatorStorage fs;
+        fs.setFormula(R"FN(
+function process(state)
+    state.output = state.phase
+    state.mine = 0.25
+    return state
+end)FN");
+        Surge::Formula::EvaluatorState es;
+        Surge::Formula::prepareForEvaluation(&storage, &fs, es, true);
+        float r[Surge::Formula::max_formula_outputs];
+        Surge::Formula::valueAt(0, 0.5, &storage, &fs, &es, r);
+        REQUIRE(r[0] == Approx(0.5));
+
+        auto dv = Surge::Formula::createDebugViewOfModState(es);
+        INFO(dv);
+        REQUIRE(dv.find("phase: 0.5") != std::string::npos);
+        REQUIRE(dv.find("mine: 0.25") != std::string::npos);
+        Surge::Formula::cleanEvaluatorState(es);
+    }
+}
+
 TEST_CASE("Clamping", "[formula]")
 {
     SECTION("Test Clamped Function")
@@ -23,6 +23,8 @@
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
+#include <atomic>
+#include <thread>
 
 #include "HeadlessUtils.h"
 #include "Player.h"
@@ -1435,3 +1437,172 @@ TEST_CASE("Mod LFO Is Well Behaved", "[mod]")
         }
     }
 }
+
+TEST_CASE("Modulation Routing Snapshot", "[mod]")
+{
+    auto surge = surgeOnSaw();
+    REQUIRE(surge);
+
+    auto cutoff = surge->storage.getPatch().scene[0].filterunit[0].cutoff.id;
+
+    SECTION("Edits Reach The Audio Thread")
+    {
+        auto n = surge->storage.audioModulationRoutings().modulation_voice[0].size();
+
+        surge->setModDepth01(cutoff, ms_lfo1, 0, 0, 0.5);
+        REQUIRE(surge->storage.getPatch().scene[0].modulation_voice.size() == n + 1);
+
+        surge->process();
+
+        auto &updated = surge->storage.audioModulationRoutings();
+        REQUIRE(updated.modulation_voice[0].size() == n + 1);
+        REQUIRE(updated.modulation_voice[0].back().source_id == ms_lfo1);
+        REQUIRE(!updated.modulation_voice[0].back().muted);
+
+        surge->muteModulation(cutoff, ms_lfo1, 0, 0, true);
+        surge->process();
+        REQUIRE(surge->storage.audioModulationRoutings().modulation_voice[0].back().muted);
+
+        surge->clearModulation(cutoff, ms_lfo1, 0, 0, false);
+        surge->process();
+        REQUIRE(surge->storage.audioModulationRoutings().modulation_voice[0].size() == n);
+    }
+
+    SECTION("Audio Thread Never Waits On An Editor")
+    {
+        std::atomic<bool> locked{false}, done{false};
+
+        std::thread editor([&]() {
+            std::lock_guard<std::recursive_mutex> g(surge->storage.modRoutingMutex);
+            locked = true;
+            while (!done)
+                std::this_thread::yield();
+        });
+
+        while (!locked)
+            std::this_thread::yield();
+
+        surge->playNote(0, 60, 127, 0);
+        for (int i = 0; i < 100; ++i)
+            surge->process();
+        surge->releaseNote(0, 60, 0);
+
+        done = true;
+        editor.join();
+
+        REQUIRE(surge->storage.activeVoiceCount > 0);
+    }
+
+    SECTION("Audio Thread Routing Edits Wait For The Editor")
+    {
+        std::atomic<bool> locked{false}, done{false};
+        std::thread editor;
+
+        auto holdLock = [&]() {
+            locked = false;
+            done = false;
+            editor = std::thread([&]() {
+                std::lock_guard<std::recursive_mutex> g(surge->storage.modRoutingMutex);
+                locked = true;
+                while (!done)
+                    std::this_thread::yield();
+            });
+            while (!locked)
+                std::this_thread::yield();
+        };
+        auto releaseLock = [&]() {
+            done = true;
+            editor.join();
+        };
+
+        // an oscillator type change clears that oscillator's modulation
+        auto &osc = surge->storage.getPatch().scene[0].osc[0];
+        REQUIRE(osc.type.val.i == ot_classic);
+        osc.queue_type = ot_sine;
+
+        holdLock();
+        for (int i = 0; i < 10; ++i)
+            surge->process();
+        REQUIRE(osc.type.val.i == ot_classic);
+        releaseLock();
+
+        surge->process();
+        REQUIRE(osc.type.val.i == ot_sine);
+
+        // and an enqueued patch replaces every routing
+        auto other = surgeOnSaw();
+        other->storage.getPatch().name = "Queued Behind The Editor";
+        void *d = nullptr;
+        auto sz = other->saveRaw(&d);
+        surge->enqueuePatchForLoad(d, sz);
+
+        holdLock();
+        for (int i = 0; i < 10; ++i)
+            surge->process();
+        REQUIRE(surge->storage.getPatch().name != "Queued Behind The Editor");
+        releaseLock();
+
+        surge->process();
+        REQUIRE(surge->storage.getPatch().name == "Queued Behind The Editor");
+        REQUIRE(surge->storage.getPatch().scene[0].osc[0].type.val.i == ot_classic);
+    }
+}
+
+TEST_CASE("Compiled Routing Program Matches Routing List", "[mod]")
+{
+    ControllerModulationSource srcs[n_modsources];
+    for (int i = 0; i < n_modsources; ++i)
+    {
+        srcs[i].init(0.1f * (i % 7) - 0.3f);
+    }
+
+    std::vector<ModulationRouting> routings;
+    auto add = [&](int src, int dst, float depth, bool muted) {
+        ModulationRouting r;
+        r.source_id = src;
+        r.destination_id = dst;
+        r.depth = depth;
+        r.muted = muted;
+        routings.push_back(r);
+    };
+
+    add(ms_lfo1, 3, 0.5f, false);
+    add(ms_lfo1, 4, -0.25f, false);
+    add(ms_modwheel, 3, 0.7f, false);
+    add(ms_velocity, 9, 1.f, true);
+    add(ms_slfo2, 4, 0.3f, false);
+
+    for (bool skipLFOs : {false, true})
+    {
+        DYNAMIC_SECTION("Skip LFOs " << skipLFOs)
+        {
+            Surge::Modulation::RoutingProgram prog;
+            prog.compile(routings, skipLFOs);
+
+            REQUIRE(prog.sources.size() == (skipLFOs ? 2 : 4));
+
+            pdata viaList[16], viaProgram[16];
+            for (int i = 0; i < 16; ++i)
+            {
+                viaList[i].f = 0.01f * i;
+                viaProgram[i].f = 0.01f * i;
+            }
+
+            for (auto &r : routings)
+            {
+                if (skipLFOs && isLFO((modsources)r.source_id))
+                    continue;
+                viaList[r.destination_id].f +=
+                    r.depth * srcs[r.source_id].get_output(0) * (1.0 - r.muted);
+            }
+
+            prog.apply(viaProgram, [&](int, int id) { return &srcs[id]; });
+
+            for (int i = 0; i < 16; ++i)
+            {
+                INFO("Destination " << i);
+                REQUIRE(viaProgram[i].f == Approx(viaList[i].f).margin(1e-7));
+            }
+        }
+    }
+}
@@ -23,8 +23,10 @@
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
+#include <vector>
 
 #include "PatchDB.h"
+#include "sqlite3.h"
 
 #include "catch2/catch_amalgamated.hpp"
 
@@ -156,28 +158,119 @@ TEST_CASE("SQL Generation", "[query]")
     {
         auto t = Surge::PatchStorage::PatchDBQueryParser::parseQuery("init");
         auto s = Surge::PatchStorage::PatchDB::sqlWhereClauseFor(t);
-        REQUIRE(s == "( p.search_over LIKE '%init%' )");
+        REQUIRE(s == "( PatchSearch MATCH '{name search_over} : \"init\" *' )");
     }
 
     SECTION("Duple")
     {
         auto t = Surge::PatchStorage::PatchDBQueryParser::parseQuery("init sine");
         auto s = Surge::PatchStorage::PatchDB::sqlWhereClauseFor(t);
-        REQUIRE(s == "( ( p.search_over LIKE '%init%' ) AND ( p.search_over LIKE '%sine%' ) )");
+        REQUIRE(s == "( PatchSearch MATCH '( {name search_over} : \"init\" * ) AND "
+                     "( {name search_over} : \"sine\" * )' )");
     }
 
     SECTION("Single Quote")
     {
         auto t = Surge::PatchStorage::PatchDBQueryParser::parseQuery("init 'sine");
         auto s = Surge::PatchStorage::PatchDB::sqlWhereClauseFor(t);
-        REQUIRE(s == "( ( p.search_over LIKE '%init%' ) AND ( p.search_over LIKE '%''sine%' ) )");
+        REQUIRE(s == "( PatchSearch MATCH '( {name search_over} : \"init\" * ) AND "
+                     "( {name search_over} : \"''sine\" * )' )");
     }
 
     SECTION("Lots of Single Quotes Quote")
     {
         auto t = Surge::PatchStorage::PatchDBQueryParser::parseQuery("in'it' ''sine");
         auto s = Surge::PatchStorage::PatchDB::sqlWhereClauseFor(t);
-        REQUIRE(s ==
-                "( ( p.search_over LIKE '%in''it''%' ) AND ( p.search_over LIKE '%''''sine%' ) )");
+        REQUIRE(s == "( PatchSearch MATCH '( {name search_over} : \"in''it''\" * ) AND "
+                     "( {name search_over} : \"''''sine\" * )' )");
     }
-}
\ No newline at end of file
+
+    SECTION("Keywords Search Their Own Column")
+    {
+        auto t = Surge::PatchStorage::PatchDBQueryParser::parseQuery("AUTHOR=bacon pad");
+        auto s = Surge::PatchStorage::PatchDB::sqlWhereClauseFor(t);
+        REQUIRE(s == "( PatchSearch MATCH '( author : \"bacon\" * ) AND "
+                     "( {name search_over} : \"pad\" * )' )");
+    }
+
+    SECTION("Terms Without Words Drop Out")
+    {
+        auto t = Surge::PatchStorage::PatchDBQueryParser::parseQuery("init -");
+        auto s = Surge::PatchStorage::PatchDB::sqlWhereClauseFor(t);
+        REQUIRE(s == "( PatchSearch MATCH '( {name search_over} : \"init\" * )' )");
+
+        t = Surge::PatchStorage::PatchDBQueryParser::parseQuery("-");
+        s = Surge::PatchStorage::PatchDB::sqlWhereClauseFor(t);
+        REQUIRE(s == "(1 == 1)");
+    }
+}
+TEST_CASE("Queries Match Against A Search Index", "[query]")
+{
+    // the PatchSearch table as PatchDB sets it up, over a handful of patches
+    sqlite3 *db{nullptr};
+    REQUIRE(sqlite3_open(":memory:", &db) == SQLITE_OK);
+
+    auto setup = R"SQL(
+CREATE VIRTUAL TABLE PatchSearch USING fts5 (
+    name,
+    search_over,
+    author,
+    category,
+    tokenize = 'unicode61 remove_diacritics 2',
+    prefix = '2 3'
+);
+INSERT INTO PatchSearch ( rowid, name, search_over, author, category ) VALUES
+    ( 1, 'Piano Pad', 'Piano Pad Keys Factory', 'Alpha', 'Keys' ),
+    ( 2, 'EPiano Bells', 'EPiano Bells Keys Factory', 'Beta', 'Keys' ),
+    ( 3, 'Init Sine', 'Init Sine Templates', 'Surge Synth Team', 'Templates' ),
+    ( 4, 'Café Lead', 'Café Lead Leads', 'Alpha', 'Leads' ),
+    ( 5, 'Don''t Stop', 'Don''t Stop Sequences', 'Beta', 'Sequences' );
+)SQL";
+    REQUIRE(sqlite3_exec(db, setup, nullptr, nullptr, nullptr) == SQLITE_OK);
+
+    auto matching = [db](const std::string &query) {
+        auto t = Surge::PatchStorage::PatchDBQueryParser::parseQuery(query);
+        auto sql = "SELECT rowid FROM PatchSearch WHERE " +
+                   Surge::PatchStorage::PatchDB::sqlWhereClauseFor(t) + " ORDER BY rowid";
+
+        std::vector<int> res;
+        sqlite3_stmt *q{nullptr};
+        INFO("Running " << sql);
+        REQUIRE(sqlite3_prepare_v2(db, sql.c_str(), -1, &q, nullptr) == SQLITE_OK);
+
+        while (sqlite3_step(q) == SQLITE_ROW)
+            res.push_back(sqlite3_column_int(q, 0));
+
+        sqlite3_finalize(q);
+        return res;
+    };
+
+    SECTION("Terms Match The Start Of A Word")
+    {
+        REQUIRE(matching("pia") == std::vector<int>{1});
+        REQUIRE(matching("PIANO") == std::vector<int>{1});
+        REQUIRE(matching("ano").empty());
+    }
+
+    SECTION("And And Or")
+    {
+        REQUIRE(matching("keys pad") == std::vector<int>{1});
+        REQUIRE(matching("keys OR lead") == std::vector<int>{1, 2, 4});
+        REQUIRE(matching("fact -") == std::vector<int>{1, 2});
+    }
+
+    SECTION("Keywords Only Match Their Column")
+    {
+        REQUIRE(matching("AUTHOR=alp") == std::vector<int>{1, 4});
+        REQUIRE(matching("CATEGORY=lead") == std::vector<int>{4});
+        REQUIRE(matching("AUTHOR=keys").empty());
+    }
+
+    SECTION("Diacritics And Quotes")
+    {
+        REQUIRE(matching("cafe") == std::vector<int>{4});
+        REQUIRE(matching("don't") == std::vector<int>{5});
+    }
+
+    sqlite3_close(db);
+}
@@ -327,3 +327,125 @@ TEST_CASE("Play and release Frequency and Note ID", "[voice]")
         }
     }
 }
+
+TEST_CASE("Parallel Scene Rendering Matches Serial", "[voice]")
+{
+    for (auto noisy : {false, true})
+    {
+        DYNAMIC_SECTION("Noise and random phases " << noisy)
+        {
+            auto makeDual = [noisy]() {
+                auto s = surgeOnSaw();
+                auto &patch = s->storage.getPatch();
+                patch.scenemode.val.i = sm_dual;
+                for (auto sc = 0; sc < n_scenes; ++sc)
+                {
+                    // free running oscillators take a random start phase at note on, and the
+                    // noise source and drift draw random numbers while the scene renders
+                    patch.scene[sc].osc[0].retrigger.val.b = !noisy;
+                    if (noisy)
+                    {
+                        patch.scene[sc].mute_noise.val.b = false;
+                        patch.scene[sc].level_noise.set_value_f01(0.8);
+                        patch.scene[sc].drift.set_value_f01(0.5);
+                    }
+                }
+                // make the scenes different enough that a mixup would show
+                patch.scene[1].osc[0].pitch.set_value_f01(0.7);
+                s->storage.rngGen.g.seed(8675309);
+                return s;
+            };
+
+            auto serial = makeDual();
+            auto parallel = makeDual();
+            parallel->setRenderScenesInParallel(true);
+
+            if (noisy)
+            {
+                /*
+                 * With the mode on the scenes draw from their own random streams, which the
+                 * mode off doesn't use. So compare against a synth with the mode on which
+                 * always falls back to serial: an audio input client couples the scenes.
+                 */
+                serial->setRenderScenesInParallel(true);
+                serial->storage.otherscene_clients++;
+                REQUIRE(!serial->canRenderScenesInParallel());
+                REQUIRE(parallel->canRenderScenesInParallel());
+            }
+
+            for (auto s : {serial, parallel})
+            {
+                for (int i = 0; i < 10; ++i)
+                    s->process();
+                s->playNote(0, 60, 127, 0);
+                s->playNote(0, 64, 127, 0);
+                s->playNote(0, 67, 127, 0);
+            }
+
+            float sumAbs = 0;
+            for (int block = 0; block < 500; ++block)
+            {
+                if (block == 300)
+                {
+                    serial->releaseNote(0, 64, 0);
+                    parallel->releaseNote(0, 64, 0);
+                }
+
+                serial->process();
+                parallel->process();
+
+                for (int c = 0; c < 2; ++c)
+                {
+                    for (int i = 0; i < BLOCK_SIZE; ++i)
+                    {
+                        REQUIRE(serial->output[c][i] == parallel->output[c][i]);
+                        sumAbs += fabs(serial->output[c][i]);
+                    }
+                }
+            }
+            REQUIRE(sumAbs > 1);
+
+            if (noisy)
+                serial->storage.otherscene_clients--;
+        }
+    }
+}
+
+TEST_CASE("Shared Pools Keep The Scenes On One Thread", "[voice]")
+{
+    auto s = surgeOnSaw();
+    auto &patch = s->storage.getPatch();
+    patch.scenemode.val.i = sm_dual;
+    s->setRenderScenesInParallel(true);
+    REQUIRE(s->canRenderScenesInParallel());
+
+    patch.scene[1].osc[2].type.val.i = ot_string;
+    REQUIRE(!s->canRenderScenesInParallel());
+
+    patch.scene[1].osc[2].type.val.i = ot_sine;
+    REQUIRE(s->canRenderScenesInParallel());
+}
+
+TEST_CASE("Serial Scene Rendering Leaves The Random Stream Alone", "[voice]")
+{
+    // with parallel rendering off, a patch which draws no random numbers mustn't advance
+    // rngGen, so everything else which draws from it renders as it did before
+    auto s = surgeOnSaw();
+    auto &patch = s->storage.getPatch();
+    patch.scenemode.val.i = sm_dual;
+    for (auto sc = 0; sc < n_scenes; ++sc)
+        patch.scene[sc].osc[0].retrigger.val.b = true;
+    REQUIRE(!s->getRenderScenesInParallel());
+
+    for (int i = 0; i < 10; ++i)
+        s->process();
+    s->playNote(0, 60, 127, 0);
+
+    s->storage.rngGen.g.seed(8675309);
+    auto before = s->storage.rngGen.g;
+
+    for (int i = 0; i < 100; ++i)
+        s->process();
+
+    REQUIRE(s->storage.rngGen.g == before);
+}
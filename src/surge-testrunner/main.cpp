@@ -59,6 +59,10 @@ int main(int argc, char **argv)
         {
             Surge::Headless::NonTest::generateNLFeedbackNorms();
         }
+        if (strcmp(argv[2], "--formula-timing") == 0)
+        {
+            Surge::Headless::NonTest::formulaTiming();
+        }
         if (strcmp(argv[2], "--filter-analyzer") == 0)
         {
             if (argc < 4)
@@ -87,6 +91,8 @@ int main(int argc, char **argv)
                 << "   --non-test --stats-from-every-patch    # play every patch and show RMS\n"
                 << "   --non-test --filter-analyzer ft fst    # analyze filter type/subtype for "
                    "response\n"
+                << "   --non-test --formula-timing            # time formula evaluation with and "
+                   "without the state struct\n"
                 << "\n"
                 << "If you exclude the `--non-test` argument, standard catch2 arguments, below, "
                    "apply\n\n";
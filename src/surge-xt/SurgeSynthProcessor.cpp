@@ -28,7 +28,9 @@
 #include "globals.h"
 #include "UserDefaults.h"
 #include "UnitConversions.h"
+#include <algorithm>
 #include <any>
+#include <limits>
 
 #if LINUX
 // getCurrentPosition is deprecated in J7
@@ -77,6 +79,9 @@ SurgeSynthProcessor::SurgeSynthProcessor()
         return;
     }
 
+    surge->storage.setBuildWavetablesInBackground(true);
+    surge->setSpawnEffectsInBackground(true);
+
 #if BUILD_IS_DEBUG
     oss << "  - Data         : " << surge->storage.datapath.u8string() << "\n"
         << "  - User Data    : " << surge->storage.userDataPath.u8string() << std::endl;
@@ -595,6 +600,8 @@ void SurgeSynthProcessor::processBlock(juce::AudioBuffer<float> &buffer,
     }
 
     surge->audio_processing_active = true;
+    surge->storage.buildWavetablesInBackground = !isNonRealtime();
+    surge->spawnEffectsInBackground = !isNonRealtime();
 
     processBlockPlayhead();
     processBlockMidiFromGUI();
@@ -605,12 +612,15 @@ void SurgeSynthProcessor::processBlock(juce::AudioBuffer<float> &buffer,
     auto sceneBOutput = getBusBuffer(buffer, false, 2);
 
     auto midiIt = midiMessages.findNextSamplePosition(0);
-    int nextMidi = -1;
 
-    if (midiIt != midiMessages.cend())
-    {
-        nextMidi = (*midiIt).samplePosition;
-    }
+    // applies every event up to and including sample pos, in order
+    auto applyMidiThrough = [&](int pos) {
+        while (midiIt != midiMessages.cend() && (*midiIt).samplePosition <= pos)
+        {
+            applyMidi(*midiIt);
+            midiIt++;
+        }
+    };
 
     const float *incL{nullptr}, *incR{nullptr};
     if (mainInput.getNumChannels() > 0)
@@ -637,51 +647,57 @@ void SurgeSynthProcessor::processBlock(juce::AudioBuffer<float> &buffer,
         inputIsLatent = true;
     }
 
-    for (int i = 0; i < buffer.getNumSamples(); i++)
-    {
-        while (i == nextMidi)
-        {
-            applyMidi(*midiIt);
-            midiIt++;
+    auto copyStereo = [](juce::AudioBuffer<float> &to, int at, const float *l, const float *r,
+                         int n) {
+        if (to.getNumChannels() != 2)
+            return;
 
-            if (midiIt == midiMessages.cend())
-            {
-                nextMidi = -1;
-            }
-            else
-            {
-                nextMidi = (*midiIt).samplePosition;
-            }
+        auto toL = to.getWritePointer(0, at);
+        auto toR = to.getWritePointer(1, at);
+
+        if (toL && toR)
+        {
+            memcpy(toL, l, n * sizeof(float));
+            memcpy(toR, r, n * sizeof(float));
         }
+    };
 
-        auto outL = mainOutput.getWritePointer(0, i);
-        auto outR = mainOutput.getWritePointer(1, i);
+    /*
+     * Work through the buffer a chunk at a time, each chunk running up to the next block
+     * boundary (or the end of the buffer). An event can only change what the engine does at
+     * the next process() call, so each chunk applies everything up to its first sample and
+     * then copies its whole run of output at once.
+     */
+    for (int i = 0; i < sc;)
+    {
+        auto n = std::min(BLOCK_SIZE - blockPos, sc - i);
 
-        if (blockPos == 0 && incL && incR)
-        {
-            surge->process_input = true;
+        applyMidiThrough(i);
 
-            if (inputIsLatent)
+        if (blockPos == 0)
+        {
+            if (incL && incR)
             {
-                memcpy(&(surge->input[0][0]), inputLatentBuffer[0], BLOCK_SIZE * sizeof(float));
-                memcpy(&(surge->input[1][0]), inputLatentBuffer[1], BLOCK_SIZE * sizeof(float));
+                surge->process_input = true;
+
+                if (inputIsLatent)
+                {
+                    memcpy(&(surge->input[0][0]), inputLatentBuffer[0],
+                           BLOCK_SIZE * sizeof(float));
+                    memcpy(&(surge->input[1][0]), inputLatentBuffer[1],
+                           BLOCK_SIZE * sizeof(float));
+                }
+                else
+                {
+                    memcpy(&(surge->input[0][0]), incL + i, BLOCK_SIZE * sizeof(float));
+                    memcpy(&(surge->input[1][0]), incR + i, BLOCK_SIZE * sizeof(float));
+                }
             }
             else
             {
-                auto inL = incL + i;
-                auto inR = incR + i;
-
-                memcpy(&(surge->input[0][0]), inL, BLOCK_SIZE * sizeof(float));
-                memcpy(&(surge->input[1][0]), inR, BLOCK_SIZE * sizeof(float));
+                surge->process_input = false;
             }
-        }
-        else
-        {
-            surge->process_input = false;
-        }
 
-        if (blockPos == 0)
-        {
             surge->process();
             surge->time_data.ppqPos +=
                 (double)BLOCK_SIZE * surge->time_data.tempo / (60. * surge->storage.samplerate);
@@ -689,49 +705,26 @@ void SurgeSynthProcessor::processBlock(juce::AudioBuffer<float> &buffer,
 
         if (inputIsLatent && incL && incR)
         {
-            inputLatentBuffer[0][blockPos] = incL[i];
-            inputLatentBuffer[1][blockPos] = incR[i];
+            memcpy(&inputLatentBuffer[0][blockPos], incL + i, n * sizeof(float));
+            memcpy(&inputLatentBuffer[1][blockPos], incR + i, n * sizeof(float));
         }
 
-        *outL = surge->output[0][blockPos];
-        *outR = surge->output[1][blockPos];
+        copyStereo(mainOutput, i, &surge->output[0][blockPos], &surge->output[1][blockPos], n);
 
         if (surge->activateExtraOutputs)
         {
-            if (sceneAOutput.getNumChannels() == 2)
-            {
-                auto sAL = sceneAOutput.getWritePointer(0, i);
-                auto sAR = sceneAOutput.getWritePointer(1, i);
-
-                if (sAL && sAR)
-                {
-                    *sAL = surge->sceneout[0][0][blockPos];
-                    *sAR = surge->sceneout[0][1][blockPos];
-                }
-            }
-
-            if (sceneBOutput.getNumChannels() == 2)
-            {
-                auto sBL = sceneBOutput.getWritePointer(0, i);
-                auto sBR = sceneBOutput.getWritePointer(1, i);
-
-                if (sBL && sBR)
-                {
-                    *sBL = surge->sceneout[1][0][blockPos];
-                    *sBR = surge->sceneout[1][1][blockPos];
-                }
-            }
+            copyStereo(sceneAOutput, i, &surge->sceneout[0][0][blockPos],
+                       &surge->sceneout[0][1][blockPos], n);
+            copyStereo(sceneBOutput, i, &surge->sceneout[1][0][blockPos],
+                       &surge->sceneout[1][1][blockPos], n);
         }
 
-        blockPos = (blockPos + 1) & (BLOCK_SIZE - 1);
+        blockPos = (blockPos + n) & (BLOCK_SIZE - 1);
+        i += n;
     }
 
-    // This should, in theory, never happen, but better safe than sorry
-    while (midiIt != midiMessages.cend())
-    {
-        applyMidi(*midiIt);
-        midiIt++;
-    }
+    // Events past the last chunk start belong to the next block, which the next call runs
+    applyMidiThrough(std::numeric_limits<int>::max());
 
     processBlockPostFunction();
 }
@@ -1073,6 +1066,8 @@ clap_process_status SurgeSynthProcessor::clap_direct_process(const clap_process
         surge->stopSound();
     }
     surge->audio_processing_active = true;
+    surge->storage.buildWavetablesInBackground = !isNonRealtime();
+    surge->spawnEffectsInBackground = !isNonRealtime();
 
     processBlockPlayhead();
     processBlockMidiFromGUI();
@@ -27,12 +27,15 @@
 #include <juce_gui_extra/juce_gui_extra.h>
 #endif
 
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <CLI11/CLI11.hpp>
 
 #include "version.h"
 
 #include "SurgeSynthProcessor.h"
+#include "SurgeMemoryPools.h"
 
 #if JUCE_MAC
 namespace juce
@@ -236,6 +239,45 @@ struct SurgePlayback : juce::MidiInputCallback, juce::AudioIODeviceCallback
     }
 };
 
+#if SURGE_STAGE_PROFILER
+void printStageProfile(const Surge::Profiling::StageProfiler &profiler)
+{
+    PRINT("Stage profile (microseconds per block)");
+    PRINT("  stage                   blocks      mean      p50      p99      max");
+
+    for (int i = 0; i < Surge::Profiling::n_profile_stages; ++i)
+    {
+        auto st = (Surge::Profiling::Stage)i;
+        auto ss = profiler.snapshot(st);
+
+        if (ss.count == 0)
+            continue;
+
+        std::ostringstream oss;
+        oss << "  " << std::left << std::setw(20) << Surge::Profiling::stageName(st) << std::right
+            << std::setw(10) << ss.count << std::fixed << std::setprecision(2) << std::setw(10)
+            << ss.meanNs() / 1000.0 << std::setw(9) << ss.percentileNs(0.5) / 1000.0
+            << std::setw(9) << ss.percentileNs(0.99) / 1000.0 << std::setw(9)
+            << ss.maxNs / 1000.0;
+        PRINT(oss.str());
+    }
+}
+#endif
+
+void printPoolStats(const Surge::Memory::SurgeMemoryPools &pools)
+{
+    PRINT("Oscillator memory pools");
+    PRINT("  pool                             misses     built");
+
+    for (const auto &ps : pools.getPoolStats())
+    {
+        std::ostringstream oss;
+        oss << "  " << std::left << std::setw(30) << ps.name << std::right << std::setw(10)
+            << ps.misses << std::setw(10) << ps.built;
+        PRINT(oss.str());
+    }
+}
+
 void isQuitPressed()
 {
     std::string res;
@@ -324,8 +366,26 @@ int main(int argc, char **argv)
     app.add_flag("--mpe-pitch-bend-range", mpeBendRange,
                  "MPE Pitch Bend Range in semitones; 0 for default");
 
+    bool printProfile{false};
+    app.add_flag("--print-stage-profile", printProfile,
+                 "Print per-stage engine timings on shutdown. Needs a build with "
+                 "SURGE_BUILD_STAGE_PROFILER=ON.");
+
+    bool printPools{false};
+    app.add_flag("--print-pool-stats", printPools,
+                 "Print, on shutdown, how often each oscillator memory pool ran dry and how much "
+                 "its background refill built.");
+
     CLI11_PARSE(app, argc, argv);
 
+#if !SURGE_STAGE_PROFILER
+    if (printProfile)
+    {
+        PRINT("Stage profile is unavailable; rebuild with SURGE_BUILD_STAGE_PROFILER=ON.");
+        printProfile = false;
+    }
+#endif
+
     if (listDevices)
     {
         listAudioDevices();
@@ -706,6 +766,18 @@ int main(int argc, char **argv)
         inp->stop();
     }
 
+#if SURGE_STAGE_PROFILER
+    if (printProfile)
+    {
+        printStageProfile(engine->proc->surge->stageProfiler);
+    }
+#endif
+
+    if (printPools)
+    {
+        printPoolStats(*engine->proc->surge->storage.memoryPools);
+    }
+
     device.reset();
     manager.reset();
     juce::MessageManager::deleteInstance();
@@ -33,6 +33,7 @@
 #include "AccessibleHelpers.h"
 #include "DebugHelpers.h"
 #include "ModulatorPresetManager.h"
+#include "SharedStorage.h"
 
 #include "fmt/core.h"
 
@@ -1663,6 +1664,10 @@ juce::PopupMenu SurgeGUIEditor::makeDataMenu(const juce::Point<int> &where)
     dataSubMenu.addSeparator();
 
     dataSubMenu.addItem(Surge::GUI::toOSCase("Rescan All Data Folders"), [this]() {
+        // a full rescan also finds files which were rewritten in place
+        if (this->synth->storage.scanCache)
+            this->synth->storage.scanCache->clear();
+
         this->synth->storage.refresh_wtlist();
         this->synth->storage.refresh_patchlist();
         this->scannedForMidiPresets = false;
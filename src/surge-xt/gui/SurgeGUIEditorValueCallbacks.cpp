@@ -30,6 +30,7 @@
 
 #include "ModernOscillator.h"
 #include "StringOscillator.h"
+#include "SurgeMemoryPools.h"
 
 #include "widgets/EffectChooser.h"
 #include "widgets/LFOAndStepDisplay.h"
@@ -661,6 +662,28 @@ int32_t SurgeGUIEditor::controlModifierClicked(Surge::GUI::IComponentTagValue *c
                                         &(synth->storage), Surge::Storage::ShowCPUUsage, !cpumeter);
                                     frame->repaint();
                                 });
+
+            bool parallelScenes = synth->getRenderScenesInParallel();
+
+            contextMenu.addItem(Surge::GUI::toOSCase("Render Scenes in Parallel"), true,
+                                parallelScenes, [this, parallelScenes]() {
+                                    Surge::Storage::updateUserDefaultValue(
+                                        &(synth->storage), Surge::Storage::RenderScenesInParallel,
+                                        !parallelScenes);
+                                    synth->setRenderScenesInParallel(!parallelScenes);
+                                });
+
+            bool neverAllocate = Surge::Storage::getUserDefaultValue(
+                &(synth->storage), Surge::Storage::NeverAllocateOnAudioThread, false);
+
+            contextMenu.addItem(Surge::GUI::toOSCase("Silence Voices Rather Than Allocate Memory"),
+                                true, neverAllocate, [this, neverAllocate]() {
+                                    Surge::Storage::updateUserDefaultValue(
+                                        &(synth->storage),
+                                        Surge::Storage::NeverAllocateOnAudioThread,
+                                        !neverAllocate);
+                                    synth->storage.memoryPools->setNeverAllocate(!neverAllocate);
+                                });
         }
 
 #ifdef DEBUG